@@ -0,0 +1,244 @@
+#include <string.h>
+#include <time.h>
+#include "host.h"
+#include "kernel/mm.h"
+#include "kernel/fs.h"
+
+// ============================================================================
+// MICROBENCHMARKS NO HOST (alocador e RamFS)
+// ============================================================================
+// Mesmo formato do 'bench' do shell, mas em nanossegundos reais do host:
+//     BENCH <suite>.<caso> <tamanho> <valor> ns/op
+// Serve para comparar versões do mm.c/fs.c em segundos; a ordem de grandeza
+// no alvo vem do 'make bench' (QEMU). O fs.c daqui é compilado com um disco
+// maior (BENCH_FS_FLAGS no Makefile) para caberem BENCH_FILES arquivos.
+
+#define OPS 100000
+#define BENCH_FILES 1000
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void line(const char *name, uint32_t size, double ns_per_op) {
+    printf("BENCH %s %u %.2f ns/op\n", name, size, ns_per_op);
+}
+
+static void bench_kmalloc(void) {
+    const uint32_t sizes[] = { 16, 256, 2048 };
+    for (unsigned s = 0; s < 3; s++) {
+        host_heap_reset();
+        double t0 = now_ns();
+        for (int i = 0; i < OPS; i++) kfree(kmalloc(sizes[s]));
+        line("host.kmalloc.pair", sizes[s], (now_ns() - t0) / OPS);
+    }
+
+    // Heap com 200 blocos vivos e buracos: o first-fit percorre a lista
+    host_heap_reset();
+    void *live[200];
+    for (int i = 0; i < 200; i++) live[i] = kmalloc(64 + (i % 5) * 16);
+    for (int i = 0; i < 200; i += 2) kfree(live[i]);
+    double t0 = now_ns();
+    for (int i = 0; i < OPS / 10; i++) kfree(kmalloc(256));
+    line("host.kmalloc.frag", 256, (now_ns() - t0) / (OPS / 10));
+
+    t0 = now_ns();
+    for (int i = 0; i < OPS / 10; i++) kheap_defrag();
+    line("host.kheap_defrag", 200, (now_ns() - t0) / (OPS / 10));
+}
+
+static void bench_fs(void) {
+    static uint8_t buf[1536];
+    host_heap_reset();
+    fs_init();
+
+    double t0 = now_ns();
+    for (int i = 0; i < OPS / 10; i++) { fs_create("bench"); fs_delete("bench"); }
+    line("host.fs.create_delete", 0, (now_ns() - t0) / (OPS / 10));
+
+    fs_create("bench");
+    const uint32_t sizes[] = { 64, 256, sizeof(buf) };
+    for (unsigned s = 0; s < 3; s++) {
+        t0 = now_ns();
+        for (int i = 0; i < OPS / 10; i++) fs_write("bench", buf, sizes[s]);
+        line("host.fs.write", sizes[s], (now_ns() - t0) / (OPS / 10));
+
+        // Mesma escrita no lugar pelo descritor (sem cópia na escrita)
+        int fd = fs_open("bench", FS_O_WRITE);
+        t0 = now_ns();
+        for (int i = 0; i < OPS / 10; i++) { fs_lseek(fd, 0, FS_SEEK_SET); fs_fwrite(fd, buf, sizes[s]); }
+        line("host.fs.write_inplace", sizes[s], (now_ns() - t0) / (OPS / 10));
+        fs_close(fd);
+
+        t0 = now_ns();
+        for (int i = 0; i < OPS / 10; i++) fs_read("bench", buf, sizes[s]);
+        line("host.fs.read", sizes[s], (now_ns() - t0) / (OPS / 10));
+    }
+
+    // Anexar 16 bytes a um arquivo de 16KB: pelo descritor (só o fim) vs.
+    // reescrever o arquivo inteiro com fs_write
+    static uint8_t file[16 * 1024 + 16];
+    double t_fd = 0, t_rw = 0;
+    for (int i = 0; i < OPS / 10; i++) {
+        fs_write("bench", file, 16 * 1024);
+        t0 = now_ns();
+        int fd = fs_open("bench", FS_O_WRITE | FS_O_APPEND);
+        fs_fwrite(fd, file, 16);
+        fs_close(fd);
+        t_fd += now_ns() - t0;
+
+        t0 = now_ns();
+        fs_write("bench", file, sizeof(file));
+        t_rw += now_ns() - t0;
+    }
+    line("host.fs.append_fd", 16, t_fd / (OPS / 10));
+    line("host.fs.append_rewrite", 16, t_rw / (OPS / 10));
+    fs_delete("bench");
+
+    // 16KB: copiar para um buffer (fs_read) vs. mapear no lugar (fs_map)
+    static uint8_t copy[16 * 1024];
+    fs_create("bench");
+    fs_write("bench", file, sizeof(copy));
+    t0 = now_ns();
+    for (int i = 0; i < OPS / 10; i++) fs_read("bench", copy, sizeof(copy));
+    line("host.fs.read_copy", sizeof(copy), (now_ns() - t0) / (OPS / 10));
+
+    const uint8_t *map;
+    uint32_t map_len;
+    t0 = now_ns();
+    for (int i = 0; i < OPS / 10; i++) { fs_map("bench", &map, &map_len); fs_unmap(map); }
+    line("host.fs.map", sizeof(copy), (now_ns() - t0) / (OPS / 10));
+    fs_delete("bench");
+
+    // Leitura sequencial de arquivos de vários blocos em pedaços de 4KB
+    // (cada pedaço de um extent contíguo é uma cópia só)
+    static uint8_t big[128 * 1024];
+    const uint32_t seq[] = { 16 * 1024, 64 * 1024, sizeof(big) };
+    for (unsigned s = 0; s < 3; s++) {
+        fs_create("seq");
+        fs_write("seq", big, seq[s]);
+        t0 = now_ns();
+        for (int i = 0; i < OPS / 100; i++) {
+            int fd = fs_open("seq", FS_O_READ);
+            while (fs_fread(fd, big, 4096) > 0) {}
+            fs_close(fd);
+        }
+        line("host.fs.read_seq", seq[s], (now_ns() - t0) / (OPS / 100));
+        fs_delete("seq");
+    }
+
+    // Abrir por nome com 1000 arquivos no Root (fs_read de 0 bytes = só o lookup)
+    char names[BENCH_FILES][8];
+    for (int i = 0; i < BENCH_FILES; i++) {
+        snprintf(names[i], sizeof(names[i]), "f%04d", i);
+        if (fs_create(names[i]) != 0) { printf("bench_host: fs_create(%s) falhou\n", names[i]); exit(1); }
+    }
+    t0 = now_ns();
+    for (int i = 0; i < OPS; i++) fs_read(names[(i * 7) % BENCH_FILES], buf, 0);
+    line("host.fs.open", BENCH_FILES, (now_ns() - t0) / OPS);
+    for (int i = 0; i < BENCH_FILES; i++) fs_delete(names[i]);
+
+    // Diretório grande: os mesmos 1000 arquivos dentro de "big"
+    char paths[BENCH_FILES][16];
+    fs_mkdir("big");
+    t0 = now_ns();
+    for (int i = 0; i < BENCH_FILES; i++) {
+        snprintf(paths[i], sizeof(paths[i]), "big/f%04d", i);
+        if (fs_create(paths[i]) != 0) { printf("bench_host: fs_create(%s) falhou\n", paths[i]); exit(1); }
+    }
+    line("host.fs.create_bigdir", BENCH_FILES, (now_ns() - t0) / BENCH_FILES);
+    t0 = now_ns();
+    for (int i = 0; i < OPS; i++) fs_read(paths[(i * 7) % BENCH_FILES], buf, 0);
+    line("host.fs.open_bigdir", BENCH_FILES, (now_ns() - t0) / OPS);
+
+    // Listagem inteira em lotes de 16 registros (por entrada)
+    fs_dirent_t ents[16];
+    t0 = now_ns();
+    for (int i = 0; i < OPS / 1000; i++) {
+        int fd = fs_opendir("big");
+        while (fs_readdir(fd, ents, 16) > 0) {}
+        fs_close(fd);
+    }
+    line("host.fs.readdir", BENCH_FILES, (now_ns() - t0) / (OPS / 1000) / BENCH_FILES);
+    for (int i = 0; i < BENCH_FILES; i++) fs_delete(paths[i]);
+    fs_rmdir("big");
+
+    // Caminhos de 9 componentes: o mesmo caminho (cache de caminhos) vs. 16
+    // arquivos do mesmo diretório em rodízio (mais que FS_PATH_CACHE:
+    // componente a componente)
+    char dir[64] = "d0", deep[16][64];
+    fs_mkdir(dir);
+    for (int d = 1; d < 8; d++) {
+        snprintf(dir + strlen(dir), sizeof(dir) - strlen(dir), "/%d", d);
+        fs_mkdir(dir);
+    }
+    for (int p = 0; p < 16; p++) {
+        snprintf(deep[p], sizeof(deep[p]), "%s/w%d", dir, p);
+        if (fs_create(deep[p]) != 0) { printf("bench_host: fs_create(%s) falhou\n", deep[p]); exit(1); }
+    }
+    t0 = now_ns();
+    for (int i = 0; i < OPS; i++) fs_read(deep[0], buf, 0);
+    line("host.fs.path", 9, (now_ns() - t0) / OPS);
+    t0 = now_ns();
+    for (int i = 0; i < OPS; i++) fs_read(deep[i & 15], buf, 0);
+    line("host.fs.path_walk", 9, (now_ns() - t0) / OPS);
+}
+
+// Mesmo disco atrás do cache de blocos (como o virtio-blk), com o
+// "dispositivo" em memória: mede só o custo do cache, não o da E/S
+static uint8_t dev_disk[1024 * 1024];
+
+static int dev_read(blkdev_t *dev, uint32_t blk, void *buf, uint32_t count) {
+    memcpy(buf, &dev_disk[blk * 512], count * 512);
+    return 0;
+}
+
+static int dev_write(blkdev_t *dev, uint32_t blk, const void *buf, uint32_t count) {
+    memcpy(&dev_disk[blk * 512], buf, count * 512);
+    return 0;
+}
+
+static void bench_fs_cached(void) {
+    static blkdev_t dev = { "bench", 512, sizeof(dev_disk) / 512, NULL, dev_read, dev_write, NULL, NULL };
+    static uint8_t big[128 * 1024];
+    host_heap_reset();
+    fs_init();
+    if (fs_format_dev(&dev) != 0) { printf("bench_host: fs_format_dev falhou\n"); exit(1); }
+
+    // 16KB cabe no cache (só acertos); 128KB não cabe (LRU sequencial: só faltas)
+    const uint32_t sizes[] = { 16 * 1024, sizeof(big) };
+    for (unsigned s = 0; s < 2; s++) {
+        fs_create("bench");
+        fs_write("bench", big, sizes[s]);
+        double t0 = now_ns();
+        for (int i = 0; i < OPS / 100; i++) fs_read("bench", big, sizes[s]);
+        line("host.fs.read_cached", sizes[s], (now_ns() - t0) / (OPS / 100));
+        fs_delete("bench");
+    }
+
+    // Escrita de 16KB + sync (grava os blocos sujos e os metadados)
+    fs_create("bench");
+    double t0 = now_ns();
+    for (int i = 0; i < OPS / 100; i++) { fs_write("bench", big, 16 * 1024); fs_sync(); }
+    line("host.fs.write_sync", 16 * 1024, (now_ns() - t0) / (OPS / 100));
+
+    // Sem sync: um commit de metadados a cada FS_COMMIT_BATCH escritas
+    t0 = now_ns();
+    for (int i = 0; i < OPS / 100; i++) fs_write("bench", big, 16 * 1024);
+    line("host.fs.write_batch", 16 * 1024, (now_ns() - t0) / (OPS / 100));
+
+    int fd = fs_open("bench", FS_O_WRITE);
+    t0 = now_ns();
+    for (int i = 0; i < OPS / 100; i++) { fs_lseek(fd, 0, FS_SEEK_SET); fs_fwrite(fd, big, 16 * 1024); }
+    line("host.fs.write_inplace_cached", 16 * 1024, (now_ns() - t0) / (OPS / 100));
+    fs_close(fd);
+}
+
+int main(void) {
+    bench_kmalloc();
+    bench_fs();
+    bench_fs_cached();
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include <string.h>
+#include "host.h"
+#include "kernel/fs.h"
+
+// ============================================================================
+// FUZZ: OPERAÇÕES NA RAMFS
+// ============================================================================
+// A entrada é uma sequência de comandos [op] [arquivo] [tamanho]. Um modelo
+// (cópia em memória do conteúdo de cada arquivo) acompanha o que cada
+// arquivo deveria conter; toda leitura é comparada com o modelo. Metade dos
+// arquivos fica no subdiretório "d" (mesmos nomes, outro pai no índice).
+
+#define FILES    40     // Mais que os 31 inodes livres: exercita o "cheio"
+#define MAX_FILE (24 * FS_BLOCK_SIZE) // 40 desses não cabem: fragmenta e enche o disco
+
+typedef struct { int exists; uint32_t size; uint8_t bytes[MAX_FILE]; } model_t;
+
+static void pattern(uint8_t *buf, uint32_t n, uint8_t seed) {
+    for (uint32_t i = 0; i < n; i++) buf[i] = (uint8_t)(seed + i * 31);
+}
+
+// f0..f19 no Root, f20..f39 em "d"
+static void file_name(char *name, int f) {
+    int i = 0;
+    if (f >= FILES / 2) { name[i++] = 'd'; name[i++] = '/'; }
+    name[i++] = 'f'; name[i++] = '0' + f; name[i] = 0;
+}
+
+// Disco atrás do cache de blocos (como o virtio-blk): o mesmo modelo vale
+static uint8_t dev_disk[64 * 1024];
+
+static int dev_read(blkdev_t *dev, uint32_t blk, void *buf, uint32_t count) {
+    if (blk + count > dev->block_count) abort();
+    memcpy(buf, &dev_disk[blk * 512], count * 512);
+    return 0;
+}
+
+static int dev_write(blkdev_t *dev, uint32_t blk, const void *buf, uint32_t count) {
+    if (blk + count > dev->block_count) abort();
+    memcpy(&dev_disk[blk * 512], buf, count * 512);
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t len) {
+    static uint8_t wbuf[MAX_FILE + 64], rbuf[MAX_FILE + 64];
+    static model_t model[FILES];
+    static blkdev_t dev = { "fuzz", 512, sizeof(dev_disk) / 512, NULL, dev_read, dev_write, NULL, NULL };
+    char name[8];
+
+    memset(model, 0, sizeof(model));
+    host_heap_reset();
+    fs_init();
+
+    // Tamanho ímpar = disco com cache; no fim, remonta e confere tudo
+    int cached = len & 1;
+    if (cached && fs_format_dev(&dev) != 0) abort();
+    if (fs_mkdir("d") != 0) abort();
+
+    for (size_t off = 0; off + 3 <= len; off += 3) {
+        uint8_t  op   = data[off] & 7;
+        int      f    = data[off + 1] % FILES;
+        uint32_t size = (data[off + 2] * 29u) % (MAX_FILE + 1);
+        model_t *m    = &model[f];
+
+        file_name(name, f);
+
+        switch (op) {
+            case 0: { // create
+                int r = fs_create(name);
+                if (m->exists && r == 0) abort();
+                if (r == 0) { m->exists = 1; m->size = 0; }
+                break;
+            }
+            case 1: { // write (substitui tudo)
+                pattern(wbuf, size, data[off + 2]);
+                int r = fs_write(name, wbuf, size);
+                if (!m->exists) { if (r != -1) abort(); break; }
+                if (r == -4) break;     // Disco cheio: conteúdo antigo intacto
+                if (r != (int)size) abort();
+                m->size = size;
+                memcpy(m->bytes, wbuf, size);
+                break;
+            }
+            case 2: { // read
+                int r = fs_read(name, rbuf, sizeof(rbuf));
+                if (!m->exists) { if (r != -1) abort(); break; }
+                if (r != (int)m->size) abort();
+                if (memcmp(m->bytes, rbuf, m->size) != 0) abort();
+                break;
+            }
+            case 3: { // delete
+                int r = fs_delete(name);
+                if ((r == 0) != m->exists) abort();
+                m->exists = 0;
+                break;
+            }
+            case 4: { // readdir (em lotes) bate com o modelo + rmdir de "d"
+                fs_dirent_t ents[FILES];
+                int lo = (data[off + 2] & 1) ? FILES / 2 : 0;
+                int fd = fs_opendir(lo ? "d" : NULL), total = 0, n, busy = 0;
+                if (fd < 0) abort();
+                while ((n = fs_readdir(fd, &ents[total], 1 + (data[off + 2] & 7))) > 0) total += n;
+                fs_close(fd);
+                for (int i = lo; i < lo + FILES / 2; i++) busy += model[i].exists;
+                if (total != busy + (lo ? 0 : 1)) abort(); // Root também lista o "d"
+                for (int i = 0; i < total; i++) {
+                    if (ents[i].type == FS_TYPE_DIR) continue;
+                    int k = ents[i].name[1] - '0';
+                    if (k < lo || k >= lo + FILES / 2 || !model[k].exists || ents[i].size != model[k].size) abort();
+                }
+                busy = 0;
+                for (int i = FILES / 2; i < FILES; i++) busy |= model[i].exists;
+                int r = fs_rmdir("d");
+                if (r != (busy ? -2 : 0)) abort();
+                if (r == 0 && fs_mkdir("d") != 0) abort();
+                break;
+            }
+            case 5: { // append pelo descritor
+                uint32_t n = size & 127;
+                if (n > MAX_FILE - m->size) n = MAX_FILE - m->size;
+                int fd = fs_open(name, FS_O_WRITE | FS_O_APPEND);
+                if (!m->exists) { if (fd != -1) abort(); break; }
+                if (fd < 0) abort();
+                pattern(wbuf, n, data[off + 1]);
+                int r = fs_fwrite(fd, wbuf, n);
+                if (r > 0) { memcpy(&m->bytes[m->size], wbuf, r); m->size += r; }
+                else if (n > 0 && r != -2) abort();
+                if (fs_close(fd) != 0) abort();
+                break;
+            }
+            case 6: { // sobrescrita parcial + leitura com seek
+                if (!m->exists) break;
+                int fd = fs_open(name, FS_O_READ | FS_O_WRITE);
+                if (fd < 0) abort();
+                uint32_t at = m->size ? data[off + 2] % (m->size + 1) : 0;
+                uint32_t n  = (size & 63);
+                if (n > MAX_FILE - at) n = MAX_FILE - at;
+                if (fs_lseek(fd, (int32_t)at, FS_SEEK_SET) != (int)at) abort();
+                pattern(wbuf, n, data[off]);
+                int r = fs_fwrite(fd, wbuf, n);
+                if (r > 0) {
+                    memcpy(&m->bytes[at], wbuf, r);
+                    if (at + r > m->size) m->size = at + r;
+                }
+                if (fs_lseek(fd, (int32_t)at, FS_SEEK_SET) != (int)at) abort();
+                int got = fs_fread(fd, rbuf, sizeof(rbuf));
+                if (got != (int)(m->size - at) || memcmp(rbuf, &m->bytes[at], got) != 0) abort();
+                if (fs_lseek(fd, 1, FS_SEEK_END) != -1) abort(); // Sem buracos
+                fs_close(fd);
+                break;
+            }
+            case 7: { // map: conteúdo no lugar bate com o modelo
+                const uint8_t *ptr;
+                uint32_t n;
+                int r = fs_map(name, &ptr, &n);
+                if (!m->exists) { if (r != -1) abort(); break; }
+                if (r == -2) break; // Fragmentado e sem trecho livre do tamanho
+                if (r != 0 || n != m->size || (n && memcmp(ptr, m->bytes, n) != 0)) abort();
+                if (fs_delete(name) != (n ? -3 : 0)) abort();
+                if (n == 0) { m->exists = 0; break; }
+                if (fs_unmap(ptr) != 0) abort();
+                break;
+            }
+        }
+    }
+
+    if (cached) {
+        if (fs_sync() != 0) abort();
+        host_heap_reset();
+        fs_init();
+        if (fs_mount_dev(&dev) != 0) abort();
+        for (int f = 0; f < FILES; f++) {
+            file_name(name, f);
+            int r = fs_read(name, rbuf, sizeof(rbuf));
+            if (!model[f].exists) { if (r != -1) abort(); continue; }
+            if (r != (int)model[f].size || memcmp(model[f].bytes, rbuf, r) != 0) abort();
+        }
+    }
+
+    // Contadores do superbloco batem com o modelo
+    fs_statfs_t st;
+    uint32_t live = 0;
+    for (int f = 0; f < FILES; f++) live += model[f].exists;
+    fs_statfs(&st);
+    if (st.free_inodes != FS_MAX_INODES - 2 - live) abort(); // Root e "d"
+    return 0;
+}
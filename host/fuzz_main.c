@@ -0,0 +1,54 @@
+#include <string.h>
+#include "host.h"
+
+// ============================================================================
+// DRIVER DOS FUZZERS SEM LIBFUZZER
+// ============================================================================
+// Com clang, os harnesses são linkados com -fsanitize=fuzzer e este arquivo
+// não entra. Com gcc (ou AFL):
+//   fuzz_mm arquivo...     Reexecuta entradas (corpus, crashes)
+//   fuzz_mm < entrada      Uma entrada pela stdin (modo AFL)
+//   fuzz_mm -runs=N        N entradas aleatórias (smoke test do 'make host-test')
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t len);
+
+#define MAX_INPUT 4096
+
+static uint32_t rng_state = 0x12345678;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+int main(int argc, char **argv) {
+    static uint8_t buf[MAX_INPUT];
+
+    if (argc > 1 && strncmp(argv[1], "-runs=", 6) == 0) {
+        long runs = strtol(argv[1] + 6, NULL, 10);
+        for (long r = 0; r < runs; r++) {
+            size_t len = rng() % MAX_INPUT;
+            for (size_t i = 0; i < len; i++) buf[i] = (uint8_t)rng();
+            LLVMFuzzerTestOneInput(buf, len);
+        }
+        printf("%s: %ld random inputs OK\n", argv[0], runs);
+        return 0;
+    }
+
+    if (argc == 1) {
+        size_t len = fread(buf, 1, sizeof(buf), stdin);
+        LLVMFuzzerTestOneInput(buf, len);
+        return 0;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        FILE *f = fopen(argv[i], "rb");
+        if (!f) { perror(argv[i]); return 1; }
+        size_t len = fread(buf, 1, sizeof(buf), f);
+        fclose(f);
+        LLVMFuzzerTestOneInput(buf, len);
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <string.h>
+#include "host.h"
+#include "kernel/mm.h"
+
+// ============================================================================
+// FUZZ: SEQUÊNCIAS DE KMALLOC/KFREE/KREALLOC
+// ============================================================================
+// Cada 4 bytes da entrada viram uma operação sobre 32 "slots":
+//   [0] op  [1] slot  [2..3] tamanho/alinhamento
+// Cada bloco vivo é preenchido com um padrão do seu slot; qualquer
+// sobreposição entre blocos aparece como padrão corrompido. No fim, tudo é
+// liberado e o defrag precisa devolver o heap inteiro.
+
+#define SLOTS 32
+
+typedef struct { uint8_t *p; uint32_t size; } slot_t;
+
+static void fill(slot_t *s, int idx) {
+    memset(s->p, 0x40 + idx, s->size);
+}
+
+static void verify(const slot_t *s, int idx) {
+    for (uint32_t i = 0; i < s->size; i++) {
+        if (s->p[i] != (uint8_t)(0x40 + idx)) {
+            fprintf(stderr, "fuzz_mm: slot %d corrompido no byte %u\n", idx, i);
+            abort();
+        }
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t len) {
+    slot_t slots[SLOTS] = {{0}};
+
+    host_heap_reset();
+    uint32_t free0 = kget_free_memory();
+
+    for (size_t off = 0; off + 4 <= len; off += 4) {
+        uint8_t  op   = data[off] % 6;
+        int      idx  = data[off + 1] % SLOTS;
+        uint32_t arg  = data[off + 2] | (data[off + 3] << 8);
+        slot_t  *s    = &slots[idx];
+
+        switch (op) {
+            case 0: case 1: { // kmalloc / kmalloc_aligned
+                if (s->p) { verify(s, idx); kfree(s->p); s->p = NULL; }
+                uint32_t size = arg & 0x1FFF;
+                s->p = (op == 0) ? kmalloc(size) : kmalloc_aligned(size, 4u << (arg >> 13));
+                if (s->p && op == 1 && ((uintptr_t)s->p & ((4u << (arg >> 13)) - 1))) abort();
+                s->size = s->p ? size : 0;
+                if (s->p) fill(s, idx);
+                break;
+            }
+            case 2: // kfree
+                if (s->p) { verify(s, idx); if (kfree(s->p) != 0) abort(); s->p = NULL; }
+                break;
+            case 3: { // krealloc (preserva o prefixo)
+                if (!s->p) break;
+                verify(s, idx);
+                uint32_t size = (arg & 0x1FFF) + 1;
+                uint8_t *n = krealloc(s->p, size);
+                if (!n) break; // Original continua válido
+                uint32_t keep = size < s->size ? size : s->size;
+                for (uint32_t i = 0; i < keep; i++) if (n[i] != (uint8_t)(0x40 + idx)) abort();
+                s->p = n; s->size = size;
+                fill(s, idx);
+                break;
+            }
+            case 4: // defrag no meio da sequência
+                kheap_defrag();
+                break;
+            case 5: // Free inválido (não pode quebrar nada)
+                if (s->p && s->size >= 8) kfree(s->p + 4);
+                break;
+        }
+    }
+
+    for (int i = 0; i < SLOTS; i++) {
+        if (slots[i].p) { verify(&slots[i], i); kfree(slots[i].p); }
+    }
+    kheap_defrag();
+    if (kget_free_memory() != free0) {
+        fprintf(stderr, "fuzz_mm: vazamento (%u != %u)\n", kget_free_memory(), free0);
+        abort();
+    }
+    return 0;
+}
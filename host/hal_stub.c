@@ -0,0 +1,80 @@
+#include <string.h>
+#include "host.h"
+#include "hal/hal_uart.h"
+#include "hal/hal_timer.h"
+#include "hal/hal_dma.h"
+#include "kernel/mm.h"
+#include "kernel/klog.h"
+
+// ============================================================================
+// HEAP
+// ============================================================================
+
+uint8_t host_heap[HOST_HEAP_SIZE] __attribute__((aligned(16)));
+int host_failures = 0;
+
+void host_heap_reset(void) {
+    kmalloc_init(host_heap, HOST_HEAP_SIZE);
+}
+
+// ============================================================================
+// UART
+// ============================================================================
+
+static int uart_echo = -1;
+
+void hal_uart_putc(char c) {
+    if (uart_echo < 0) uart_echo = getenv("HOST_UART_ECHO") != NULL;
+    if (uart_echo) putchar(c);
+}
+
+void hal_uart_puts(const char *s) {
+    while (*s) hal_uart_putc(*s++);
+}
+
+// ============================================================================
+// TIMER (relógio virtual, 10MHz como no QEMU)
+// ============================================================================
+
+static uint64_t host_cycles = 0;
+
+void     host_set_cycles(uint64_t cycles) { host_cycles = cycles; }
+uint64_t host_get_cycles(void)            { return host_cycles; }
+
+uint64_t hal_timer_get_cycles(void) { return host_cycles; }
+uint32_t hal_timer_get_freq(void)   { return 10000000; }
+
+// ============================================================================
+// DMA (cópia síncrona)
+// ============================================================================
+
+void hal_dma_start(uint32_t src, uint32_t dst, uint32_t size_words, int fixed_dst) {
+    (void)fixed_dst;
+    memcpy((void *)(uintptr_t)dst, (const void *)(uintptr_t)src, size_words * 4);
+}
+
+void hal_dma_wait(void) {}
+
+void hal_dma_memcpy(uint32_t src, uint32_t dst, uint32_t size_words, int fixed_dst) {
+    hal_dma_start(src, dst, size_words, fixed_dst);
+}
+
+// ============================================================================
+// KLOG (só contagem)
+// ============================================================================
+
+static uint32_t klog_counts[KLOG_ID_COUNT];
+
+void klog_write(uint32_t id_level, uint32_t a, uint32_t b, uint32_t c) {
+    (void)a; (void)b; (void)c;
+    uint32_t id = id_level >> 16;
+    if (id < KLOG_ID_COUNT) klog_counts[id]++;
+}
+
+uint32_t host_klog_count(uint32_t id) {
+    return id < KLOG_ID_COUNT ? klog_counts[id] : 0;
+}
+
+void host_klog_reset(void) {
+    memset(klog_counts, 0, sizeof(klog_counts));
+}
@@ -0,0 +1,64 @@
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ============================================================================
+ * BUILD NATIVO (HOST): HAL FALSO E MINI FRAMEWORK DE TESTE
+ * ============================================================================
+ *
+ * mm.c, fs.c, kmem.c e scheduler.c são compilados com o gcc/clang do host
+ * (sem toolchain RISC-V, sem QEMU). hal_stub.c substitui os drivers:
+ *   - UART  -> descartada (ou stdout com HOST_UART_ECHO=1 no ambiente);
+ *   - Timer -> relógio virtual controlado pelo teste (host_set_cycles);
+ *   - DMA   -> memcpy;
+ *   - KLOG  -> só conta os registros por ID (host_klog_count).
+ *
+ * O kernel guarda ponteiros em uint32_t; por isso os binários são linkados
+ * com -no-pie e o heap é um array estático (.bss abaixo de 4GB em x86_64).
+ */
+
+// Heap do host (mesmo tamanho do alvo: 128KB; o benchmark usa mais)
+#ifndef HOST_HEAP_SIZE
+#define HOST_HEAP_SIZE  (128 * 1024)
+#endif
+extern uint8_t host_heap[HOST_HEAP_SIZE];
+
+// Reinicia o heap (kmalloc_init sobre host_heap)
+void host_heap_reset(void);
+
+// Relógio virtual (hal_timer_get_cycles)
+void     host_set_cycles(uint64_t cycles);
+uint64_t host_get_cycles(void);
+
+// Registros de KLOG por ID desde o último host_klog_reset()
+uint32_t host_klog_count(uint32_t id);
+void     host_klog_reset(void);
+
+// ----------------------------------------------------------------------------
+// Mini framework de teste
+// ----------------------------------------------------------------------------
+
+extern int host_failures;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        host_failures++; \
+    } \
+} while (0)
+
+#define RUN(test) do { \
+    int before_ = host_failures; \
+    test(); \
+    printf("%s %s\n", host_failures == before_ ? "  ok  " : "  FAIL", #test); \
+} while (0)
+
+#define TEST_MAIN_END() do { \
+    printf("%s: %s\n", __FILE__, host_failures ? "FAILED" : "OK"); \
+    return host_failures ? 1 : 0; \
+} while (0)
+
+#endif /* HOST_H */
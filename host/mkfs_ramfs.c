@@ -0,0 +1,131 @@
+#include <dirent.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "host.h"
+#include "kernel/fs.h"
+
+// ============================================================================
+// MKFS: IMAGEM INICIAL DA RAMFS
+// ============================================================================
+//
+//   mkfs_ramfs <diretório> <saída.img>
+//
+// Empacota a árvore de <diretório> (arquivos regulares e subdiretórios)
+// numa imagem com o layout exato de fs.h. Em vez de reimplementar o formato,
+// usa o próprio fs.c: formata um disco no heap do host, cria os diretórios e
+// arquivos com fs_mkdir/fs_create/fs_write e grava o disco inteiro
+// (fs_disk). O kernel linka a imagem na seção .fsimage e a monta no lugar
+// (fs_mount), sem formatar.
+//
+// Compilado com -DFS_FORMAT_FULL: blocos livres zerados, então a mesma
+// entrada gera sempre a mesma imagem. Os limites FS_* precisam ser os mesmos
+// do kernel (o fs_mount recusa uma imagem de outra geometria).
+
+static int name_cmp(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static int files, dirs;
+
+// 'host' = caminho no PC, 'path' = caminho na RamFS
+static int add_file(const char *host, const char *path) {
+    FILE *f = fopen(host, "rb");
+    if (!f) { perror(host); return -1; }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    uint8_t *data = malloc(size ? size : 1);
+    if (!data || fread(data, 1, size, f) != (size_t)size) {
+        fprintf(stderr, "mkfs_ramfs: %s: read error\n", host);
+        fclose(f); free(data);
+        return -1;
+    }
+    fclose(f);
+
+    int res = fs_create(path);
+    if (res == -1) fprintf(stderr, "mkfs_ramfs: %s: already exists\n", path);
+    else if (res == -2) fprintf(stderr, "mkfs_ramfs: %s: no free inodes\n", path);
+    else if (res == -3) fprintf(stderr, "mkfs_ramfs: %s: directory full\n", path);
+    else if (res == -4) fprintf(stderr, "mkfs_ramfs: %s: invalid name (\".\", \"..\" or longer than %d chars)\n", path, FS_MAX_NAME - 1);
+    else if (res == -6) fprintf(stderr, "mkfs_ramfs: %s: parent directory not found\n", path);
+    else if (res < 0) fprintf(stderr, "mkfs_ramfs: %s: create failed (%d)\n", path, res);
+    else {
+        int n = fs_write(path, data, (uint32_t)size);
+        if (n == -2) fprintf(stderr, "mkfs_ramfs: %s: larger than the disk (%ld bytes)\n", path, size);
+        else if (n != size) fprintf(stderr, "mkfs_ramfs: %s: disk full (%ld bytes)\n", path, size);
+        if (n != size) res = -1;
+    }
+    free(data);
+    files++;
+    return res < 0 ? -1 : 0;
+}
+
+// Ordem alfabética em cada nível: a imagem não depende da ordem do readdir
+static int add_dir(const char *host, const char *path) {
+    DIR *d = opendir(host);
+    if (!d) { perror(host); return -1; }
+
+    char *names[FS_MAX_INODES];
+    int count = 0;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL) {
+        if (e->d_name[0] == '.') continue; // ".", ".." e ocultos
+        if (count == FS_MAX_INODES - 1) {
+            fprintf(stderr, "mkfs_ramfs: %s: more than %d entries\n", host, FS_MAX_INODES - 1);
+            closedir(d);
+            return -1;
+        }
+        names[count++] = strdup(e->d_name);
+    }
+    closedir(d);
+    qsort(names, count, sizeof(names[0]), name_cmp);
+
+    int res = 0;
+    for (int i = 0; i < count && res == 0; i++) {
+        char host_path[4096], fs_path[1024];
+        struct stat st;
+        snprintf(host_path, sizeof(host_path), "%s/%s", host, names[i]);
+        snprintf(fs_path, sizeof(fs_path), "%s/%s", path, names[i]);
+        if (stat(host_path, &st) != 0) continue;
+
+        if (S_ISDIR(st.st_mode)) {
+            if (fs_mkdir(fs_path) != 0) {
+                fprintf(stderr, "mkfs_ramfs: %s: cannot create directory\n", fs_path);
+                res = -1;
+            } else {
+                dirs++;
+                res = add_dir(host_path, fs_path);
+            }
+        } else if (S_ISREG(st.st_mode)) {
+            res = add_file(host_path, fs_path);
+        }
+    }
+    for (int i = 0; i < count; i++) free(names[i]);
+    return res;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <dir> <out.img>\n", argv[0]);
+        return 2;
+    }
+
+    host_heap_reset();
+    fs_init();
+    if (add_dir(argv[1], "") != 0) return 1;
+
+    uint32_t size;
+    const uint8_t *disk = fs_disk(&size);
+    FILE *out = fopen(argv[2], "wb");
+    if (!out || fwrite(disk, 1, size, out) != size || fclose(out) != 0) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    fs_statfs_t st;
+    fs_statfs(&st);
+    printf("mkfs_ramfs: %d files, %d dirs, %u/%u blocks, %u bytes -> %s\n", files, dirs,
+           st.total_blocks - st.free_blocks, st.total_blocks, size, argv[2]);
+    return 0;
+}
@@ -0,0 +1,1103 @@
+#include <string.h>
+#include "host.h"
+#include "kernel/fs.h"
+#include "kernel/mm.h"
+
+// ============================================================================
+// TESTES: RAMFS (fs.c)
+// ============================================================================
+
+#define FS_MAX_FILE (24 * FS_BLOCK_SIZE)          // Arquivo "grande" dos testes (6KB)
+#define FS_DISK     (FS_MAX_BLOCKS * FS_BLOCK_SIZE)
+
+static void fs_fresh(void) {
+    host_heap_reset();
+    fs_init();
+}
+
+static void test_create_and_duplicate(void) {
+    fs_fresh();
+    CHECK(fs_create("a.txt") == 0);
+    CHECK(fs_create("a.txt") == -1);
+    CHECK(fs_create("b.txt") == 0);
+    CHECK(fs_delete("a.txt") == 0);
+    CHECK(fs_delete("a.txt") == -1);
+    CHECK(fs_create("a.txt") == 0);
+}
+
+static void test_name_length(void) {
+    char name[FS_MAX_NAME + 8];
+    fs_fresh();
+    CHECK(fs_create("") == -4);
+
+    // FS_MAX_NAME-1 caracteres cabem (com o terminador); FS_MAX_NAME não
+    memset(name, 'x', sizeof(name));
+    name[FS_MAX_NAME - 1] = 0;
+    CHECK(fs_create(name) == 0);
+    CHECK(fs_create(name) == -1);
+    name[FS_MAX_NAME - 1] = 'x';
+    name[FS_MAX_NAME] = 0;
+    CHECK(fs_create(name) == -4);
+}
+
+static void test_write_read_roundtrip(void) {
+    static uint8_t data[FS_MAX_FILE], back[FS_MAX_FILE];
+    fs_fresh();
+    for (int i = 0; i < FS_MAX_FILE; i++) data[i] = (uint8_t)(i * 13 + 7);
+
+    CHECK(fs_create("f") == 0);
+    const uint32_t sizes[] = { 0, 1, 3, 255, 256, 257, 1000, 1536, 1537, 4000, FS_MAX_FILE };
+    for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        memset(back, 0, sizeof(back));
+        CHECK(fs_write("f", data, sizes[s]) == (int)sizes[s]);
+        CHECK(fs_read("f", back, sizeof(back)) == (int)sizes[s]);
+        CHECK(memcmp(data, back, sizes[s]) == 0);
+    }
+
+    // Leitura limitada pelo buffer
+    CHECK(fs_read("f", back, 10) == 10);
+    CHECK(fs_write("f", data, FS_DISK + 1) == -2);
+    CHECK(fs_write("missing", data, 4) == -1);
+    CHECK(fs_read("missing", back, 4) == -1);
+}
+
+// Registro de 'name' em 'path' (lido em lotes de 3), ou NULL
+static const fs_dirent_t *dir_find(const char *path, const char *name) {
+    static fs_dirent_t ents[FS_MAX_INODES];
+    int fd = fs_opendir(path), total = 0, n;
+    if (fd < 0) return NULL;
+    while ((n = fs_readdir(fd, &ents[total], 3)) > 0) total += n;
+    fs_close(fd);
+    for (int i = 0; i < total; i++) if (strcmp(ents[i].name, name) == 0) return &ents[i];
+    return NULL;
+}
+
+static void test_list(void) {
+    fs_dirent_t ents[FS_MAX_INODES];
+    uint8_t data[600];
+    char name[8];
+    fs_fresh();
+    CHECK(fs_create("one") == 0);
+    CHECK(fs_create("two") == 0);
+    CHECK(fs_write("two", data, sizeof(data)) == (int)sizeof(data));
+    CHECK(fs_mkdir("dir") == 0);
+
+    // Metadados vêm no registro
+    const fs_dirent_t *e = dir_find(NULL, "two");
+    CHECK(e && e->type == FS_TYPE_FILE && e->size == sizeof(data));
+    CHECK(e->blocks == (sizeof(data) + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE);
+    e = dir_find("/", "dir");
+    CHECK(e && e->type == FS_TYPE_DIR && e->size == 0);
+    CHECK(dir_find(NULL, "three") == NULL);
+
+    // Diretório com vários blocos, lido de 1 em 1, com remoções no meio:
+    // quem fica aparece uma vez só
+    for (int i = 0; i < 20; i++) {
+        snprintf(name, sizeof(name), "dir/%c", 'a' + i);
+        CHECK(fs_create(name) == 0);
+    }
+    int fd = fs_opendir("dir"), total = 0, n;
+    CHECK(fd >= 0);
+    CHECK(fs_rmdir("dir") == -3); // Aberto
+    CHECK(fs_fread(fd, data, 1) == -1 && fs_fwrite(fd, data, 1) == -1);
+    while ((n = fs_readdir(fd, &ents[total], 1)) > 0) {
+        CHECK(n == 1);
+        if (++total == 5) {
+            CHECK(fs_delete("dir/a") == 0); // Já listado
+            CHECK(fs_delete("dir/t") == 0); // Ainda não
+        }
+    }
+    CHECK(total == 19);
+    for (int i = 0; i < total; i++) {
+        CHECK(ents[i].name[0] != 't');
+        for (int j = 0; j < i; j++) CHECK(strcmp(ents[i].name, ents[j].name) != 0);
+    }
+
+    // Volta ao início (só o offset 0 vale num diretório)
+    CHECK(fs_lseek(fd, 0, FS_SEEK_SET) == 0);
+    CHECK(fs_lseek(fd, 1, FS_SEEK_SET) == -1);
+    CHECK(fs_readdir(fd, ents, FS_MAX_INODES) == 18);
+    CHECK(fs_readdir(fd, ents, FS_MAX_INODES) == 0);
+    CHECK(fs_close(fd) == 0);
+    CHECK(fs_readdir(fd, ents, 1) == -1);
+
+    CHECK(fs_opendir("one") == -1);
+    CHECK(fs_opendir("nope") == -1);
+    CHECK(fs_open("dir", FS_O_READ) == -1);
+}
+
+static void test_blocks_are_recycled(void) {
+    static uint8_t data[FS_MAX_FILE];
+    fs_fresh();
+
+    // Muito mais escrita que o disco: os blocos precisam voltar ao bitmap
+    CHECK(fs_create("x") == 0);
+    for (int i = 0; i < 200; i++) CHECK(fs_write("x", data, FS_MAX_FILE) == FS_MAX_FILE);
+    for (int i = 0; i < 50; i++) {
+        CHECK(fs_create("y") == 0);
+        CHECK(fs_write("y", data, 1000) == 1000);
+        CHECK(fs_delete("y") == 0);
+    }
+}
+
+static void test_directory_grows(void) {
+    char name[8];
+    uint8_t v = 0;
+    fs_fresh();
+    int created = 0;
+    for (int i = 0; i < FS_MAX_INODES; i++) {
+        name[0] = 'f'; name[1] = 'a' + i; name[2] = 0;
+        if (fs_create(name) == 0) created++;
+        else break;
+    }
+    // Root cresce além do primeiro bloco; o limite agora é a tabela de
+    // inodes (o inode 0 é o próprio Root)
+    CHECK(created == FS_MAX_INODES - 1);
+    CHECK(fs_create("overflow") == -2);
+
+    // Todos continuam achados pelo índice, inclusive após remoções no meio
+    for (int i = 0; i < created; i += 3) {
+        name[0] = 'f'; name[1] = 'a' + i; name[2] = 0;
+        CHECK(fs_delete(name) == 0);
+    }
+    for (int i = 0; i < created; i++) {
+        name[0] = 'f'; name[1] = 'a' + i; name[2] = 0;
+        CHECK(fs_read(name, &v, 1) == ((i % 3) ? 0 : -1));
+    }
+    CHECK(fs_create("overflow") == 0);
+}
+
+static void test_subdirs(void) {
+    uint8_t back[16];
+    fs_fresh();
+
+    CHECK(fs_mkdir("models") == 0);
+    CHECK(fs_mkdir("models") == -1);
+    CHECK(fs_create("models") == -1);
+    CHECK(fs_mkdir("/models/net1") == 0);
+    CHECK(fs_mkdir("x/y") == -6);
+    CHECK(fs_mkdir("/") == -4);
+    CHECK(fs_create("models/.") == -4);
+    CHECK(fs_create("models/..") == -4);
+
+    // Mesmo nome em diretórios diferentes são arquivos diferentes
+    CHECK(fs_create("models/net1/w0") == 0);
+    CHECK(fs_create("w0") == 0);
+    CHECK(fs_create("models/w0") == 0);
+    CHECK(fs_write("/models/net1/w0", (const uint8_t *)"deep", 4) == 4);
+    CHECK(fs_write("w0", (const uint8_t *)"root", 4) == 4);
+    CHECK(fs_read("models//net1/w0", back, sizeof(back)) == 4 && memcmp(back, "deep", 4) == 0);
+    CHECK(fs_read("/w0", back, sizeof(back)) == 4 && memcmp(back, "root", 4) == 0);
+    CHECK(fs_read("models/w0", back, sizeof(back)) == 0);
+
+    // Arquivo no meio do caminho / diretório onde se espera arquivo
+    CHECK(fs_create("models/net1/w0/x") == -6);
+    CHECK(fs_read("models", back, sizeof(back)) == -1);
+    CHECK(fs_open("models/net1", FS_O_READ) == -1);
+    CHECK(fs_open("models/net1", FS_O_WRITE | FS_O_CREATE) == -1);
+    CHECK(fs_delete("models") == -2);
+
+    CHECK(dir_find("models", "net1") && dir_find("models", "net1")->type == FS_TYPE_DIR);
+    CHECK(dir_find("models", "w0") != NULL);
+    CHECK(dir_find(NULL, "models") != NULL && dir_find(NULL, "net1") == NULL);
+    CHECK(fs_opendir("models/w0") == -1);
+
+    // rmdir só de diretório vazio; inodes voltam
+    fs_statfs_t st;
+    fs_statfs(&st);
+    CHECK(fs_rmdir("models") == -2);
+    CHECK(fs_rmdir("w0") == -1);
+    CHECK(fs_rmdir("/") == -1);
+    CHECK(fs_delete("models/net1/w0") == 0);
+    CHECK(fs_rmdir("models/net1") == 0);
+    CHECK(fs_delete("models/w0") == 0);
+    CHECK(fs_rmdir("models") == 0);
+    CHECK(fs_read("models/net1/w0", back, sizeof(back)) == -1);
+    fs_statfs_t st2;
+    fs_statfs(&st2);
+    CHECK(st2.free_inodes == st.free_inodes + 4);
+    CHECK(fs_read("w0", back, sizeof(back)) == 4);
+}
+
+static void test_subdir_grows(void) {
+    char name[16];
+    uint8_t v = 0;
+    fs_statfs_t st, st2;
+    fs_fresh();
+    fs_statfs(&st);
+
+    // Subdiretório com mais entradas que um bloco
+    CHECK(fs_mkdir("big") == 0);
+    int created = 0;
+    for (int i = 0; i < FS_MAX_INODES; i++) {
+        snprintf(name, sizeof(name), "big/f%c", 'a' + i);
+        if (fs_create(name) == 0) created++;
+        else break;
+    }
+    CHECK(created == FS_MAX_INODES - 2); // Root e "big"
+    CHECK(created > (int)FS_DIRENTS_PER_BLOCK);
+    CHECK(fs_create("big/overflow") == -2);
+
+    for (int i = 0; i < created; i += 2) {
+        snprintf(name, sizeof(name), "big/f%c", 'a' + i);
+        CHECK(fs_delete(name) == 0);
+    }
+    for (int i = 0; i < created; i++) {
+        snprintf(name, sizeof(name), "/big/f%c", 'a' + i);
+        CHECK(fs_read(name, &v, 1) == ((i & 1) ? 0 : -1));
+    }
+    CHECK(fs_rmdir("big") == -2);
+    for (int i = 1; i < created; i += 2) {
+        snprintf(name, sizeof(name), "big/f%c", 'a' + i);
+        CHECK(fs_delete(name) == 0);
+    }
+
+    // Vazio: sai com os blocos que cresceu
+    CHECK(fs_rmdir("big") == 0);
+    fs_statfs(&st2);
+    CHECK(st2.free_blocks == st.free_blocks && st2.free_inodes == st.free_inodes);
+}
+
+static void test_path_cache(void) {
+    char name[32];
+    uint8_t back[32];
+    fs_fresh();
+    CHECK(fs_mkdir("a") == 0);
+    CHECK(fs_mkdir("a/b") == 0);
+    CHECK(fs_mkdir("a/b/c") == 0);
+
+    // Recriar no mesmo caminho não pode devolver o inode antigo (cache)
+    for (int round = 0; round < 20; round++) {
+        CHECK(fs_create("a/b/c/w") == 0);
+        CHECK(fs_write("a/b/c/w", (const uint8_t *)&round, sizeof(round)) == sizeof(round));
+        for (int i = 0; i < 3; i++) {
+            CHECK(fs_read("a/b/c/w", back, sizeof(back)) == sizeof(round));
+            CHECK(memcmp(back, &round, sizeof(round)) == 0);
+        }
+        CHECK(fs_delete("a/b/c/w") == 0);
+        CHECK(fs_read("a/b/c/w", back, sizeof(back)) == -1);
+    }
+
+    // Remoções movem slots do índice: cada caminho continua achando o seu
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 12; i++) {
+            snprintf(name, sizeof(name), "a/b/%c%d", 'k' + (i & 1), (i + round) % 24);
+            if (fs_create(name) == 0) CHECK(fs_write(name, (const uint8_t *)name, strlen(name)) == (int)strlen(name));
+        }
+        for (int i = 0; i < 24; i += 1 + (round % 3)) {
+            snprintf(name, sizeof(name), "a/b/%c%d", 'k' + (i & 1), i);
+            int r = fs_read(name, back, sizeof(back));
+            if (r < 0) continue;
+            CHECK(r == (int)strlen(name) && memcmp(back, name, r) == 0);
+            if (i & 2) CHECK(fs_delete(name) == 0);
+        }
+    }
+}
+
+static void test_index_churn(void) {
+    char name[8];
+    uint8_t v;
+    fs_fresh();
+    // Muitos ciclos de create/delete com nomes que colidem no índice
+    for (int round = 0; round < 200; round++) {
+        for (int i = 0; i < 20; i++) {
+            name[0] = 'k'; name[1] = '0' + (i + round) % 40; name[2] = 0;
+            if (fs_create(name) == 0) CHECK(fs_write(name, (const uint8_t *)name, 1) == 1);
+        }
+        for (int i = 0; i < 40; i += 2 + (round & 1)) {
+            name[0] = 'k'; name[1] = '0' + i; name[2] = 0;
+            if (fs_read(name, &v, 1) == 1) { CHECK(v == 'k'); CHECK(fs_delete(name) == 0); }
+        }
+    }
+}
+
+static void test_statfs_counters(void) {
+    static uint8_t data[FS_MAX_FILE];
+    fs_statfs_t st;
+    fs_fresh();
+
+    // Formatado: Root ocupa 1 inode e 1 bloco
+    CHECK(fs_statfs(&st) == 0);
+    CHECK(st.block_size == FS_BLOCK_SIZE);
+    CHECK(st.total_inodes == FS_MAX_INODES && st.free_inodes == FS_MAX_INODES - 1);
+    CHECK(st.total_blocks == FS_MAX_BLOCKS && st.free_blocks == FS_MAX_BLOCKS - 1);
+
+    CHECK(fs_create("a") == 0);
+    CHECK(fs_write("a", data, 3 * FS_BLOCK_SIZE - 1) == 3 * FS_BLOCK_SIZE - 1);
+    fs_statfs(&st);
+    CHECK(st.free_inodes == FS_MAX_INODES - 2);
+    CHECK(st.free_blocks == FS_MAX_BLOCKS - 4);
+
+    // Reescrita devolve os blocos antigos antes de alocar
+    CHECK(fs_write("a", data, 10) == 10);
+    fs_statfs(&st);
+    CHECK(st.free_blocks == FS_MAX_BLOCKS - 2);
+
+    CHECK(fs_delete("a") == 0);
+    fs_statfs(&st);
+    CHECK(st.free_inodes == FS_MAX_INODES - 1 && st.free_blocks == FS_MAX_BLOCKS - 1);
+}
+
+static void test_disk_full_to_last_block(void) {
+    static uint8_t data[FS_MAX_FILE], back[FS_MAX_FILE];
+    char name[4] = "d?";
+    fs_statfs_t st;
+    fs_fresh();
+    for (int i = 0; i < FS_MAX_FILE; i++) data[i] = (uint8_t)(i ^ 0x3C);
+
+    // Enche o disco com arquivos de 24 blocos até sobrar menos que isso
+    int files = 0;
+    fs_statfs(&st);
+    while (st.free_blocks >= FS_MAX_FILE / FS_BLOCK_SIZE && files < FS_MAX_INODES - 2) {
+        name[1] = 'a' + files++;
+        CHECK(fs_create(name) == 0);
+        CHECK(fs_write(name, data, FS_MAX_FILE) == FS_MAX_FILE);
+        fs_statfs(&st);
+    }
+
+    // Escrita maior que o espaço: recusada sem gastar nada; a que cabe
+    // exata vai até o último bloco
+    CHECK(fs_create("last") == 0);
+    uint32_t left = st.free_blocks;
+    CHECK(fs_write("last", data, FS_MAX_FILE) == -4);
+    fs_statfs(&st);
+    CHECK(st.free_blocks == left);
+    int r = (int)(left * FS_BLOCK_SIZE);
+    CHECK(fs_write("last", data, r) == r);
+    fs_statfs(&st);
+    CHECK(st.free_blocks == 0);
+
+    // Cópia na escrita: com o disco cheio nem um bloco novo cabe, então
+    // até encolher falha e o conteúdo antigo continua lá
+    CHECK(fs_write("last", back, 1) == -4);
+    CHECK(fs_read("last", back, FS_MAX_FILE) == r);
+    CHECK(memcmp(data, back, r) == 0);
+
+    // Liberar no começo do disco: next-fit dá a volta e acha
+    CHECK(fs_delete("da") == 0);
+    CHECK(fs_create("again") == 0);
+    CHECK(fs_write("again", data, FS_MAX_FILE) == FS_MAX_FILE);
+}
+
+static void test_fd_after_shrink(void) {
+    static uint8_t data[1000];
+    uint8_t back[8];
+    fs_fresh();
+    memset(data, 'x', sizeof(data));
+
+    // Arquivo encolhe pelo nome com o descritor no byte 1000: a escrita
+    // seguinte continua do fim atual, sem buraco de bytes nunca escritos
+    int fd = fs_open("s", FS_O_WRITE | FS_O_CREATE);
+    CHECK(fs_fwrite(fd, data, sizeof(data)) == (int)sizeof(data));
+    CHECK(fs_write("s", (const uint8_t *)"ab", 2) == 2);
+    CHECK(fs_fwrite(fd, (const uint8_t *)"c", 1) == 1);
+    CHECK(fs_read("s", back, sizeof(back)) == 3 && memcmp(back, "abc", 3) == 0);
+    CHECK(fs_close(fd) == 0);
+}
+
+static void test_cow_write(void) {
+    static uint8_t a[4 * FS_BLOCK_SIZE], b[4 * FS_BLOCK_SIZE], back[4 * FS_BLOCK_SIZE];
+    fs_statfs_t st, st2;
+    fs_fresh();
+    memset(a, 'a', sizeof(a));
+    memset(b, 'b', sizeof(b));
+
+    // O conteúdo novo vai para outros blocos; os antigos voltam ao bitmap
+    CHECK(fs_create("c") == 0);
+    CHECK(fs_write("c", a, sizeof(a)) == (int)sizeof(a));
+    fs_statfs(&st);
+    int fd = fs_open("c", FS_O_READ);
+    CHECK(fs_write("c", b, sizeof(b)) == (int)sizeof(b));
+    fs_statfs(&st2);
+    CHECK(st2.free_blocks == st.free_blocks);
+
+    // Descritor aberto antes da troca lê o conteúdo novo (mesmo inode)
+    CHECK(fs_fread(fd, back, sizeof(back)) == (int)sizeof(b));
+    CHECK(memcmp(back, b, sizeof(b)) == 0);
+    CHECK(fs_close(fd) == 0);
+
+    // Encolher e voltar a zero
+    CHECK(fs_write("c", a, 10) == 10);
+    CHECK(fs_read("c", back, sizeof(back)) == 10 && memcmp(back, a, 10) == 0);
+    CHECK(fs_write("c", a, 0) == 0);
+    fs_statfs(&st2);
+    CHECK(st2.free_blocks == st.free_blocks + 4);
+}
+
+static void test_fd_offsets(void) {
+    uint8_t buf[64];
+    fs_fresh();
+
+    CHECK(fs_open("log", FS_O_READ) == -1);
+    int fd = fs_open("log", FS_O_WRITE | FS_O_CREATE);
+    CHECK(fd >= 0);
+    CHECK(fs_fwrite(fd, (const uint8_t *)"hello world", 11) == 11);
+    CHECK(fs_lseek(fd, 6, FS_SEEK_SET) == 6);
+    CHECK(fs_fwrite(fd, (const uint8_t *)"WORLD", 5) == 5);   // Sobrescrita parcial
+    CHECK(fs_fread(fd, buf, 4) == -1);                         // Aberto só para escrita
+    CHECK(fs_close(fd) == 0);
+    CHECK(fs_close(fd) == -1);
+
+    fd = fs_open("log", FS_O_READ);
+    CHECK(fs_fread(fd, buf, 5) == 5 && memcmp(buf, "hello", 5) == 0);
+    CHECK(fs_fread(fd, buf, 64) == 6 && memcmp(buf, " WORLD", 6) == 0);
+    CHECK(fs_fread(fd, buf, 64) == 0);                          // EOF
+    CHECK(fs_lseek(fd, -5, FS_SEEK_END) == 6);
+    CHECK(fs_lseek(fd, -1, FS_SEEK_CUR) == 5);
+    CHECK(fs_lseek(fd, 12, FS_SEEK_SET) == -1);                 // Sem buracos
+    CHECK(fs_lseek(fd, -1, FS_SEEK_SET) == -1);
+    CHECK(fs_fwrite(fd, buf, 1) == -1);                         // Aberto só para leitura
+    fs_close(fd);
+}
+
+static void test_fd_append_no_realloc(void) {
+    static uint8_t back[FS_MAX_FILE];
+    fs_statfs_t st;
+    fs_fresh();
+
+    // 100 linhas de 10 bytes: cada append só toca o último bloco
+    int fd = fs_open("app.log", FS_O_WRITE | FS_O_CREATE | FS_O_APPEND);
+    for (int i = 0; i < 100; i++) {
+        uint8_t line[10];
+        memset(line, '0' + i % 10, 9); line[9] = '\n';
+        CHECK(fs_fwrite(fd, line, 10) == 10);
+        fs_statfs(&st);
+        CHECK(st.free_blocks == FS_MAX_BLOCKS - 1 - (uint32_t)((i * 10 + 10 + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE));
+    }
+    // Append ignora o lseek
+    CHECK(fs_lseek(fd, 0, FS_SEEK_SET) == 0);
+    CHECK(fs_fwrite(fd, (const uint8_t *)"END", 3) == 3);
+    fs_close(fd);
+
+    CHECK(fs_read("app.log", back, sizeof(back)) == 1003);
+    CHECK(back[0] == '0' && back[990] == '9' && back[999] == '\n');
+    CHECK(memcmp(&back[1000], "END", 3) == 0);
+
+    // Cheio: o append ocupa o resto do último bloco e todo o disco livre
+    static uint8_t big[FS_DISK];
+    fs_statfs(&st);
+    fd = fs_open("app.log", FS_O_WRITE | FS_O_APPEND);
+    CHECK(fs_fwrite(fd, big, sizeof(big)) == (int)(st.free_blocks * FS_BLOCK_SIZE + (1024 - 1003)));
+    CHECK(fs_fwrite(fd, big, 1) == -2);
+    fs_close(fd);
+}
+
+static void test_fd_trunc_and_limits(void) {
+    uint8_t buf[8];
+    fs_statfs_t st;
+    fs_fresh();
+
+    CHECK(fs_create("t") == 0);
+    CHECK(fs_write("t", (const uint8_t *)"0123456789", 10) == 10);
+    int fd = fs_open("t", FS_O_WRITE | FS_O_TRUNC);
+    fs_statfs(&st);
+    CHECK(st.free_blocks == FS_MAX_BLOCKS - 1);                 // Truncar devolve blocos
+    CHECK(fs_delete("t") == -3);                                // Aberto
+    fs_close(fd);
+    CHECK(fs_read("t", buf, 8) == 0);
+    CHECK(fs_delete("t") == 0);
+
+    // Tabela de descritores cheia
+    int fds[FS_MAX_FD];
+    for (int i = 0; i < FS_MAX_FD; i++) CHECK((fds[i] = fs_open("x", FS_O_READ | FS_O_CREATE)) >= 0);
+    CHECK(fs_open("x", FS_O_READ) == -5);
+    for (int i = 0; i < FS_MAX_FD; i++) CHECK(fs_close(fds[i]) == 0);
+
+    // fs_write grande demais não mexe no arquivo
+    static uint8_t huge[FS_DISK + 1];
+    CHECK(fs_write("x", (const uint8_t *)"keep", 4) == 4);
+    CHECK(fs_write("x", huge, sizeof(huge)) == -2);
+    CHECK(fs_read("x", buf, 8) == 4 && memcmp(buf, "keep", 4) == 0);
+
+    // Format fecha tudo
+    fd = fs_open("x", FS_O_READ);
+    fs_format();
+    CHECK(fs_fread(fd, buf, 1) == -1);
+}
+
+static void test_large_file_one_extent(void) {
+    static uint8_t data[16 * 1024], back[16 * 1024];
+    fs_statfs_t st;
+    fs_fresh();
+    for (uint32_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 7 + (i >> 8));
+
+    // Disco vazio: 64 blocos contíguos, sem bloco indireto
+    CHECK(fs_create("w.bin") == 0);
+    CHECK(fs_write("w.bin", data, sizeof(data)) == (int)sizeof(data));
+    fs_statfs(&st);
+    CHECK(st.free_blocks == FS_MAX_BLOCKS - 1 - 64);
+    CHECK(fs_read("w.bin", back, sizeof(back)) == (int)sizeof(back));
+    CHECK(memcmp(data, back, sizeof(data)) == 0);
+
+    // Leitura no meio, atravessando blocos
+    int fd = fs_open("w.bin", FS_O_READ);
+    CHECK(fs_lseek(fd, 1000, FS_SEEK_SET) == 1000);
+    CHECK(fs_fread(fd, back, 5000) == 5000);
+    CHECK(memcmp(&data[1000], back, 5000) == 0);
+    fs_close(fd);
+
+    CHECK(fs_delete("w.bin") == 0);
+    fs_statfs(&st);
+    CHECK(st.free_blocks == FS_MAX_BLOCKS - 1);
+}
+
+static void test_fragmented_uses_indirect(void) {
+    static uint8_t data[40 * FS_BLOCK_SIZE], back[40 * FS_BLOCK_SIZE];
+    uint8_t small[4 * FS_BLOCK_SIZE] = {0};
+    char name[4] = "s?";
+    fs_statfs_t st;
+    fs_fresh();
+    for (uint32_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i ^ (i >> 9));
+
+    // 30 arquivos de 4 blocos; apagar os pares deixa buracos de 4 blocos
+    for (int i = 0; i < 30; i++) {
+        name[1] = 'A' + i;
+        CHECK(fs_create(name) == 0);
+        CHECK(fs_write(name, small, sizeof(small)) == (int)sizeof(small));
+    }
+    for (int i = 0; i < 30; i += 2) { name[1] = 'A' + i; CHECK(fs_delete(name) == 0); }
+    fs_statfs(&st);
+    uint32_t free0 = st.free_blocks;
+
+    // 40 blocos não cabem em 3 extents: o resto vai para o bloco indireto
+    CHECK(fs_create("frag") == 0);
+    CHECK(fs_write("frag", data, sizeof(data)) == (int)sizeof(data));
+    fs_statfs(&st);
+    CHECK(st.free_blocks == free0 - 40 - 1);
+    CHECK(fs_read("frag", back, sizeof(back)) == (int)sizeof(back));
+    CHECK(memcmp(data, back, sizeof(data)) == 0);
+
+    // Sobrescrita parcial atravessando extents e indiretos
+    int fd = fs_open("frag", FS_O_READ | FS_O_WRITE);
+    CHECK(fs_lseek(fd, 3 * FS_BLOCK_SIZE + 17, FS_SEEK_SET) > 0);
+    static const uint8_t zeros[30 * FS_BLOCK_SIZE];
+    CHECK(fs_fwrite(fd, zeros, sizeof(zeros)) == (int)sizeof(zeros));
+    fs_close(fd);
+    memset(&data[3 * FS_BLOCK_SIZE + 17], 0, 30 * FS_BLOCK_SIZE);
+    CHECK(fs_read("frag", back, sizeof(back)) == (int)sizeof(back));
+    CHECK(memcmp(data, back, sizeof(data)) == 0);
+
+    // Truncar para dentro dos extents devolve os indiretos e a tabela
+    fd = fs_open("frag", FS_O_WRITE | FS_O_TRUNC);
+    fs_close(fd);
+    fs_statfs(&st);
+    CHECK(st.free_blocks == free0);
+    CHECK(fs_delete("frag") == 0);
+}
+
+static void test_map(void) {
+    static uint8_t data[FS_MAX_FILE];
+    const uint8_t *ptr;
+    uint32_t len;
+    fs_fresh();
+    for (uint32_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 13 + 5);
+
+    CHECK(fs_create("w") == 0);
+    CHECK(fs_write("w", data, sizeof(data)) == (int)sizeof(data));
+
+    // Ponteiro direto para o disco, alinhado para DMA
+    CHECK(fs_map("w", &ptr, &len) == 0);
+    CHECK(len == sizeof(data));
+    CHECK(((uintptr_t)ptr & (KMALLOC_DMA_ALIGN - 1)) == 0);
+    CHECK(memcmp(ptr, data, len) == 0);
+
+    // Mapeado = somente leitura; leitura por descritor continua valendo
+    CHECK(fs_delete("w") == -3);
+    CHECK(fs_write("w", data, 1) == -3);
+    CHECK(fs_open("w", FS_O_WRITE) == -3);
+    int fd = fs_open("w", FS_O_READ);
+    CHECK(fd >= 0);
+    fs_close(fd);
+
+    // Referências contadas: dois maps, dois unmaps
+    const uint8_t *ptr2;
+    CHECK(fs_map("w", &ptr2, &len) == 0 && ptr2 == ptr);
+    CHECK(fs_unmap(ptr) == 0);
+    CHECK(fs_delete("w") == -3);
+    CHECK(fs_unmap(ptr2) == 0);
+    CHECK(fs_unmap(ptr2) == -1);
+    CHECK(fs_delete("w") == 0);
+
+    // Aberto para escrita não pode ser mapeado
+    CHECK(fs_create("o") == 0);
+    fd = fs_open("o", FS_O_WRITE);
+    CHECK(fs_map("o", &ptr, &len) == -3);
+    fs_close(fd);
+
+    // Vazio: nada a mapear
+    CHECK(fs_map("o", &ptr, &len) == 0 && ptr == NULL && len == 0);
+    CHECK(fs_unmap(ptr) == 0);
+    CHECK(fs_map("nope", &ptr, &len) == -1);
+}
+
+static void test_map_fragmented(void) {
+    static uint8_t data[FS_MAX_FILE];
+    uint8_t small[4 * FS_BLOCK_SIZE] = {0};
+    char name[4] = "s?";
+    const uint8_t *ptr;
+    uint32_t len;
+    fs_statfs_t st;
+    fs_fresh();
+    for (uint32_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i ^ (i >> 7));
+
+    // Mesmo disco fragmentado de test_fragmented_uses_indirect
+    for (int i = 0; i < 30; i++) {
+        name[1] = 'A' + i;
+        CHECK(fs_create(name) == 0);
+        CHECK(fs_write(name, small, sizeof(small)) == (int)sizeof(small));
+    }
+    for (int i = 0; i < 30; i += 2) { name[1] = 'A' + i; CHECK(fs_delete(name) == 0); }
+    CHECK(fs_create("frag") == 0);
+    CHECK(fs_write("frag", data, sizeof(data)) == (int)sizeof(data));
+
+    // 24 blocos: 3 extents e o resto na tabela indireta. Sobram só
+    // buracos de 4 blocos: não dá para juntar
+    CHECK(fs_map("frag", &ptr, &len) == -2);
+
+    // Apagando o resto abre espaço: o arquivo é copiado para um extent só e
+    // a tabela indireta volta para o disco
+    for (int i = 1; i < 30; i += 2) { name[1] = 'A' + i; CHECK(fs_delete(name) == 0); }
+    fs_statfs(&st);
+    uint32_t free0 = st.free_blocks;
+    CHECK(fs_map("frag", &ptr, &len) == 0);
+    CHECK(len == sizeof(data) && memcmp(ptr, data, len) == 0);
+    fs_statfs(&st);
+    CHECK(st.free_blocks == free0 + 1);
+
+    static uint8_t back[sizeof(data)];
+    CHECK(fs_read("frag", back, sizeof(back)) == (int)sizeof(back));
+    CHECK(memcmp(back, data, sizeof(data)) == 0);
+    CHECK(fs_unmap(ptr) == 0);
+}
+
+static void test_mount_image(void) {
+    static uint8_t image[64 * 1024] __attribute__((aligned(KMALLOC_DMA_ALIGN)));
+    uint8_t data[700], back[700];
+    fs_statfs_t st, st2;
+    uint32_t size;
+    fs_fresh();
+    for (uint32_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 3);
+
+    // "mkfs": monta um disco e copia como imagem
+    CHECK(fs_create("model.bin") == 0);
+    CHECK(fs_write("model.bin", data, sizeof(data)) == (int)sizeof(data));
+    CHECK(fs_create("cfg") == 0);
+    CHECK(fs_write("cfg", (const uint8_t *)"rate=9600", 9) == 9);
+    const uint8_t *disk = fs_disk(&size);
+    CHECK(size <= sizeof(image));
+    memcpy(image, disk, size);
+    fs_statfs(&st);
+
+    // Boot novo: monta a imagem no lugar, sem formatar
+    fs_fresh();
+    CHECK(fs_mount(image, size) == 0);
+    CHECK(fs_disk(&size) == image);
+    fs_statfs(&st2);
+    CHECK(st2.free_blocks == st.free_blocks && st2.free_inodes == st.free_inodes);
+    CHECK(fs_read("model.bin", back, sizeof(back)) == (int)sizeof(data));
+    CHECK(memcmp(back, data, sizeof(data)) == 0);
+    CHECK(fs_create("cfg") == -1); // Índice de nomes reconstruído
+
+    // Escritas vão direto para a imagem
+    CHECK(fs_create("new") == 0);
+    CHECK(fs_write("new", data, 300) == 300);
+    CHECK(fs_delete("model.bin") == 0);
+    CHECK(fs_read("new", back, sizeof(back)) == 300);
+
+    // Imagem de outra geometria (ou corrompida) é recusada
+    static uint8_t bad[64 * 1024] __attribute__((aligned(KMALLOC_DMA_ALIGN)));
+    memcpy(bad, image, size);
+    ((superblock_t *)bad)->magic = 0;
+    CHECK(fs_mount(bad, size) == -1);
+    ((superblock_t *)bad)->magic = FS_MAGIC;
+    CHECK(fs_mount(bad, size - FS_BLOCK_SIZE) == -1);
+    CHECK(fs_mount(bad + 4, size) == -1);
+
+    // Metadados que apontam para fora do disco/da tabela também. Layout:
+    // [superbloco][cópia 0 = cabeçalho (8) + bitmaps + inodes][cópia 1]
+    uint32_t meta = size - FS_MAX_BLOCKS * FS_BLOCK_SIZE;
+    uint32_t io   = FS_BLOCK_SIZE > 512 ? FS_BLOCK_SIZE : 512;
+    inode_t *tab = (inode_t *)(bad + io + 8 +
+                               ((FS_MAX_INODES + 31) / 32) * 4 + ((FS_MAX_BLOCKS + 31) / 32) * 4);
+    memcpy(bad, image, size);
+    tab[0].extents[0].start = FS_MAX_BLOCKS - 1;
+    tab[0].extents[0].len   = 2;
+    CHECK(fs_mount(bad, size) == -1);
+
+    memcpy(bad, image, size);
+    tab[0].type = 0; // Raiz livre
+    CHECK(fs_mount(bad, size) == -1);
+
+    memcpy(bad, image, size);
+    dirent_t *root = (dirent_t *)(bad + meta + tab[0].extents[0].start * FS_BLOCK_SIZE);
+    int used = 0;
+    while (root[used].inode_idx == 0xFFFF) used++;
+    root[used].inode_idx = FS_MAX_INODES;
+    CHECK(fs_mount(bad, size) == -1);
+
+    // Mais entradas que inodes: o índice de nomes não caberia
+    memcpy(bad, image, size);
+    dirent_t copy = root[used];
+    tab[0].extents[0].start = FS_MAX_BLOCKS - 8;
+    tab[0].extents[0].len   = 8;
+    tab[0].extents[1].len   = 0;
+    tab[0].blocks_cnt       = 8;
+    dirent_t *full = (dirent_t *)(bad + meta + (FS_MAX_BLOCKS - 8) * FS_BLOCK_SIZE);
+    for (uint32_t i = 0; i < 8 * FS_DIRENTS_PER_BLOCK; i++) full[i] = copy;
+    CHECK(8 * FS_DIRENTS_PER_BLOCK > FS_MAX_INODES);
+    CHECK(fs_mount(bad, size) == -1);
+
+    CHECK(fs_read("new", back, sizeof(back)) == 300); // Continua na imagem anterior
+}
+
+// Dispositivo não mapeado (como o virtio-blk): só read/write, contados
+typedef struct { uint32_t reads, writes, flushes, meta_flushes; } dev_stats_t;
+
+static uint8_t     dev_disk[64 * 1024];
+static dev_stats_t dev_st;
+
+static int dev_fail;      // != 0: toda leitura/escrita do fake falha
+static int dev_fail_meta; // != 0: gravação dos metadados (setor 0) falha
+static int dev_tear;      // != 0: a próxima gravação de vários setores só
+                          // grava o primeiro e falha (queda no meio)
+
+static int fake_read(blkdev_t *dev, uint32_t blk, void *buf, uint32_t count) {
+    if (dev_fail || blk + count > dev->block_count) return -1;
+    memcpy(buf, &dev_disk[blk * 512], count * 512);
+    dev_st.reads++;
+    return 0;
+}
+
+static int fake_write(blkdev_t *dev, uint32_t blk, const void *buf, uint32_t count) {
+    if (dev_fail || (dev_fail_meta && blk == 0) || blk + count > dev->block_count) return -1;
+    if (dev_tear && count > 1) {
+        memcpy(&dev_disk[blk * 512], buf, 512);
+        dev_tear = 0;
+        return -1;
+    }
+    memcpy(&dev_disk[blk * 512], buf, count * 512);
+    dev_st.writes++;
+    if (blk == 0) dev_st.meta_flushes = dev_st.flushes; // Flushes antes dos metadados
+    return 0;
+}
+
+static int fail_read(blkdev_t *dev, uint32_t blk, void *buf, uint32_t count) {
+    (void)dev; (void)blk; (void)buf; (void)count;
+    return -1;
+}
+
+static int fake_flush(blkdev_t *dev) {
+    (void)dev;
+    dev_st.flushes++;
+    return 0;
+}
+
+static void test_block_device(void) {
+    blkdev_t dev = { "fake", 512, sizeof(dev_disk) / 512, NULL, fake_read, fake_write, fake_flush, NULL };
+    static uint8_t big[FS_MAX_FILE], back[FS_MAX_FILE];
+    const uint8_t *ptr;
+    fs_statfs_t st, st2;
+    uint32_t size, len;
+    for (uint32_t i = 0; i < sizeof(big); i++) big[i] = (uint8_t)(i * 7 + 1);
+
+    // Disco vazio: não monta; formatar grava os metadados
+    memset(dev_disk, 0, sizeof(dev_disk));
+    fs_fresh();
+    CHECK(fs_mount_dev(&dev) == -1);
+    memset(&dev_st, 0, sizeof(dev_st));
+    CHECK(fs_format_dev(&dev) == 0);
+    CHECK(dev_st.writes > 0 && dev_st.flushes == 6); // Um commit em cada cópia
+    CHECK(fs_disk(&size) == NULL && size == 0);
+
+    // Write-back: escrita pequena fica no cache até o sync
+    CHECK(fs_create("small") == 0);
+    memset(&dev_st, 0, sizeof(dev_st));
+    CHECK(fs_write("small", big, 700) == 700);
+    CHECK(dev_st.writes == 0);
+    dev_st.reads = 0;
+    CHECK(fs_read("small", back, sizeof(back)) == 700);
+    CHECK(memcmp(back, big, 700) == 0);
+    CHECK(dev_st.reads == 0); // Acerto no cache
+    CHECK(fs_map("small", &ptr, &len) == -2); // Nada mapeado para apontar
+    CHECK(fs_sync() == 0);
+    CHECK(dev_st.writes > 0 && dev_st.flushes == 3);
+    CHECK(dev_st.meta_flushes == 2); // Dados, depois a cópia, e só então o superbloco
+
+    // Arquivo maior que o cache: despejo grava antes do sync
+    CHECK(fs_create("big") == 0);
+    memset(&dev_st, 0, sizeof(dev_st));
+    CHECK(fs_write("big", big, sizeof(big)) == (int)sizeof(big));
+    CHECK(dev_st.writes > 0);
+    CHECK(fs_read("big", back, sizeof(back)) == (int)sizeof(big));
+    CHECK(memcmp(back, big, sizeof(big)) == 0);
+    CHECK(fs_delete("small") == 0);
+    CHECK(fs_mkdir("d") == 0 && fs_create("d/f") == 0);
+    CHECK(fs_write("d/f", big, 300) == 300);
+    CHECK(fs_sync() == 0);
+    fs_statfs(&st);
+
+    // Boot novo: monta do dispositivo e acha tudo
+    fs_fresh();
+    CHECK(fs_mount_dev(&dev) == 0);
+    fs_statfs(&st2);
+    CHECK(st2.free_blocks == st.free_blocks && st2.free_inodes == st.free_inodes);
+    CHECK(fs_read("big", back, sizeof(back)) == (int)sizeof(big));
+    CHECK(memcmp(back, big, sizeof(big)) == 0);
+    CHECK(fs_read("small", back, sizeof(back)) == -1);
+    CHECK(fs_read("d/f", back, sizeof(back)) == 300); // Subdiretórios no índice reconstruído
+    CHECK(fs_rmdir("d") == -2);
+
+    // Erro de leitura não é "disco sem RamFS" (o boot só formata no -1);
+    // outra geometria também não
+    blkdev_t broken = dev;
+    broken.read = fail_read;
+    CHECK(fs_mount_dev(&broken) == -2);
+    ((superblock_t *)dev_disk)->block_count++;
+    CHECK(fs_mount_dev(&dev) == -3);
+    ((superblock_t *)dev_disk)->block_count--;
+
+    // Dispositivo menor que o disco da RamFS é recusado
+    blkdev_t tiny = dev;
+    tiny.block_count = 8;
+    CHECK(fs_mount_dev(&tiny) == -2);
+    CHECK(fs_format_dev(&tiny) == -1);
+}
+
+// Queda de energia entre commits: o dispositivo fica com os metadados do
+// último commit, e os blocos que eles apontam não foram reaproveitados
+static void test_cow_crash(void) {
+    blkdev_t dev = { "fake", 512, sizeof(dev_disk) / 512, NULL, fake_read, fake_write, fake_flush, NULL };
+    static uint8_t a[FS_MAX_FILE], b[FS_MAX_FILE], back[FS_MAX_FILE];
+    fs_statfs_t st;
+    memset(a, 'a', sizeof(a));
+    memset(b, 'b', sizeof(b));
+
+    fs_fresh();
+    CHECK(fs_format_dev(&dev) == 0);
+    CHECK(fs_create("w") == 0 && fs_create("big") == 0);
+    CHECK(fs_write("w", a, 700) == 700);
+    CHECK(fs_sync() == 0);
+
+    // Menos escritas que o lote: nada de metadados no dispositivo. O
+    // arquivo grande força o despejo dos blocos novos antes do "crash"
+    memset(&dev_st, 0, sizeof(dev_st));
+    for (int i = 0; i < 2; i++) {
+        CHECK(fs_write("w", b, 700) == 700);
+        CHECK(fs_write("big", b, sizeof(b)) == (int)sizeof(b));
+    }
+    CHECK(dev_st.writes > 0 && dev_st.flushes == 0);
+    CHECK(fs_read("w", back, sizeof(back)) == 700 && back[0] == 'b');
+
+    fs_fresh(); // Sem fs_sync
+    CHECK(fs_mount_dev(&dev) == 0);
+    CHECK(fs_read("w", back, sizeof(back)) == 700);
+    CHECK(memcmp(back, a, 700) == 0); // Versão do último commit, intacta
+    CHECK(fs_read("big", back, sizeof(back)) == 0);
+
+    // Lote completo: o commit sai sozinho
+    memset(&dev_st, 0, sizeof(dev_st));
+    for (int i = 0; i < FS_COMMIT_BATCH; i++) CHECK(fs_write("w", b, 300) == 300);
+    CHECK(dev_st.flushes == 3); // Um commit (dados, cópia, superbloco)
+    fs_fresh();
+    CHECK(fs_mount_dev(&dev) == 0);
+    CHECK(fs_read("w", back, sizeof(back)) == 300 && memcmp(back, b, 300) == 0);
+
+    // Reservados contam como livres e voltam no commit quando faltam blocos
+    static uint8_t fill[FS_DISK];
+    fs_statfs(&st);
+    CHECK(fs_write("w", a, 300) == 300); // 2 blocos antigos reservados
+    fs_statfs(&st);
+    uint32_t n = (st.free_blocks - 1) * FS_BLOCK_SIZE;
+    memset(&dev_st, 0, sizeof(dev_st));
+    CHECK(fs_write("big", fill, n) == (int)n);
+    CHECK(dev_st.flushes == 3);
+}
+
+// Erros do dispositivo chegam a quem chamou (-7) e não estragam nada
+static void test_io_errors(void) {
+    blkdev_t dev = { "fake", 512, sizeof(dev_disk) / 512, NULL, fake_read, fake_write, fake_flush, NULL };
+    static uint8_t a[FS_MAX_FILE], b[FS_MAX_FILE], back[FS_MAX_FILE];
+    memset(a, 'a', sizeof(a));
+    memset(b, 'b', sizeof(b));
+
+    fs_fresh();
+    CHECK(fs_format_dev(&dev) == 0);
+    CHECK(fs_create("f") == 0 && fs_create("g") == 0);
+    CHECK(fs_write("f", a, sizeof(a)) == (int)sizeof(a));
+    CHECK(fs_sync() == 0);
+
+    // Cache frio: a leitura falha em vez de devolver zeros
+    fs_fresh();
+    CHECK(fs_mount_dev(&dev) == 0);
+    dev_fail = 1;
+    CHECK(fs_read("f", back, sizeof(back)) == -7);
+    int fd = fs_open("f", FS_O_READ);
+    CHECK(fs_fread(fd, back, sizeof(back)) == -7);
+    CHECK(fs_close(fd) == 0);
+    dev_fail = 0;
+    CHECK(fs_read("f", back, sizeof(back)) == (int)sizeof(a));
+    CHECK(memcmp(back, a, sizeof(a)) == 0);
+
+    // Despejo que não grava: a escrita falha e o arquivo fica como estava;
+    // os buffers sujos continuam no cache e vão no sync seguinte
+    CHECK(fs_write("g", b, 700) == 700);
+    dev_fail = 1;
+    CHECK(fs_write("f", b, sizeof(b)) == -7);
+    CHECK(fs_sync() == -1);
+    dev_fail = 0;
+    CHECK(fs_read("f", back, sizeof(back)) == (int)sizeof(a));
+    CHECK(memcmp(back, a, sizeof(a)) == 0);
+    CHECK(fs_sync() == 0);
+
+    fs_fresh();
+    CHECK(fs_mount_dev(&dev) == 0);
+    CHECK(fs_read("g", back, sizeof(back)) == 700 && memcmp(back, b, 700) == 0);
+    CHECK(fs_read("f", back, sizeof(back)) == (int)sizeof(a) && memcmp(back, a, sizeof(a)) == 0);
+}
+
+// Commit que falha nos metadados: os blocos reservados não podem voltar
+// ao alocador (o disco ainda aponta para eles)
+static void test_commit_meta_fails(void) {
+    blkdev_t dev = { "fake", 512, sizeof(dev_disk) / 512, NULL, fake_read, fake_write, fake_flush, NULL };
+    static uint8_t a[FS_MAX_FILE], b[FS_MAX_FILE], c[FS_MAX_FILE], back[FS_MAX_FILE];
+    static uint8_t fill[FS_DISK];
+    fs_statfs_t st;
+    memset(a, 'a', sizeof(a));
+    memset(b, 'b', sizeof(b));
+    memset(c, 'c', sizeof(c));
+
+    // Disco cheio menos 3 blocos: o único lugar livre depois são os
+    // blocos de 'a', se o commit falho os devolver
+    fs_fresh();
+    CHECK(fs_format_dev(&dev) == 0);
+    CHECK(fs_create("w") == 0 && fs_create("g") == 0 && fs_create("fill") == 0);
+    CHECK(fs_write("w", a, 700) == 700);
+    fs_statfs(&st);
+    uint32_t n = (st.free_blocks - 3) * FS_BLOCK_SIZE;
+    CHECK(fs_write("fill", fill, n) == (int)n);
+    CHECK(fs_sync() == 0);
+
+    CHECK(fs_write("w", b, 700) == 700); // Blocos de 'a' reservados
+    dev_fail_meta = 1;
+    CHECK(fs_sync() == -1);
+    dev_fail_meta = 0;
+
+    // Só os reservados dariam conta: precisa de um commit de verdade antes
+    // de reaproveitá-los. Ler o arquivo grande despeja 'g' no dispositivo.
+    CHECK(fs_write("g", c, 700) == 700);
+    CHECK(fs_read("fill", fill, sizeof(fill)) == (int)n);
+    fs_fresh(); // "Crash"
+    CHECK(fs_mount_dev(&dev) == 0);
+    CHECK(fs_read("w", back, sizeof(back)) == 700);
+    CHECK(memcmp(back, a, 700) == 0 || memcmp(back, b, 700) == 0);
+}
+
+// Queda no meio da gravação dos metadados: só o primeiro setor chega ao
+// disco. O mount fica com o commit anterior inteiro (inodes e bitmaps da
+// mesma versão), não com uma mistura.
+static void test_commit_torn(void) {
+    blkdev_t dev = { "fake", 512, sizeof(dev_disk) / 512, NULL, fake_read, fake_write, fake_flush, NULL };
+    static uint8_t a[FS_MAX_FILE], b[FS_MAX_FILE], back[FS_MAX_FILE];
+    static uint8_t fill[FS_DISK];
+    char name[8] = "f00";
+    fs_statfs_t st;
+    memset(a, 'a', sizeof(a));
+    memset(b, 'b', sizeof(b));
+    memset(fill, 'f', sizeof(fill));
+
+    // Inode de 'w' longe do começo da tabela: fora do primeiro setor
+    fs_fresh();
+    CHECK(fs_format_dev(&dev) == 0);
+    for (int i = 0; i < 24; i++) {
+        name[1] = (char)('0' + i / 10);
+        name[2] = (char)('0' + i % 10);
+        CHECK(fs_create(name) == 0);
+    }
+    CHECK(fs_create("w") == 0 && fs_create("fill") == 0);
+    CHECK(fs_write("w", a, 700) == 700);
+    CHECK(fs_sync() == 0);
+
+    CHECK(fs_write("w", b, 700) == 700);
+    dev_tear = 1;
+    CHECK(fs_sync() == -1);
+    CHECK(dev_tear == 0);
+
+    fs_fresh(); // "Crash"
+    CHECK(fs_mount_dev(&dev) == 0);
+    CHECK(fs_read("w", back, sizeof(back)) == 700 && memcmp(back, a, 700) == 0);
+
+    // Os blocos de 'a' continuam marcados como usados: encher o disco não
+    // passa por cima deles
+    fs_statfs(&st);
+    uint32_t n = (st.free_blocks - 1) * FS_BLOCK_SIZE; // 1 para o indireto
+    CHECK(fs_write("fill", fill, n) == (int)n);
+    CHECK(fs_read("w", back, sizeof(back)) == 700 && memcmp(back, a, 700) == 0);
+
+    // Commit seguinte normal; depois do mount vale o novo
+    CHECK(fs_delete("fill") == 0 && fs_create("fill") == 0);
+    CHECK(fs_write("fill", fill, 10) == 10);
+    CHECK(fs_write("w", b, 300) == 300);
+    CHECK(fs_sync() == 0);
+    fs_fresh();
+    CHECK(fs_mount_dev(&dev) == 0);
+    CHECK(fs_read("w", back, sizeof(back)) == 300 && memcmp(back, b, 300) == 0);
+    CHECK(fs_read("fill", back, sizeof(back)) > 0 && back[0] == 'f');
+}
+
+// Imagem do disco mapeado (mkfs) num dispositivo com cache, e formatar por
+// cima de uma RamFS com mais commits: a cópia antiga não volta no mount
+static void test_image_on_device(void) {
+    blkdev_t dev = { "fake", 512, sizeof(dev_disk) / 512, NULL, fake_read, fake_write, fake_flush, NULL };
+    uint8_t back[16];
+    uint32_t size;
+
+    fs_fresh();
+    CHECK(fs_create("cfg") == 0);
+    CHECK(fs_write("cfg", (const uint8_t *)"rate=9600", 9) == 9);
+    const uint8_t *disk = fs_disk(&size);
+    CHECK(size <= sizeof(dev_disk));
+    memcpy(dev_disk, disk, size);
+
+    fs_fresh();
+    CHECK(fs_mount_dev(&dev) == 0);
+    CHECK(fs_read("cfg", back, sizeof(back)) == 9 && memcmp(back, "rate=9600", 9) == 0);
+    for (int i = 0; i < 5; i++) CHECK(fs_sync() == 0);
+
+    fs_fresh();
+    CHECK(fs_format_dev(&dev) == 0);
+    fs_fresh();
+    CHECK(fs_mount_dev(&dev) == 0);
+    CHECK(fs_read("cfg", back, sizeof(back)) == -1);
+}
+
+int main(void) {
+    RUN(test_create_and_duplicate);
+    RUN(test_name_length);
+    RUN(test_write_read_roundtrip);
+    RUN(test_list);
+    RUN(test_blocks_are_recycled);
+    RUN(test_directory_grows);
+    RUN(test_subdirs);
+    RUN(test_subdir_grows);
+    RUN(test_path_cache);
+    RUN(test_index_churn);
+    RUN(test_statfs_counters);
+    RUN(test_disk_full_to_last_block);
+    RUN(test_cow_write);
+    RUN(test_fd_after_shrink);
+    RUN(test_fd_offsets);
+    RUN(test_fd_append_no_realloc);
+    RUN(test_fd_trunc_and_limits);
+    RUN(test_large_file_one_extent);
+    RUN(test_fragmented_uses_indirect);
+    RUN(test_map);
+    RUN(test_map_fragmented);
+    RUN(test_mount_image);
+    RUN(test_block_device);
+    RUN(test_cow_crash);
+    RUN(test_io_errors);
+    RUN(test_commit_meta_fails);
+    RUN(test_commit_torn);
+    RUN(test_image_on_device);
+    TEST_MAIN_END();
+}
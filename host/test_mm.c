@@ -0,0 +1,244 @@
+#include <string.h>
+#include "host.h"
+#include "kernel/mm.h"
+#include "kernel/klog.h"
+#include "kernel/task.h"
+
+// ============================================================================
+// TESTES: ALOCADOR (mm.c)
+// ============================================================================
+
+static void test_alloc_free_roundtrip(void) {
+    host_heap_reset();
+    uint32_t free0 = kget_free_memory();
+
+    void *a = kmalloc(100);
+    void *b = kmalloc(200);
+    CHECK(a && b && a != b);
+    CHECK(((uintptr_t)a & 3) == 0);
+    CHECK((uint8_t *)b >= (uint8_t *)a + 100);
+
+    memset(a, 0xAA, 100);
+    memset(b, 0xBB, 200);
+    CHECK(((uint8_t *)a)[99] == 0xAA);
+
+    CHECK(kfree(a) == 0);
+    CHECK(kfree(b) == 0);
+
+    // Sem fusão automática: o total livre só volta após o defrag
+    kheap_defrag();
+    CHECK(kget_free_memory() == free0);
+}
+
+static void test_size_rounding(void) {
+    host_heap_reset();
+    uint8_t *a = kmalloc(1);
+    uint8_t *b = kmalloc(1);
+    CHECK(a && b);
+    CHECK(((uintptr_t)b & 3) == 0);
+    kfree(a);
+    kfree(b);
+}
+
+static void test_out_of_memory(void) {
+    host_heap_reset();
+    CHECK(kmalloc(HOST_HEAP_SIZE) == NULL);
+
+    // Esgota o heap em pedaços e confere que não há sobreposição
+    void *blocks[512];
+    int n = 0;
+    while (n < 512 && (blocks[n] = kmalloc(1024)) != NULL) {
+        memset(blocks[n], n, 1024);
+        n++;
+    }
+    CHECK(n > 100 && n < 128);
+    for (int i = 0; i < n; i++) CHECK(((uint8_t *)blocks[i])[1023] == (uint8_t)i);
+    for (int i = 0; i < n; i++) CHECK(kfree(blocks[i]) == 0);
+}
+
+static void test_aligned(void) {
+    host_heap_reset();
+    void *pad = kmalloc(12);
+    void *p = kmalloc_aligned(64, 256);
+    void *q = kmalloc_aligned(64, 32);
+    CHECK(p && ((uintptr_t)p & 255) == 0);
+    CHECK(q && ((uintptr_t)q & 31) == 0);
+    CHECK(kmalloc_aligned(64, 24) == NULL); // Não é potência de 2
+    CHECK(kfree(p) == 0);
+    CHECK(kfree(q) == 0);
+    CHECK(kfree(pad) == 0);
+}
+
+static void test_invalid_free(void) {
+    host_heap_reset();
+    host_klog_reset();
+
+    uint8_t *p = kmalloc(32);
+    int local;
+
+    CHECK(kfree(&local) != 0);
+    CHECK(host_klog_count(KLOG_MM_BAD_BOUNDS) == 1);
+
+    CHECK(kfree(p + 1) != 0);
+    CHECK(host_klog_count(KLOG_MM_BAD_ALIGN) == 1);
+
+    CHECK(kfree(p) == 0);
+    CHECK(kfree(p) != 0);
+    CHECK(host_klog_count(KLOG_MM_DOUBLE_FREE) == 1);
+
+    // Ponteiro alinhado, mas no meio de um bloco (sem canary)
+    uint8_t *q = kmalloc(64);
+    CHECK(kfree(q + 32) != 0);
+    CHECK(host_klog_count(KLOG_MM_BAD_CANARY) == 1);
+    kfree(q);
+}
+
+static void test_quota_and_reclaim(void) {
+    host_heap_reset();
+    host_klog_reset();
+
+    kheap_set_quota(1, 256);
+    void *a = kmalloc_task(200, 1);
+    CHECK(a != NULL);
+    CHECK(kheap_task_usage(1) == 200);
+    CHECK(kmalloc_task(100, 1) == NULL);
+    CHECK(host_klog_count(KLOG_MM_QUOTA_EXCEEDED) == 1);
+
+    void *b = kmalloc_task(40, 1);
+    CHECK(b != NULL);
+    CHECK(kheap_task_usage(1) == 240);
+
+    CHECK(kheap_reclaim(1) == 240);
+    CHECK(kheap_task_usage(1) == 0);
+    CHECK(kfree(a) != 0); // Já recuperado
+    kheap_set_quota(1, MM_QUOTA_UNLIMITED);
+    CHECK(kmalloc_task(1024, MAX_TASKS) == NULL);
+
+    // Buraco pouco maior que o pedido (não divide): a tarefa pagaria o
+    // bloco inteiro e passaria da quota. Vai para um bloco que divide.
+    void *x = kmalloc(100), *y = kmalloc(16);
+    kfree(x);
+    kheap_set_quota(1, 96);
+    void *c = kmalloc_task(96, 1);
+    CHECK(c != NULL && c != x);
+    CHECK(kheap_task_usage(1) == 96);
+    CHECK(kmalloc_task(4, 1) == NULL);
+    kheap_reclaim(1);
+    kfree(y);
+    kheap_set_quota(1, MM_QUOTA_UNLIMITED);
+}
+
+// Só um buraco que não divide: o pedido cabe na quota, o bloco inteiro
+// não. Falha e registra o estouro.
+static void test_quota_logged_at_charge(void) {
+    host_heap_reset();
+    host_klog_reset();
+
+    void *x = kmalloc(100);
+    CHECK(x && kmalloc(16));
+    while (kmalloc(1024)) ;
+    while (kmalloc(4)) ;
+    kfree(x);
+
+    kheap_set_quota(1, 96);
+    CHECK(kmalloc_task(96, 1) == NULL);
+    CHECK(kheap_task_usage(1) == 0);
+    CHECK(host_klog_count(KLOG_MM_QUOTA_EXCEEDED) == 1);
+    kheap_set_quota(1, MM_QUOTA_UNLIMITED);
+    CHECK(kmalloc_task(96, 1) == x);
+    kheap_reclaim(1);
+}
+
+static void test_realloc(void) {
+    host_heap_reset();
+
+    uint8_t *p = kmalloc(64);
+    for (int i = 0; i < 64; i++) p[i] = (uint8_t)i;
+
+    // Cresce no lugar (vizinho livre)
+    uint8_t *q = krealloc(p, 512);
+    CHECK(q == p);
+    for (int i = 0; i < 64; i++) CHECK(q[i] == (uint8_t)i);
+
+    // Encolhe no lugar
+    CHECK(krealloc(q, 16) == q);
+
+    // Vizinho ocupado: move e preserva o conteúdo
+    uint8_t *wall = kmalloc(16);
+    uint8_t *r = krealloc(q, 4096);
+    CHECK(r && r != q);
+    for (int i = 0; i < 16; i++) CHECK(r[i] == (uint8_t)i);
+
+    // Dono errado
+    host_klog_reset();
+    uint8_t *t = kmalloc_task(32, 2);
+    CHECK(krealloc_task(t, 64, 3) == NULL);
+    CHECK(host_klog_count(KLOG_MM_REALLOC_OWNER) == 1);
+    CHECK(krealloc_task(t, 64, 2) != NULL);
+
+    CHECK(krealloc(NULL, 8) != NULL);
+    kfree(wall);
+    kheap_reclaim(2);
+}
+
+// Quota no krealloc_task: vale o que é cobrado de fato, e o bloco antigo
+// não conta duas vezes quando o dado muda de lugar
+static void test_realloc_quota(void) {
+    host_heap_reset();
+    host_klog_reset();
+
+    // Vizinho livre que não divide: crescer no lugar cobraria o vizinho
+    // inteiro e passaria da quota. Move para um bloco que divide.
+    uint8_t *p = kmalloc_task(64, 1);
+    uint8_t *n = kmalloc(100);
+    uint8_t *w = kmalloc(16);
+    uint32_t hdr    = (uint32_t)(n - p) - 64;
+    uint32_t joined = (uint32_t)(w - p) - hdr; // p + cabeçalho + vizinho
+    kfree(n);
+    kheap_set_quota(1, joined - 8);
+    uint8_t *q = krealloc_task(p, joined - 8, 1);
+    CHECK(q && q != p);
+    CHECK(kheap_task_usage(1) == joined - 8);
+    kheap_reclaim(1);
+
+    // Mover perto da quota: o crescimento líquido cabe
+    kheap_set_quota(1, 256);
+    p = kmalloc_task(128, 1);
+    w = kmalloc(16);
+    q = krealloc_task(p, 200, 1);
+    CHECK(q && q != p);
+    CHECK(kheap_task_usage(1) == 200);
+    CHECK(krealloc_task(q, 260, 1) == NULL);
+    CHECK(kheap_task_usage(1) == 200);
+    CHECK(host_klog_count(KLOG_MM_QUOTA_EXCEEDED) == 1);
+    kheap_reclaim(1);
+    kheap_set_quota(1, MM_QUOTA_UNLIMITED);
+}
+
+static void test_defrag(void) {
+    host_heap_reset();
+    void *b[8];
+    for (int i = 0; i < 8; i++) b[i] = kmalloc(1000);
+    for (int i = 0; i < 8; i++) kfree(b[i]);
+
+    // Fragmentado: 8 blocos de 1000 não atendem 5000 sem fusão
+    void *big = kmalloc(5000);
+    CHECK(big != NULL); // Sobra do bloco gênese atende
+    kfree(big);
+    kheap_defrag();
+    CHECK(kmalloc(HOST_HEAP_SIZE - 256) != NULL);
+}
+
+int main(void) {
+    RUN(test_alloc_free_roundtrip);
+    RUN(test_size_rounding);
+    RUN(test_out_of_memory);
+    RUN(test_aligned);
+    RUN(test_invalid_free);
+    RUN(test_quota_and_reclaim);
+    RUN(test_quota_logged_at_charge);
+    RUN(test_realloc);
+    RUN(test_realloc_quota);
+    RUN(test_defrag);
+    TEST_MAIN_END();
+}
@@ -0,0 +1,176 @@
+#include <string.h>
+#include <pthread.h>
+#include "host.h"
+#include "util/ring_buffer.h"
+
+// ============================================================================
+// TESTES: RING BUFFER SPSC (ring_buffer.h)
+// ============================================================================
+
+RING_DEFINE(ring8, uint8_t, 128)
+
+typedef struct { uint32_t seq; uint16_t a; uint8_t b; } msg_t;
+RING_DEFINE(ringm, msg_t, 16)
+
+static void test_empty_and_full(void) {
+    static ring8_t rb;
+    uint8_t v;
+    ring8_init(&rb);
+    CHECK(ring8_pop(&rb, &v) == 0);
+    CHECK(ring8_count(&rb) == 0);
+
+    // Índices livres: todas as posições são usadas
+    int pushed = 0;
+    while (ring8_push(&rb, (uint8_t)pushed)) pushed++;
+    CHECK(pushed == 128);
+    CHECK(ring8_space(&rb) == 0);
+
+    for (int i = 0; i < pushed; i++) {
+        CHECK(ring8_pop(&rb, &v) == 1);
+        CHECK(v == (uint8_t)i);
+    }
+    CHECK(ring8_pop(&rb, &v) == 0);
+}
+
+static void test_wraparound(void) {
+    static ring8_t rb;
+    uint8_t v;
+    ring8_init(&rb);
+
+    // Muitas voltas com ocupação variável
+    uint8_t next_in = 0, next_out = 0;
+    for (int round = 0; round < 1000; round++) {
+        int burst = (round * 7) % 50;
+        for (int i = 0; i < burst; i++) if (ring8_push(&rb, next_in)) next_in++;
+        for (int i = 0; i < burst / 2 + 1; i++) {
+            if (ring8_pop(&rb, &v)) { CHECK(v == next_out); next_out++; }
+        }
+    }
+    while (ring8_pop(&rb, &v)) { CHECK(v == next_out); next_out++; }
+    CHECK(next_in == next_out);
+}
+
+static void test_index_overflow(void) {
+    static ring8_t rb;
+    uint8_t v;
+    // head/tail perto de 2^32: a subtração sem sinal continua certa
+    rb.head = rb.tail = 0xFFFFFFF0u;
+    for (int i = 0; i < 100; i++) CHECK(ring8_push(&rb, (uint8_t)i));
+    CHECK(ring8_count(&rb) == 100);
+    for (int i = 0; i < 100; i++) { CHECK(ring8_pop(&rb, &v)); CHECK(v == (uint8_t)i); }
+    CHECK(ring8_count(&rb) == 0);
+}
+
+static void test_bulk(void) {
+    static ring8_t rb;
+    uint8_t in[300], out[300];
+    for (int i = 0; i < 300; i++) in[i] = (uint8_t)(i * 3);
+    ring8_init(&rb);
+
+    CHECK(ring8_push_n(&rb, in, 100) == 100);
+    CHECK(ring8_pop_n(&rb, out, 60) == 60);
+    CHECK(memcmp(in, out, 60) == 0);
+
+    // Cruza o fim do vetor: dois pedaços; só cabem 128 - 40
+    CHECK(ring8_push_n(&rb, in + 100, 200) == 88);
+    CHECK(ring8_count(&rb) == 128);
+    CHECK(ring8_pop_n(&rb, out + 60, 300) == 128);
+    CHECK(memcmp(in + 60, out + 60, 128) == 0);
+    CHECK(ring8_pop_n(&rb, out, 10) == 0);
+}
+
+static void test_peek_commit(void) {
+    static ringm_t rb;
+    msg_t *p;
+    ringm_init(&rb);
+
+    // Região contígua vai até o fim do vetor, não além
+    rb.head = rb.tail = 12;
+    uint32_t n = ringm_write_peek(&rb, &p);
+    CHECK(n == 4);
+    for (uint32_t i = 0; i < n; i++) { p[i].seq = i; p[i].a = 100 + i; p[i].b = 7; }
+    ringm_write_commit(&rb, n);
+
+    n = ringm_write_peek(&rb, &p);
+    CHECK(n == 12);  // Segundo pedaço, do início até tail
+    p[0].seq = 4;
+    ringm_write_commit(&rb, 1);
+    CHECK(ringm_count(&rb) == 5);
+
+    n = ringm_read_peek(&rb, &p);
+    CHECK(n == 4 && p[0].seq == 0 && p[3].a == 103);
+    ringm_read_commit(&rb, 2);  // Consumo parcial
+    n = ringm_read_peek(&rb, &p);
+    CHECK(n == 2 && p[0].seq == 2);
+    ringm_read_commit(&rb, n);
+    n = ringm_read_peek(&rb, &p);
+    CHECK(n == 1 && p[0].seq == 4);
+    ringm_read_commit(&rb, 1);
+    CHECK(ringm_read_peek(&rb, &p) == 0);
+}
+
+// Produtor e consumidor em threads reais: pega erro de ordem de memória
+// (o consumidor veria um slot antes de o produtor terminar de escrevê-lo).
+#define STRESS_MSGS 100000
+
+static ringm_t stress_rb;
+
+// Cede a CPU (a máquina de teste pode ter um núcleo só)
+static void backoff(void) {
+    struct timespec ts = { 0, 1000 };
+    nanosleep(&ts, NULL);
+}
+
+static void *stress_producer(void *arg) {
+    (void)arg;
+    msg_t batch[5];
+    uint32_t seq = 0;
+    while (seq < STRESS_MSGS) {
+        if (seq % 3) {
+            msg_t m = { seq, (uint16_t)seq, (uint8_t)(seq ^ 0x5A) };
+            if (ringm_push(&stress_rb, m)) seq++;
+            else backoff();  // Cheio
+        } else {
+            uint32_t k = (STRESS_MSGS - seq < 5) ? STRESS_MSGS - seq : 5;
+            for (uint32_t i = 0; i < k; i++) {
+                batch[i].seq = seq + i; batch[i].a = (uint16_t)(seq + i);
+                batch[i].b = (uint8_t)((seq + i) ^ 0x5A);
+            }
+            uint32_t pushed = ringm_push_n(&stress_rb, batch, k);
+            if (pushed == 0) backoff();
+            seq += pushed;
+        }
+    }
+    return NULL;
+}
+
+static void test_spsc_threads(void) {
+    pthread_t prod;
+    msg_t out[7];
+    uint32_t expect = 0;
+    int ok = 1;
+
+    ringm_init(&stress_rb);
+    pthread_create(&prod, NULL, stress_producer, NULL);
+    while (expect < STRESS_MSGS && ok) {
+        uint32_t n = ringm_pop_n(&stress_rb, out, 7);
+        if (n == 0) backoff();  // Vazio
+        for (uint32_t i = 0; i < n; i++, expect++) {
+            if (out[i].seq != expect || out[i].a != (uint16_t)expect ||
+                out[i].b != (uint8_t)(expect ^ 0x5A)) { ok = 0; break; }
+        }
+    }
+    pthread_join(prod, NULL);
+    CHECK(ok);
+    CHECK(expect == STRESS_MSGS);
+}
+
+int main(void) {
+    RUN(test_empty_and_full);
+    RUN(test_wraparound);
+    RUN(test_index_overflow);
+    RUN(test_bulk);
+    RUN(test_peek_commit);
+    RUN(test_spsc_threads);
+    TEST_MAIN_END();
+}
@@ -0,0 +1,144 @@
+#include "host.h"
+#include "kernel/task.h"
+#include "kernel/mm.h"
+
+// ============================================================================
+// TESTES: ESCALONADOR (seleção de tarefas em scheduler.c)
+// ============================================================================
+// As tarefas nunca rodam no host: só o TCB e a decisão do schedule().
+// "Trocar de contexto" aqui é current_task = next_task (o que o trap.s faz).
+
+int scheduler_suspend(uint32_t pid);
+int scheduler_resume(uint32_t pid);
+int scheduler_kill(uint32_t pid);
+
+static void dummy_task(void) {}
+
+static int tick(void) {
+    schedule();
+    current_task = next_task;
+    return current_task ? (int)current_task->tid : -1;
+}
+
+// leds(1) monitor(1) shell(2) logger(1) idle(0), como no boot
+static void boot_tasks(void) {
+    host_heap_reset();
+    host_set_cycles(0);
+    scheduler_init();
+    next_task = NULL;
+    task_create(dummy_task, "leds", 1);
+    task_create(dummy_task, "monitor", 1);
+    task_create(dummy_task, "shell", 2);
+    task_create(dummy_task, "logger", 1);
+    task_create(dummy_task, "idle", 0);
+}
+
+static void test_highest_priority_wins(void) {
+    boot_tasks();
+    CHECK(tick() == 2);
+    CHECK(tick() == 2); // Continua com a maior prioridade
+}
+
+static void test_round_robin_equal_priority(void) {
+    boot_tasks();
+    CHECK(tick() == 2);
+    CHECK(scheduler_suspend(2) == 0);
+    current_task = next_task;
+
+    // Só restam leds/monitor/logger (prioridade 1): revezam
+    int a = tick(), b = tick(), c = tick(), d = tick();
+    CHECK(a != b && b != c && a != c && a == d);
+    CHECK(a != 2 && b != 2 && c != 2 && a != 4 && b != 4 && c != 4);
+}
+
+static void test_sleep_and_wake(void) {
+    boot_tasks();
+    CHECK(tick() == 2);
+
+    // Shell dorme 10ms = 100000 ciclos a 10MHz
+    scheduler_sleep(10);
+    current_task = next_task;
+    CHECK(current_task->tid != 2);
+
+    host_set_cycles(99999);
+    CHECK(tick() != 2);
+    host_set_cycles(100000);
+    CHECK(tick() == 2);
+}
+
+static void test_idle_when_all_blocked(void) {
+    boot_tasks();
+    tick();
+    scheduler_suspend(0);
+    scheduler_suspend(1);
+    scheduler_suspend(2);
+    scheduler_suspend(3);
+    CHECK(scheduler_suspend(4) == -1); // Idle não pode ser pausada
+    CHECK(tick() == 4);
+
+    scheduler_resume(1);
+    CHECK(tick() == 1);
+}
+
+static void test_kill_reclaims_heap(void) {
+    boot_tasks();
+    tick();
+    CHECK(kmalloc_task(128, 0) != NULL);
+    CHECK(kheap_task_usage(0) == 128);
+    CHECK(scheduler_kill(0) == 0);
+    CHECK(kheap_task_usage(0) == 0);
+    CHECK(scheduler_kill(0) == -1);
+    CHECK(scheduler_kill(4) == -1); // Idle
+    CHECK(scheduler_kill(3) == 0);  // Logger é uma tarefa comum
+    for (int i = 0; i < 10; i++) CHECK(tick() != 0);
+}
+
+static void test_dead_stays_dead(void) {
+    boot_tasks();
+    tick();
+    CHECK(scheduler_kill(0) == 0);
+    CHECK(scheduler_suspend(0) == -1);
+    CHECK(scheduler_resume(0) == -1);
+    CHECK(scheduler_suspend(99) == -1);
+    CHECK(scheduler_resume(1) == -1); // Não estava pausada
+    for (int i = 0; i < 10; i++) CHECK(tick() != 0);
+}
+
+static void test_kill_releases_mutex(void) {
+    mutex_t m;
+    mutex_init(&m);
+    boot_tasks();
+    CHECK(tick() == 2);
+    CHECK(scheduler_mutex_lock(&m) == 1);
+    CHECK(scheduler_mutex_lock(&m) == 0);
+
+    // Outra tarefa (monitor, tid 1: o TCB vizinho) não destranca
+    current_task = &current_task[-1];
+    scheduler_mutex_unlock(&m);
+    CHECK(m.locked == 1);
+
+    // Morta segurando o mutex: volta a estar livre para os outros
+    CHECK(scheduler_kill(2) == 0);
+    CHECK(m.locked == 0);
+    CHECK(scheduler_mutex_lock(&m) == 1 && m.owner_tid == 1);
+    scheduler_mutex_unlock(&m);
+    CHECK(m.locked == 0);
+}
+
+static void test_max_tasks(void) {
+    boot_tasks();
+    while (task_create(dummy_task, "extra", 1) >= 0) {}
+    CHECK(task_create(dummy_task, "extra", 1) == -1);
+}
+
+int main(void) {
+    RUN(test_highest_priority_wins);
+    RUN(test_round_robin_equal_priority);
+    RUN(test_sleep_and_wake);
+    RUN(test_idle_when_all_blocked);
+    RUN(test_kill_reclaims_heap);
+    RUN(test_dead_stays_dead);
+    RUN(test_kill_releases_mutex);
+    RUN(test_max_tasks);
+    TEST_MAIN_END();
+}
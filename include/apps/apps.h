@@ -8,5 +8,6 @@ void apps_init(void);
 void task_shell(void);
 void task_leds(void);
 void task_monitor(void);
+void task_logger(void);
 
 #endif
\ No newline at end of file
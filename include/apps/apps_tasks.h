@@ -1,12 +1,21 @@
 #ifndef APPS_TASKS_H
 #define APPS_TASKS_H
 
+#include <stdint.h>
+#include "util/ring_buffer.h"
+
 // Protótipos das tarefas 
 void task_shell(void);
 void task_leds(void);
 void task_monitor(void);
+void task_logger(void);
 
 // ISR para UART
 void uart_isr(void);
 
+// Buffer do teclado: a ISR produz, o shell consome (definido em apps.c)
+#define UART_RX_SIZE 128
+RING_DEFINE(rx_ring, uint8_t, UART_RX_SIZE)
+extern rx_ring_t rx_buffer;
+
 #endif
@@ -6,11 +6,17 @@ void cmd_help(const char *args);
 void cmd_clear(const char *args);
 void cmd_reboot(const char *args);
 void cmd_panic(const char *args);
+void cmd_bench(const char *args);
+int  bench_run_all(void);   // 'bench all'; retorna as falhas
+void cmd_bootlog(const char *args);
+void cmd_trace(const char *args);
+void cmd_prof(const char *args);
 
 // Processos
 void cmd_ps(const char *args);
 void cmd_stop(const char *args);
 void cmd_resume(const char *args);
+void cmd_kill(const char *args);
 
 // Memória
 void cmd_memtest(const char *args);
@@ -20,6 +26,7 @@ void cmd_poke(const char *args);
 void cmd_alloc(const char *args);
 void cmd_free(const char *args);
 void cmd_defrag(const char *args);
+void cmd_quota(const char *args);
 
 // Sistema de arquivos
 void cmd_ls(const char *args);
@@ -28,5 +35,10 @@ void cmd_rm(const char *args);
 void cmd_cat(const char *args);
 void cmd_write_file(const char *args);
 void cmd_edit(const char *args);
+void cmd_df(const char *args);
+void cmd_npuload(const char *args);
+void cmd_sync(const char *args);
+void cmd_mkdir(const char *args);
+void cmd_rmdir(const char *args);
 
 #endif
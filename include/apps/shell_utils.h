@@ -50,6 +50,19 @@ static inline void int_to_str(int val, char* buf) {
     }
 }
 
+// uint_to_str: Converte uint32_t para string decimal (buf >= 11 bytes)
+static inline void uint_to_str(uint32_t val, char* buf) {
+    char tmp[11];
+    int i = 0;
+    do {
+        tmp[i++] = (val % 10) + '0';
+        val /= 10;
+    } while (val > 0);
+    int j = 0;
+    while (i > 0) buf[j++] = tmp[--i];
+    buf[j] = 0;
+}
+
 // val_to_hex: Converte uint32_t para string hexadecimal (formato "0xHHHHHHHH")
 static inline void val_to_hex(uint32_t val, char* out_buf) {
     const char hex_chars[] = "0123456789ABCDEF";
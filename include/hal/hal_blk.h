@@ -0,0 +1,19 @@
+#ifndef HAL_BLK_H
+#define HAL_BLK_H
+
+#include <stdint.h>
+#include "kernel/blkdev.h"
+
+// ============================================================================
+// API DO DISCO PERSISTENTE
+// ============================================================================
+
+/**
+ * @brief Procura o disco da plataforma e o inicializa.
+ * No QEMU 'virt' é o virtio-blk (make run-disk): setores de 512 bytes,
+ * uma requisição por vez, com polling. Na FPGA não há disco.
+ * @return O dispositivo (estático, não liberar) ou NULL se não houver.
+ */
+blkdev_t *hal_blk_probe(void);
+
+#endif /* HAL_BLK_H */
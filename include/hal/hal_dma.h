@@ -42,4 +42,20 @@ int hal_dma_is_busy(void);
  */
 void hal_dma_memcpy(uint32_t src, uint32_t dst, uint32_t size_words, int fixed_dst);
 
+/**
+ * @brief Dispara uma cópia via DMA e retorna imediatamente (Non-blocking).
+ * Aguarda apenas uma transferência anterior terminar antes de programar esta.
+ * Use hal_dma_wait() antes de acessar os dados de destino.
+ * * @param src Endereço de origem (físico, alinhado em 4).
+ * @param dst Endereço de destino (físico, alinhado em 4).
+ * @param size_words Número de palavras de 32 bits.
+ * @param fixed_dst Se 1, não incrementa o endereço de destino.
+ */
+void hal_dma_start(uint32_t src, uint32_t dst, uint32_t size_words, int fixed_dst);
+
+/**
+ * @brief Bloqueia (Polling) até a transferência em andamento terminar.
+ */
+void hal_dma_wait(void);
+
 #endif // HAL_DMA_H
\ No newline at end of file
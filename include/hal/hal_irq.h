@@ -51,6 +51,24 @@ static inline void hal_irq_global_disable(void) {
     asm volatile ("csrc mstatus, %0" :: "r"(mie_bit));
 }
 
+/**
+ * @brief Desabilita Interrupções Globais e devolve o estado anterior.
+ * Uso: uint32_t f = hal_irq_save(); ...seção crítica...; hal_irq_restore(f);
+ * Funciona também dentro do trap_handler (onde MIE já está desligado).
+ */
+static inline uint32_t hal_irq_save(void) {
+    uint32_t mstatus;
+    asm volatile ("csrrci %0, mstatus, 8" : "=r"(mstatus) :: "memory");
+    return mstatus & (1 << 3);
+}
+
+/**
+ * @brief Restaura o MIE salvo por hal_irq_save().
+ */
+static inline void hal_irq_restore(uint32_t flags) {
+    asm volatile ("csrs mstatus, %0" :: "r"(flags) : "memory");
+}
+
 /**
  * @brief Habilita interrupções específicas (MIE).
  * @param mask Máscara de bits (ex: IRQ_M_TIMER | IRQ_M_SOFT).
@@ -70,6 +70,7 @@ void hal_npu_load_bias(const uint32_t *bias_buffer);
  * Carrega Pesos (Weights) na FIFO interna.
  * data: Buffer de dados (já empacotados em 32-bit: int8x4).
  * num_words: Quantidade de palavras de 32 bits a escrever.
+ * Com DMA habilitado, aloque 'data' com kmalloc_dma() (alinhado ao burst).
  */
 void hal_npu_load_weights(const uint32_t *data, uint32_t num_words);
 
@@ -77,6 +78,7 @@ void hal_npu_load_weights(const uint32_t *data, uint32_t num_words);
  * Carrega Entradas (Inputs/Activations) na FIFO interna.
  * data: Buffer de dados (já empacotados em 32-bit: int8x4).
  * num_words: Quantidade de palavras de 32 bits a escrever.
+ * Com DMA habilitado, aloque 'data' com kmalloc_dma() (alinhado ao burst).
  */
 void hal_npu_load_inputs(const uint32_t *data, uint32_t num_words);
 
@@ -0,0 +1,19 @@
+#ifndef HAL_SYS_H
+#define HAL_SYS_H
+
+#include <stdint.h>
+
+// ============================================================================
+// API DO SISTEMA (Desligar a máquina)
+// ============================================================================
+
+/**
+ * @brief Encerra a simulação com um código de saída.
+ * No QEMU 'virt' usa o dispositivo de teste (sifive_test): o processo
+ * qemu-system-riscv32 termina com 'code' (0 = sucesso). Na FPGA não há
+ * para onde sair: a CPU fica parada em WFI.
+ * @param code Código de saída (0-65535).
+ */
+void hal_sys_exit(uint32_t code) __attribute__((noreturn));
+
+#endif /* HAL_SYS_H */
@@ -0,0 +1,48 @@
+#ifndef BCACHE_H
+#define BCACHE_H
+
+#include <stdint.h>
+#include "kernel/blkdev.h"
+
+// ============================================================================
+// CACHE DE BLOCOS (LRU, write-back)
+// ============================================================================
+// BCACHE_SLOTS buffers de 'bsize' bytes (múltiplo do bloco do dispositivo)
+// na frente de um blkdev_t. Leitura: acerto não toca o dispositivo. Escrita:
+// só marca o buffer sujo; ele vai para o dispositivo quando é despejado
+// (o menos usado recentemente) ou no bcache_sync.
+//
+// O ponteiro de bcache_get vale enquanto menos de BCACHE_SLOTS outros blocos
+// forem pedidos (LRU: os mais recentes não são despejados).
+
+#ifndef BCACHE_SLOTS
+#define BCACHE_SLOTS 8
+#endif
+
+typedef struct {
+    uint32_t blk;       // Número do bloco (em unidades de bsize)
+    uint32_t stamp;     // Último uso (menor = mais antigo)
+    uint8_t  valid;
+    uint8_t  dirty;
+    uint8_t *data;
+} bcache_buf_t;
+
+typedef struct {
+    blkdev_t    *dev;
+    uint32_t     bsize;
+    uint32_t     shift;      // log2(bsize / dev->block_size)
+    uint32_t     clock;
+    bcache_buf_t buf[BCACHE_SLOTS];
+
+    // Estatísticas
+    uint32_t     hits;
+    uint32_t     misses;
+    uint32_t     writebacks;
+} bcache_t;
+
+int      bcache_init(bcache_t *c, blkdev_t *dev, uint32_t bsize); // 0; -1 sem RAM ou tamanho inválido
+void     bcache_free(bcache_t *c);                               // Descarta (não grava os sujos)
+uint8_t *bcache_get(bcache_t *c, uint32_t blk, int write);       // write = 1 marca sujo; NULL = erro de E/S
+int      bcache_sync(bcache_t *c);                               // Grava os sujos (sem flush)
+
+#endif /* BCACHE_H */
@@ -0,0 +1,33 @@
+#ifndef BLKDEV_H
+#define BLKDEV_H
+
+#include <stdint.h>
+
+// ============================================================================
+// DISPOSITIVO DE BLOCOS
+// ============================================================================
+// O "disco" visto pela RamFS: 'block_count' blocos de 'block_size' bytes
+// (potência de 2), lidos e gravados de 'count' em 'count'. Backends:
+//   - RAM (blkdev_ram_init): o disco volátil de sempre ou a imagem linkada;
+//   - virtio-blk no QEMU (hal_blk_probe): persiste num arquivo de imagem.
+// 'mem' != NULL = disco mapeado em memória: a RamFS usa os blocos no lugar,
+// sem cópia e sem cache. Senão tudo passa por read/write (e pelo bcache).
+
+typedef struct blkdev {
+    const char *name;
+    uint32_t    block_size;   // Bytes por bloco (potência de 2)
+    uint32_t    block_count;
+    uint8_t    *mem;          // Conteúdo mapeado (NULL = só por read/write)
+
+    // 0 = ok, -1 = erro de E/S
+    int (*read)(struct blkdev *dev, uint32_t blk, void *buf, uint32_t count);
+    int (*write)(struct blkdev *dev, uint32_t blk, const void *buf, uint32_t count);
+    int (*flush)(struct blkdev *dev);  // Opcional: esvazia o cache do dispositivo
+
+    void *priv;               // Estado do driver
+} blkdev_t;
+
+// Disco em RAM sobre 'mem' (mapeado; blocos de 512 bytes)
+void blkdev_ram_init(blkdev_t *dev, uint8_t *mem, uint32_t size);
+
+#endif /* BLKDEV_H */
@@ -0,0 +1,20 @@
+#ifndef BOOTLOG_H
+#define BOOTLOG_H
+
+#include <stdint.h>
+#include "sys/syscall.h"
+
+// Máximo de fases registradas (marcas extras são ignoradas)
+#define BOOTLOG_MAX 16
+
+// Registra o fim de uma fase do boot com hal_timer_get_cycles().
+// 'phase' deve ser uma string constante (guardamos só o ponteiro).
+void boot_mark(const char *phase);
+
+// Ciclos desde a primeira marca (início do kernel_main)
+uint64_t bootlog_elapsed(void);
+
+// Copia as marcas para 'buf' (SYS_BOOTLOG). Retorna quantas foram copiadas.
+int bootlog_get(bootlog_entry_t *buf, int max_count);
+
+#endif /* BOOTLOG_H */
@@ -2,14 +2,27 @@
 #define FS_H
 
 #include <stdint.h>
+#include "kernel/blkdev.h"
 
 // ============================================================================
 // CONFIGURAÇÕES DO SISTEMA DE ARQUIVOS (Mini-Ext2)
 // ============================================================================
 
+// Os limites podem ser trocados com -D (ex.: o benchmark do host monta um
+// disco com 1024 inodes).
+#ifndef FS_BLOCK_SIZE
 #define FS_BLOCK_SIZE      256   // Blocos pequenos (256 bytes) para economizar RAM
+#endif
+#ifndef FS_MAX_INODES
 #define FS_MAX_INODES      32    // Máximo de 32 arquivos
+#endif
+#ifndef FS_MAX_BLOCKS
 #define FS_MAX_BLOCKS      128   // Máximo de 128 blocos de dados (32KB total)
+#endif
+#ifndef FS_COMMIT_BATCH
+#define FS_COMMIT_BATCH    8     // fs_write por commit de metadados (disco com cache)
+#endif
+#define FS_INLINE_EXTENTS  3     // Extents guardados no próprio inode
 #define FS_MAGIC           0xEF53 // Assinatura mágica (Ext2 signature)
 
 // ============================================================================
@@ -18,15 +31,31 @@
 
 // 1. O INODE (Index Node)
 // Guarda TUDO sobre o arquivo, MENOS o nome.
+//
+// Mapeamento dos blocos: primeiro os extents (trechos contíguos
+// início+tamanho), na ordem do arquivo; quando os FS_INLINE_EXTENTS acabam,
+// os blocos seguintes vão um a um para o bloco indireto (uma tabela de
+// FS_INDIRECT_PTRS números de bloco). Num disco pouco fragmentado o arquivo
+// inteiro cabe em um extent e é lido/escrito com uma cópia (um DMA) só.
+#define FS_NO_BLOCK        0xFFFF
+#define FS_INDIRECT_PTRS   (FS_BLOCK_SIZE / sizeof(uint16_t))
+
+typedef struct {
+    uint16_t start;      // Primeiro bloco do trecho
+    uint16_t len;        // Blocos no trecho (0 = extent sem uso)
+} fs_extent_t;
+
+#define FS_TYPE_FILE       1
+#define FS_TYPE_DIR        2
+
 typedef struct {
     uint32_t size;       // Tamanho do arquivo em bytes
-    uint16_t type;       // 0 = Livre, 1 = Arquivo, 2 = Diretório
-    uint16_t blocks_cnt; // Quantos blocos esse arquivo usa
-    
-    // Ponteiros diretos para os blocos de dados.
-    // Simples: Suporta arquivos de até 6 * 256 = 1.5KB
-    // (Para arquivos maiores, precisaríamos de blocos indiretos)
-    uint16_t blocks[6];  
+    uint16_t type;       // FS_TYPE_* (0 = Livre)
+    uint16_t blocks_cnt; // Quantos blocos de dados esse arquivo usa (sem o indireto)
+
+    fs_extent_t extents[FS_INLINE_EXTENTS];
+    uint16_t indirect;   // Bloco com a tabela indireta (FS_NO_BLOCK = nenhum)
+    uint16_t reserved;
 } inode_t;
 
 // 2. O DIRETÓRIO (Directory Entry)
@@ -38,29 +67,124 @@ typedef struct {
     char     name[FS_MAX_NAME]; // O nome "humano" do arquivo
 } dirent_t;
 
+#define FS_DIRENTS_PER_BLOCK (FS_BLOCK_SIZE / sizeof(dirent_t))
+
 // 3. O SUPERBLOCO
-// O cabeçalho geral da partição.
+// O cabeçalho geral da partição, sozinho no primeiro setor. Os bitmaps e
+// os inodes vêm em duas cópias: 'active' é a do último commit.
 typedef struct {
     uint16_t magic;          // Assinatura (0xEF53)
     uint16_t inode_count;    // Total de inodes (32)
     uint16_t block_count;    // Total de blocos (128)
     uint16_t free_inodes;    // Inodes livres
     uint16_t free_blocks;    // Blocos livres
+    uint16_t active;         // Cópia dos metadados em uso (0 ou 1)
+    uint32_t generation;     // Número do último commit
 } superblock_t;
 
+// Resultado do fs_statfs (também é o formato do SYS_FS_STATFS)
+typedef struct {
+    uint32_t block_size;
+    uint32_t total_blocks;
+    uint32_t free_blocks;
+    uint32_t total_inodes;
+    uint32_t free_inodes;
+} fs_statfs_t;
+
 // ============================================================================
 // API DO KERNEL
 // ============================================================================
 
-void fs_init(void);
+void fs_init(void);   // Disco virtio, imagem linkada (make FS_DIR=...) ou RAM formatada
 void fs_format(void); // Zera tudo e cria o sistema limpo
 
-// Operações de Arquivo
-int fs_create(const char *name);
+// Monta no lugar um disco já formatado (mesma geometria, alinhado em
+// KMALLOC_DMA_ALIGN). 0 = ok, -1 = imagem inválida (nada muda).
+int fs_mount(uint8_t *image, uint32_t size);
+
+// Mesmo, para qualquer dispositivo de blocos (kernel/blkdev.h). Não mapeado
+// = metadados lidos para a RAM e dados pelo cache de blocos. 0 = ok; -1 não
+// tem RamFS (sem FS_MAGIC), -2 erro de leitura/sem RAM/dispositivo não
+// serve, -3 RamFS de outra geometria ou metadados inconsistentes.
+int fs_mount_dev(blkdev_t *dev);
+int fs_format_dev(blkdev_t *dev); // Formata e grava no dispositivo
+
+// Grava os blocos sujos e os metadados no dispositivo (0 = ok, -1 = erro).
+// Os bitmaps e os inodes vão para a cópia inativa e só então o superbloco
+// (um setor) passa a apontar para ela: uma queda no meio deixa o commit
+// anterior inteiro. No disco mapeado não há o que gravar. Também acontece sozinho a cada FS_COMMIT_BATCH fs_write e quando
+// só os blocos liberados desde o último commit dariam conta de uma alocação.
+int fs_sync(void);
+
+// O disco inteiro, como está (o mkfs do host grava isso como imagem).
+// Só para disco mapeado: NULL e *size = 0 com cache.
+const uint8_t *fs_disk(uint32_t *size);
+
+// Com o disco atrás do cache, as operações abaixo também podem retornar -7:
+// erro de E/S no dispositivo (o conteúdo do arquivo não muda).
+
+// Operações de Arquivo (por caminho: resolvem o caminho a cada chamada).
+// Caminhos partem sempre do Root ("models/net1/w0" == "/models/net1/w0");
+// cada componente tem até FS_MAX_NAME-1 caracteres e não pode ser "." ou "..".
+int fs_create(const char *name); // 0; -1 existe, -2 sem inodes, -3 diretório cheio,
+                                 // -4 nome inválido, -6 diretório pai não existe
+// fs_write troca o conteúdo inteiro por cópia na escrita (blocos novos,
+// depois a troca do inode): bytes escritos; -1 não existe, -2 maior que o
+// disco, -3 mapeado, -4 disco cheio (o conteúdo antigo fica intacto).
 int fs_write(const char *name, const uint8_t *data, uint32_t len);
 int fs_read(const char *name, uint8_t *buffer, uint32_t max_len);
-int fs_delete(const char *name);
-int fs_list(char *buffer, uint32_t max_len);
+int fs_delete(const char *name); // 0; -1 não existe, -2 é diretório, -3 aberto/mapeado
+int fs_statfs(fs_statfs_t *st);
+
+// Diretórios
+int fs_mkdir(const char *path);  // Mesmos códigos do fs_create
+int fs_rmdir(const char *path);  // 0; -1 não existe/não é diretório, -2 não vazio, -3 aberto
+
+// Descritores de arquivo (offset por descritor; nome resolvido só no open)
+#define FS_MAX_FD      8
+
+#define FS_O_READ      0x01
+#define FS_O_WRITE     0x02
+#define FS_O_CREATE    0x04   // Cria se não existe
+#define FS_O_TRUNC     0x08   // Zera o arquivo no open (com FS_O_WRITE)
+#define FS_O_APPEND    0x10   // Toda escrita vai para o fim
+#define FS_O_DIR       0x20   // Descritor de diretório (só fs_opendir)
+
+#define FS_SEEK_SET    0
+#define FS_SEEK_CUR    1
+#define FS_SEEK_END    2
+
+int fs_open(const char *name, uint32_t flags); // fd >= 0; -1 não existe, -5 sem descritores
+int fs_close(int fd);
+int fs_fread(int fd, uint8_t *buffer, uint32_t len);
+int fs_fwrite(int fd, const uint8_t *data, uint32_t len); // No lugar (sem cópia na escrita)
+int fs_lseek(int fd, int32_t off, int whence); // Novo offset (0..tamanho) ou -1
+
+// Listagem de diretório em lotes: cada fs_readdir preenche até 'max'
+// registros a partir do cursor do descritor e o avança; 0 = acabou. O
+// registro já traz os metadados do inode (sem uma busca por nome a mais).
+// fs_lseek(fd, 0, FS_SEEK_SET) volta ao início; fs_close fecha.
+typedef struct {
+    uint16_t inode;
+    uint16_t type;            // FS_TYPE_*
+    uint32_t size;            // Bytes (diretório: 0)
+    uint16_t blocks;          // Blocos em uso, com o indireto
+    uint16_t reserved;
+    char     name[FS_MAX_NAME];
+} fs_dirent_t;                // Também é o formato do SYS_FS_READDIR
+
+int fs_opendir(const char *path);  // fd >= 0; NULL/"/" = Root; -1 não é diretório, -5 sem descritores
+int fs_readdir(int fd, fs_dirent_t *out, uint32_t max); // Registros lidos; -1 descritor inválido
+
+// Mapeamento direto (zero-copy): o disco já está na RAM, então o conteúdo
+// pode ser usado no lugar, sem cópia para um buffer. O arquivo é juntado num
+// único extent (uma cópia, só se estiver fragmentado) e o ponteiro aponta
+// para o primeiro bloco, alinhado em KMALLOC_DMA_ALIGN: serve direto para
+// hal_npu_load_weights/DMA. Enquanto mapeado o arquivo é somente leitura:
+// apagar, escrever ou abrir para escrita retorna -3.
+int fs_map(const char *name, const uint8_t **ptr, uint32_t *len); // 0; -1 não existe, -2 sem trecho contíguo,
+                                                                 // -3 aberto para escrita, -5 mapeamentos demais
+int fs_unmap(const uint8_t *ptr);
 
 // Debug
 void fs_debug(void);
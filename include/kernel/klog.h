@@ -0,0 +1,99 @@
+#ifndef KLOG_H
+#define KLOG_H
+
+#include <stdint.h>
+
+/* ============================================================================
+ * KLOG: LOG BINÁRIO COM FORMATAÇÃO ADIADA
+ * ============================================================================
+ *
+ * Quem loga grava só (ID do formato, nível, tarefa, tempo, até 3 argumentos)
+ * num ring buffer em RAM: poucos ciclos, sem UART e seguro dentro do
+ * trap_handler. A formatação acontece depois:
+ *   - na tarefa Logger (acorda periodicamente), que esvazia o ring e imprime;
+ *   - ou no host: com -DKLOG_RAW as strings nem entram na imagem, a Logger
+ *     imprime linhas "#K ..." em hexa e tools/klog_decode.py as traduz.
+ *
+ * Uso:  KLOG_INFO(SCHED_TASK_CREATED, tid, prio);
+ *
+ * Filtro em tempo de compilação: níveis abaixo de KLOG_LEVEL viram
+ * ((void)0) e somem do binário (os argumentos NÃO são avaliados, então
+ * não passe expressões com efeito colateral).
+ */
+
+#define KLOG_LEVEL_DEBUG  0
+#define KLOG_LEVEL_INFO   1
+#define KLOG_LEVEL_WARN   2
+#define KLOG_LEVEL_ERROR  3
+#define KLOG_LEVEL_NONE   4
+
+#ifndef KLOG_LEVEL
+#define KLOG_LEVEL KLOG_LEVEL_INFO
+#endif
+
+// Capacidade do ring (potência de 2, em registros de 20 bytes)
+#define KLOG_RING_SIZE  64
+
+// IDs dos formatos (ver klog_ids.h)
+enum {
+#define KLOG_FMT(id, fmt) KLOG_##id,
+#include "kernel/klog_ids.h"
+#undef KLOG_FMT
+    KLOG_ID_COUNT
+};
+
+// Tarefa "dona" dos registros gravados antes do escalonador existir
+#define KLOG_TID_KERNEL  0xFF
+
+typedef struct {
+    uint32_t hdr;       // [31:16] ID | [15:8] Nível | [7:0] TID
+    uint32_t time;      // hal_timer_get_cycles() (32 bits baixos)
+    uint32_t arg[3];
+} klog_record_t;
+
+#define KLOG_HDR_ID(h)     ((h) >> 16)
+#define KLOG_HDR_LEVEL(h)  (((h) >> 8) & 0xFF)
+#define KLOG_HDR_TID(h)    ((h) & 0xFF)
+
+// Grava um registro (não bloqueia; se o ring estiver cheio, descarta)
+void klog_write(uint32_t id_level, uint32_t a, uint32_t b, uint32_t c);
+
+// Consumidor único (Logger): retira o registro mais antigo. 0 = vazio.
+int klog_pop(klog_record_t *out);
+
+// Registros descartados por ring cheio desde a última chamada (e zera)
+uint32_t klog_take_dropped(void);
+
+// Formata um registro como linha de texto terminada em '\n'
+void klog_format(const klog_record_t *rec, char *buf, uint32_t size);
+
+// --- Macros de chamada -------------------------------------------------------
+
+#define KLOG_EMIT_(lvl, id, a, b, c, ...) \
+    klog_write(((uint32_t)(KLOG_##id) << 16) | ((lvl) << 8), (uint32_t)(a), (uint32_t)(b), (uint32_t)(c))
+
+#if KLOG_LEVEL <= KLOG_LEVEL_DEBUG
+#define KLOG_DEBUG(id, ...) KLOG_EMIT_(KLOG_LEVEL_DEBUG, id, ##__VA_ARGS__, 0, 0, 0)
+#else
+#define KLOG_DEBUG(id, ...) ((void)0)
+#endif
+
+#if KLOG_LEVEL <= KLOG_LEVEL_INFO
+#define KLOG_INFO(id, ...)  KLOG_EMIT_(KLOG_LEVEL_INFO, id, ##__VA_ARGS__, 0, 0, 0)
+#else
+#define KLOG_INFO(id, ...)  ((void)0)
+#endif
+
+#if KLOG_LEVEL <= KLOG_LEVEL_WARN
+#define KLOG_WARN(id, ...)  KLOG_EMIT_(KLOG_LEVEL_WARN, id, ##__VA_ARGS__, 0, 0, 0)
+#else
+#define KLOG_WARN(id, ...)  ((void)0)
+#endif
+
+#if KLOG_LEVEL <= KLOG_LEVEL_ERROR
+#define KLOG_ERROR(id, ...) KLOG_EMIT_(KLOG_LEVEL_ERROR, id, ##__VA_ARGS__, 0, 0, 0)
+#else
+#define KLOG_ERROR(id, ...) ((void)0)
+#endif
+
+#endif /* KLOG_H */
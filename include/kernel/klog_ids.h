@@ -0,0 +1,29 @@
+// ============================================================================
+// TABELA DE MENSAGENS DO KLOG (X-Macro)
+// ============================================================================
+//
+//  KLOG_FMT(ID, "formato")  ->  gera KLOG_<ID> (enum) e a string de formato.
+//
+//  Formatos aceitos: %u, %d, %x (argumentos de 32 bits, no máximo 3) e %%.
+//  A posição na lista É o ID gravado no log: para não quebrar logs antigos
+//  no decodificador do host (tools/klog_decode.py), adicione sempre no fim.
+//
+//  Sem include guard de propósito: incluído várias vezes com KLOG_FMT
+//  definido de formas diferentes.
+//
+// ============================================================================
+
+// Escalonador
+KLOG_FMT(SCHED_INIT,          "[ SCHED ] Scheduler initialized")
+KLOG_FMT(SCHED_TASK_CREATED,  "[ SCHED ] Created task %u (prio %u)")
+KLOG_FMT(SCHED_MAX_TASKS,     "[ SCHED ] Error: Max tasks reached")
+KLOG_FMT(SCHED_TASK_KILLED,   "[ SCHED ] Task %u killed, %u heap bytes reclaimed")
+
+// Gerenciador de memória
+KLOG_FMT(MM_QUOTA_EXCEEDED,   "[ MM    ] Task %u heap quota exceeded (%u used, %u requested)")
+KLOG_FMT(MM_BAD_BOUNDS,       "[ MM    ] Error: Pointer %x out of heap bounds")
+KLOG_FMT(MM_BAD_ALIGN,        "[ MM    ] Error: Invalid pointer alignment (%x)")
+KLOG_FMT(MM_BAD_CANARY,       "[ MM    ] Error: Block corruption detected at %x (bad canary)")
+KLOG_FMT(MM_DOUBLE_FREE,      "[ MM    ] Error: Double free detected (%x)")
+KLOG_FMT(MM_REALLOC_OWNER,    "[ MM    ] Error: Task %u tried to realloc block %x of task %u")
+KLOG_FMT(MM_DEFRAG,           "[ MM    ] Defrag: merged %u blocks")
@@ -0,0 +1,48 @@
+#ifndef KMEM_H
+#define KMEM_H
+
+#include <stdint.h>
+
+/* ============================================================================
+ * CÓPIAS GRANDES DO KERNEL (CPU ou DMA)
+ * ============================================================================
+ *
+ * kmemcpy/kmemset decidem pelo tamanho: abaixo do limiar usam a CPU
+ * (memcpy/memset de util/string.h), acima dele o miolo alinhado vai para
+ * o controlador de DMA e a CPU cuida só das pontas desalinhadas.
+ *
+ * No QEMU o "DMA" é um stub em software, então o padrão é nunca usá-lo.
+ * O limiar pode ser fixado na compilação (-DKMEM_DMA_THRESHOLD=N) ou
+ * ajustado em tempo de execução (o 'bench dma' mede e aplica o crossover).
+ *
+ * O canal de DMA é único e compartilhado com a NPU (hal_dma_memcpy).
+ */
+
+// Valor de limiar que desliga o DMA (tudo pela CPU)
+#define KMEM_DMA_OFF  0xFFFFFFFFu
+
+#ifndef KMEM_DMA_THRESHOLD
+#ifdef PLATFORM_FPGA
+#define KMEM_DMA_THRESHOLD  1024
+#else
+#define KMEM_DMA_THRESHOLD  KMEM_DMA_OFF
+#endif
+#endif
+
+// Limiar em bytes: cópias com n >= limiar vão para o DMA
+void kmem_set_dma_threshold(uint32_t bytes);
+uint32_t kmem_get_dma_threshold(void);
+
+// Dispara a cópia e retorna sem esperar o DMA terminar.
+// 'dst' só pode ser lido (e 'src' alterado) depois de kmem_wait().
+// As regiões não podem se sobrepor.
+void kmemcpy_async(void *dst, const void *src, uint32_t n);
+
+// Aguarda a última kmemcpy_async terminar
+void kmem_wait(void);
+
+// Versões síncronas (retornam com a operação concluída)
+void kmemcpy(void *dst, const void *src, uint32_t n);
+void kmemset(void *dst, uint8_t c, uint32_t n);
+
+#endif /* KMEM_H */
@@ -15,9 +15,10 @@
 // ============================================================================
 //  FUNÇÕES AUXILIARES DE LOG
 // ============================================================================
+// Saída síncrona na UART (boot e pânico). Fora disso use o KLOG (klog.h),
+// que grava em RAM e deixa a formatação para a tarefa Logger.
 
 void log_info(const char* msg);
-void log_sched(const char* msg);
 void log_ok(const char* msg);
 void log_warn(const char* msg);
 void print_hex(unsigned int val);
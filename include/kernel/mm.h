@@ -4,17 +4,59 @@
 #include <stddef.h>
 #include <stdint.h>
 
+// Dono dos blocos alocados pelo próprio Kernel (RamFS, buffers internos...)
+#define MM_OWNER_KERNEL     0xFFFF
+
+// Valor de quota que significa "sem limite"
+#define MM_QUOTA_UNLIMITED  0
+
+// Alinhamento (e granularidade) dos buffers do Pool de DMA, em bytes.
+// Um burst do DMA nunca é compartilhado entre dois buffers.
+#define KMALLOC_DMA_ALIGN   32
+
 // Inicializa o Heap a partir do endereço 'start_addr' com tamanho 'size'
 void kmalloc_init(void* start_addr, uint32_t size);
 
+// Inicializa o Pool de DMA (região '_dma_start'.. '_dma_end' do linker script)
+void kmalloc_dma_init(void* start_addr, uint32_t size);
+
 // Aloca 'size' bytes. Retorna NULL se não houver espaço.
 void* kmalloc(uint32_t size);
 
+// Aloca 'size' bytes com a área de dados alinhada em 'align' (potência de 2).
+// Liberar com kfree().
+void* kmalloc_aligned(uint32_t size, uint32_t align);
+
+// Aloca um buffer DMA-safe no Pool de DMA (alinhado em KMALLOC_DMA_ALIGN).
+// Indicado para pesos/ativações da NPU. Liberar com kfree().
+void* kmalloc_dma(uint32_t size);
+
+// Aloca 'size' bytes em nome da tarefa 'tid' (SYS_MALLOC).
+// Retorna NULL se não houver espaço ou se a quota da tarefa estourar.
+void* kmalloc_task(uint32_t size, uint32_t tid);
+
+// Redimensiona o bloco 'ptr' para 'size' bytes preservando o conteúdo.
+// Cresce/encolhe no lugar quando possível; senão move o bloco.
+// Retorna o novo ponteiro ou NULL (o bloco original continua válido).
+void* krealloc(void* ptr, uint32_t size);
+
+// Versão de krealloc para tarefas (SYS_REALLOC): só aceita blocos da tarefa 'tid'.
+void* krealloc_task(void* ptr, uint32_t size, uint32_t tid);
+
 // Libera a memória apontada por 'ptr'.
 uint8_t kfree(void* ptr);
 
 // Retorna o total de bytes livres (para diagnóstico)
 uint32_t kget_free_memory(void);
+uint32_t kget_free_dma_memory(void);
+
+// Quotas e contabilidade por tarefa (bytes de dados alocados)
+void     kheap_set_quota(uint32_t tid, uint32_t bytes);
+uint32_t kheap_get_quota(uint32_t tid);
+uint32_t kheap_task_usage(uint32_t tid);
+
+// Libera todos os blocos pertencentes à tarefa 'tid'. Retorna os bytes recuperados.
+uint32_t kheap_reclaim(uint32_t tid);
 
 // Realiza a desfragmentação do heap, fundindo blocos livres adjacentes
 void kheap_defrag(void);
@@ -0,0 +1,36 @@
+#ifndef PROF_H
+#define PROF_H
+
+#include <stdint.h>
+#include "sys/syscall.h"
+
+/* ============================================================================
+ * PROF: PROFILER ESTATÍSTICO POR AMOSTRAGEM DE PC
+ * ============================================================================
+ *
+ * Enquanto ativo, o timer da CPU dispara a PROF_HZ em vez de 10 Hz e cada
+ * interrupção anota (mepc, tid) num histograma. O escalonador continua
+ * rodando a cada TICK_DELTA_CYCLES (o trap_handler acumula os períodos).
+ *
+ * O 'prof dump' lista as amostras e tools/prof_report.py as associa às
+ * funções do ELF (nm/addr2line), gerando um perfil plano.
+ */
+
+// Frequência de amostragem
+#ifndef PROF_HZ
+#define PROF_HZ  1000
+#endif
+
+// Entradas distintas (pc, tid) no histograma (potência de 2)
+#ifndef PROF_SLOTS
+#define PROF_SLOTS  512
+#endif
+
+// Chamado no timer (trap_handler). Retorna o período da próxima amostra em
+// ciclos, ou 0 se o profiler está parado (timer volta ao tick normal).
+uint32_t prof_sample(uint32_t pc, uint32_t tid);
+
+// SYS_PROF: start/stop/status/read (ver PROF_OP_* em syscall.h)
+int prof_ctl(uint32_t op, uint32_t arg, prof_entry_t *buf, uint32_t max);
+
+#endif /* PROF_H */
@@ -2,6 +2,7 @@
 #define TASK_H
 
 #include <stdint.h>
+#include "kernel/mutex.h"
 
 // ============================================================================
 //  CONFIGURAÇÕES DO SISTEMA
@@ -14,7 +15,7 @@
 
 // Número máximo de tarefas simultâneas.
 // Usamos alocação estática (array fixo) para simplificar e evitar fragmentação.
-#define MAX_TASKS  4
+#define MAX_TASKS  5
 
 // ============================================================================
 //  ESTADOS DA TAREFA
@@ -24,7 +25,8 @@ typedef enum {
     TASK_READY,      // Pronta para rodar (está na fila aguardando a CPU)
     TASK_RUNNING,    // Está rodando neste exato momento (posse da CPU)
     TASK_BLOCKED,    // Dormindo (Sleep) ou esperando recurso (Mutex/IO)
-    TASK_SUSPENDED   // Pausado, mas existe
+    TASK_SUSPENDED,  // Pausado, mas existe
+    TASK_DEAD        // Encerrada (recursos devolvidos, nunca mais roda)
 } task_state_t;
 
 // ============================================================================
@@ -142,4 +144,9 @@ int task_create(void (*function)(void), const char* name, uint32_t priority);
 // O algoritmo de decisão: escolhe quem é o próximo 'next_task'
 void schedule(void);
 
+// Mutex pelo kernel (SYS_LOCK/SYS_UNLOCK). O escalonador guarda quais
+// estão trancados para destrancar os de uma tarefa morta (scheduler_kill).
+int  scheduler_mutex_lock(mutex_t *m);   // 1 = pegou, 0 = ocupado
+void scheduler_mutex_unlock(mutex_t *m); // Só o dono destranca
+
 #endif
\ No newline at end of file
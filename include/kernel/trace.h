@@ -0,0 +1,76 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "sys/syscall.h"
+
+/* ============================================================================
+ * TRACE: LINHA DO TEMPO DE EVENTOS DO KERNEL
+ * ============================================================================
+ *
+ * Grava eventos com timestamp (troca de contexto, entrada/saída de IRQ,
+ * syscalls, espera em mutex) num buffer circular em RAM. Quando enche,
+ * os eventos mais antigos são sobrescritos (gravador de voo): o 'trace dump'
+ * sempre mostra o passado recente.
+ *
+ * Todos os pontos de trace rodam dentro do trap_handler (MIE desligado),
+ * então a escrita no buffer não precisa de trava.
+ *
+ * Só existe com -DCONFIG_TRACE (make TRACE=1). Sem ele, as macros viram
+ * ((void)0) e trace.c fica vazio: custo zero no binário.
+ *
+ * O dump sai em binário pela UART ('trace dump') e tools/trace2chrome.py
+ * converte para o formato JSON do Chrome (chrome://tracing / Perfetto).
+ */
+
+// Capacidade do buffer (potência de 2, registros de 8 bytes)
+#ifndef TRACE_BUF_SIZE
+#define TRACE_BUF_SIZE  256
+#endif
+
+// Tipos de evento (trace_record_t.type). Mantenha em sincronia com
+// tools/trace2chrome.py.
+#define TRACE_EV_SWITCH         1   // tid = sai, arg = entra
+#define TRACE_EV_IRQ_ENTER      2   // arg = fonte do PLIC (0 = timer)
+#define TRACE_EV_IRQ_EXIT       3
+#define TRACE_EV_SYSCALL_ENTER  4   // arg = número da syscall
+#define TRACE_EV_SYSCALL_EXIT   5
+#define TRACE_EV_MUTEX_BLOCK    6   // arg = 16 bits baixos do endereço do mutex
+#define TRACE_EV_MUTEX_UNBLOCK  7
+
+// Fonte usada para o timer da CPU (o PLIC não usa a fonte 0)
+#define TRACE_IRQ_TIMER  0
+
+#ifdef CONFIG_TRACE
+
+// Grava um evento em nome da tarefa atual
+void trace_event(uint8_t type, uint16_t arg);
+
+// Troca de contexto: current_task -> 'to'
+void trace_switch(uint32_t to_tid);
+
+// Resultado do SYS_LOCK: registra só o início e o fim da espera
+void trace_mutex(const void *m, int acquired);
+
+// SYS_TRACE: start/stop/clear/status/read (ver TRACE_OP_* em syscall.h)
+int trace_ctl(uint32_t op, uint32_t arg, trace_record_t *buf, uint32_t max);
+
+#define TRACE_SWITCH(to)           trace_switch(to)
+#define TRACE_IRQ_ENTER(src)       trace_event(TRACE_EV_IRQ_ENTER, (src))
+#define TRACE_IRQ_EXIT(src)        trace_event(TRACE_EV_IRQ_EXIT, (src))
+#define TRACE_SYSCALL_ENTER(num)   trace_event(TRACE_EV_SYSCALL_ENTER, (num))
+#define TRACE_SYSCALL_EXIT(num)    trace_event(TRACE_EV_SYSCALL_EXIT, (num))
+#define TRACE_MUTEX(m, acquired)   trace_mutex((m), (acquired))
+
+#else
+
+#define TRACE_SWITCH(to)           ((void)0)
+#define TRACE_IRQ_ENTER(src)       ((void)0)
+#define TRACE_IRQ_EXIT(src)        ((void)0)
+#define TRACE_SYSCALL_ENTER(num)   ((void)0)
+#define TRACE_SYSCALL_EXIT(num)    ((void)0)
+#define TRACE_MUTEX(m, acquired)   ((void)0)
+
+#endif /* CONFIG_TRACE */
+
+#endif /* TRACE_H */
@@ -28,9 +28,28 @@
 #define SYS_FS_CREATE   15  // Criar arquivo no sistema de arquivos
 #define SYS_FS_WRITE    16  // Escrever arquivo no sistema de arquivos
 #define SYS_FS_READ     17  // Ler arquivo do sistema de arquivos
-#define SYS_FS_LIST     18  // Listar arquivos no sistema de arquivos
+//                      18: livre (era SYS_FS_LIST, texto; ver SYS_FS_READDIR)
 #define SYS_FS_DELETE   19  // Deletar arquivo do sistema de arquivos
 #define SYS_FS_FORMAT   20  // Formatar sistema de arquivos
+#define SYS_KILL        21  // Encerrar processo (devolve o heap dele)
+#define SYS_HEAP_QUOTA  22  // Definir quota de heap de um processo
+#define SYS_REALLOC     23  // Redimensionar bloco alocado (krealloc)
+#define SYS_BOOTLOG     24  // Marcas de tempo das fases do boot
+#define SYS_TRACE       25  // Controle/leitura do trace de eventos (CONFIG_TRACE)
+#define SYS_PROF        26  // Profiler por amostragem de PC
+#define SYS_FS_STATFS   27  // Uso do sistema de arquivos (fs_statfs_t)
+#define SYS_FS_OPEN     28  // Abrir arquivo (nome, FS_O_*) -> fd
+#define SYS_FS_CLOSE    29  // Fechar descritor
+#define SYS_FS_FREAD    30  // Ler do descritor (a partir do offset)
+#define SYS_FS_FWRITE   31  // Escrever no descritor (a partir do offset)
+#define SYS_FS_LSEEK    32  // Mover o offset do descritor
+#define SYS_FS_MAP      33  // Mapear arquivo (ponteiro direto, somente leitura)
+#define SYS_FS_UNMAP    34  // Desfazer o mapeamento
+#define SYS_FS_SYNC     35  // Gravar o cache de blocos e os metadados no disco
+#define SYS_FS_MKDIR    36  // Criar diretório
+#define SYS_FS_RMDIR    37  // Remover diretório vazio
+#define SYS_FS_OPENDIR  38  // Abrir diretório para listagem -> fd
+#define SYS_FS_READDIR  39  // Próximo lote de fs_dirent_t do diretório
 
 // ==========================================================================================================
 // Informações do Processo
@@ -44,9 +63,64 @@ typedef struct {
     uint32_t priority;   // Prioridade
     uint32_t sp;         // Stack Pointer atual
     uint64_t wake_time;  // Ciclo de clock para acordar
+    uint32_t heap_used;  // Bytes de heap alocados via SYS_MALLOC
+    uint32_t heap_quota; // Quota de heap (0 = sem limite)
 
 } task_info_t;
 
+// ==========================================================================================================
+// Log de Boot
+// ==========================================================================================================
+
+typedef struct {
+
+    char name[12];       // Fase do boot ("heap", "fs", ...)
+    uint64_t cycles;     // hal_timer_get_cycles() ao fim da fase
+
+} bootlog_entry_t;
+
+// ==========================================================================================================
+// Trace de Eventos (CONFIG_TRACE)
+// ==========================================================================================================
+
+typedef struct {
+
+    uint32_t time;       // hal_timer_get_cycles() (32 bits baixos)
+    uint8_t  type;       // TRACE_EV_* (kernel/trace.h)
+    uint8_t  tid;        // Tarefa que estava na CPU
+    uint16_t arg;        // Depende do tipo (tid destino, fonte de IRQ, syscall...)
+
+} trace_record_t;
+
+// Operações do SYS_TRACE (a0)
+#define TRACE_OP_START   0  // Liga a gravação
+#define TRACE_OP_STOP    1  // Desliga a gravação (o buffer fica intacto)
+#define TRACE_OP_CLEAR   2  // Esvazia o buffer
+#define TRACE_OP_COUNT   3  // Retorna quantos eventos estão no buffer
+#define TRACE_OP_LOST    4  // Retorna quantos foram sobrescritos
+#define TRACE_OP_READ    5  // Copia 'max' eventos a partir do índice a1 (0 = mais antigo)
+#define TRACE_OP_RUNNING 6  // Retorna 1 se está gravando
+
+// ==========================================================================================================
+// Profiler por Amostragem
+// ==========================================================================================================
+
+typedef struct {
+
+    uint32_t pc;         // mepc no momento da amostra
+    uint32_t tid;        // Tarefa interrompida
+    uint32_t count;      // Amostras neste (pc, tid)
+
+} prof_entry_t;
+
+// Operações do SYS_PROF (a0)
+#define PROF_OP_START    0  // Zera o histograma e começa a amostrar
+#define PROF_OP_STOP     1  // Para de amostrar (o histograma fica)
+#define PROF_OP_TOTAL    2  // Retorna o total de amostras
+#define PROF_OP_LOST     3  // Retorna amostras perdidas (histograma cheio)
+#define PROF_OP_RUNNING  4  // Retorna 1 se está amostrando
+#define PROF_OP_READ     5  // Copia 'max' entradas a partir da a1-ésima
+
 // ==========================================================================================================
 //  API DO USUÁRIO (User-Mode Wrappers)
 // ==========================================================================================================
@@ -250,19 +324,56 @@ static inline void sys_heap_info(void) {
 
 // Pausa processo pelo PID
 static inline int sys_suspend(uint32_t pid) {
-    int ret; asm volatile ("mv a0, %1; li a7, %2; ecall; mv %0, a0" : "=r"(ret) : "r"(pid), "i"(SYS_SUSPEND) : "a0", "a7"); return ret;
+    int ret; asm volatile ("mv a0, %1; li a7, %2; ecall; mv %0, a0" : "=r"(ret) : "r"(pid), "i"(SYS_SUSPEND) : "a0", "a7", "memory"); return ret;
 }
 
 // Retoma processo pelo PID
 static inline int sys_resume(uint32_t pid) {
-    int ret; asm volatile ("mv a0, %1; li a7, %2; ecall; mv %0, a0" : "=r"(ret) : "r"(pid), "i"(SYS_RESUME) : "a0", "a7"); return ret;
+    int ret; asm volatile ("mv a0, %1; li a7, %2; ecall; mv %0, a0" : "=r"(ret) : "r"(pid), "i"(SYS_RESUME) : "a0", "a7", "memory"); return ret;
+}
+
+// Encerra processo pelo PID (o heap dele é recuperado pelo Kernel)
+static inline int sys_kill(uint32_t pid) {
+    int ret; asm volatile ("mv a0, %1; li a7, %2; ecall; mv %0, a0" : "=r"(ret) : "r"(pid), "i"(SYS_KILL) : "a0", "a7", "memory"); return ret;
+}
+
+// Define a quota de heap (em bytes) de um processo. 0 = sem limite.
+static inline int sys_heap_quota(uint32_t pid, uint32_t bytes) {
+    int ret;
+    asm volatile (
+        "mv a0, %1\n"
+        "mv a1, %2\n"
+        "li a7, %3\n"
+        "ecall\n"
+        "mv %0, a0"
+        : "=r"(ret)
+        : "r"(pid), "r"(bytes), "i"(SYS_HEAP_QUOTA)
+        : "a0", "a1", "a7", "memory"
+    );
+    return ret;
 }
 
 // Aloca memória no Heap do Kernel
 static inline void* sys_malloc(uint32_t size) {
-    void* ret; asm volatile ("mv a0, %1; li a7, %2; ecall; mv %0, a0" : "=r"(ret) : "r"(size), "i"(SYS_MALLOC) : "a0", "a7"); return ret;
+    void* ret; asm volatile ("mv a0, %1; li a7, %2; ecall; mv %0, a0" : "=r"(ret) : "r"(size), "i"(SYS_MALLOC) : "a0", "a7", "memory"); return ret;
 }
 
+// Redimensiona um bloco alocado com sys_malloc (cresce no lugar se possível).
+// Retorna o novo endereço ou NULL (o bloco antigo continua válido).
+static inline void* sys_realloc(void* ptr, uint32_t size) {
+    void* ret;
+    asm volatile (
+        "mv a0, %1\n"
+        "mv a1, %2\n"
+        "li a7, %3\n"
+        "ecall\n"
+        "mv %0, a0"
+        : "=r"(ret)
+        : "r"(ptr), "r"(size), "i"(SYS_REALLOC)
+        : "a0", "a1", "a7", "memory"
+    );
+    return ret;
+}
 
 // Libera memória alocada no Heap do Kernel
 static inline uint8_t sys_free(void* ptr) {
@@ -279,6 +390,58 @@ static inline uint8_t sys_free(void* ptr) {
     return res;
 }
 
+// Copia as marcas de tempo do boot. Retorna a quantidade copiada.
+static inline int sys_bootlog(bootlog_entry_t *buffer, int max_count) {
+    int ret;
+    asm volatile (
+        "mv a0, %1\n"
+        "mv a1, %2\n"
+        "li a7, %3\n"
+        "ecall\n"
+        "mv %0, a0"
+        : "=r"(ret)
+        : "r"(buffer), "r"(max_count), "i"(SYS_BOOTLOG)
+        : "a0", "a1", "a7", "memory"
+    );
+    return ret;
+}
+
+// Controle do trace de eventos. Retorna -1 se o kernel não tem CONFIG_TRACE.
+static inline int sys_trace(uint32_t op, uint32_t arg, trace_record_t *buffer, uint32_t max) {
+    int ret;
+    asm volatile (
+        "mv a0, %1\n"
+        "mv a1, %2\n"
+        "mv a2, %3\n"
+        "mv a3, %4\n"
+        "li a7, %5\n"
+        "ecall\n"
+        "mv %0, a0"
+        : "=r"(ret)
+        : "r"(op), "r"(arg), "r"(buffer), "r"(max), "i"(SYS_TRACE)
+        : "a0", "a1", "a2", "a3", "a7", "memory"
+    );
+    return ret;
+}
+
+// Controle do profiler. Retorna -1 para operação inválida.
+static inline int sys_prof(uint32_t op, uint32_t arg, prof_entry_t *buffer, uint32_t max) {
+    int ret;
+    asm volatile (
+        "mv a0, %1\n"
+        "mv a1, %2\n"
+        "mv a2, %3\n"
+        "mv a3, %4\n"
+        "li a7, %5\n"
+        "ecall\n"
+        "mv %0, a0"
+        : "=r"(ret)
+        : "r"(op), "r"(arg), "r"(buffer), "r"(max), "i"(SYS_PROF)
+        : "a0", "a1", "a2", "a3", "a7", "memory"
+    );
+    return ret;
+}
+
 // Desfragmenta o heap do Kernel
 static inline void sys_defrag(void) {
     asm volatile (
@@ -17,5 +17,37 @@ int32_t  __modsi3(int32_t a, int32_t b);
 
 // Operações de 64 bits
 int64_t  __muldi3(int64_t a, int64_t b);
+uint64_t __udivdi3(uint64_t n, uint64_t d);
+uint64_t __umoddi3(uint64_t n, uint64_t d);
+int64_t  __divdi3(int64_t a, int64_t b);
+int64_t  __moddi3(int64_t a, int64_t b);
 
-#endif /* MATH_OPS_H */
\ No newline at end of file
+/* ----------------------------------------------------------------------------
+ * Contagem de zeros (sem __builtin_clz: no RV32I ele vira chamada a __clzsi2)
+ * ----------------------------------------------------------------------------
+ */
+
+// Zeros à esquerda (clz(0) = 32). Busca binária: 5 passos fixos.
+static inline uint32_t math_clz32(uint32_t x) {
+    uint32_t n = 0;
+    if (x == 0) return 32;
+    if (!(x & 0xFFFF0000u)) { n += 16; x <<= 16; }
+    if (!(x & 0xFF000000u)) { n += 8;  x <<= 8;  }
+    if (!(x & 0xF0000000u)) { n += 4;  x <<= 4;  }
+    if (!(x & 0xC0000000u)) { n += 2;  x <<= 2;  }
+    if (!(x & 0x80000000u)) { n += 1; }
+    return n;
+}
+
+// Zeros à direita (ctz(0) = 32)
+static inline uint32_t math_ctz32(uint32_t x) {
+    if (x == 0) return 32;
+    return 31 - math_clz32(x & (0u - x)); // Isola o bit menos significativo
+}
+
+// Verdadeiro se 'x' é potência de 2 (x != 0)
+static inline int math_is_pow2(uint32_t x) {
+    return x != 0 && (x & (x - 1)) == 0;
+}
+
+#endif /* MATH_OPS_H */
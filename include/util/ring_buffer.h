@@ -0,0 +1,154 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdint.h>
+#include "util/string.h"
+
+/* ============================================================================
+ * RING BUFFER SPSC (um produtor, um consumidor, sem lock)
+ * ============================================================================
+ *
+ * RING_DEFINE(nome, tipo, capacidade) gera o tipo nome_t e as funções
+ * nome_push/pop, nome_push_n/pop_n e as regiões zero-copy
+ * nome_write_peek/commit e nome_read_peek/commit.
+ *
+ *   - capacidade precisa ser potência de 2: o índice é (i & mascara), sem
+ *     '%' (no RV32I o resto vira chamada a __umodsi3);
+ *   - head/tail correm livres (uint32_t) e a ocupação é head - tail, então
+ *     todas as 'capacidade' posições são usadas (não sobra slot vazio);
+ *   - só o produtor escreve head, só o consumidor escreve tail. Produtor e
+ *     consumidor podem ser ISR e tarefa, ou duas tarefas, sem desabilitar
+ *     interrupções.
+ *
+ * Ordem de memória: o produtor grava os dados, faz RING_RELEASE e só então
+ * publica head; o consumidor lê head, faz RING_ACQUIRE e só então lê os
+ * dados (o mesmo vale, invertido, para tail). Num único hart bastaria
+ * barreira de compilador; o 'fence' mantém correto com mais de um hart.
+ */
+
+#if defined(__riscv)
+#define RING_ACQUIRE()  __asm__ volatile ("fence r, rw" ::: "memory")
+#define RING_RELEASE()  __asm__ volatile ("fence rw, w" ::: "memory")
+#else
+#define RING_ACQUIRE()  __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define RING_RELEASE()  __atomic_thread_fence(__ATOMIC_RELEASE)
+#endif
+
+#define RING_LOAD(x)      (*(volatile uint32_t *)&(x))
+#define RING_STORE(x, v)  (*(volatile uint32_t *)&(x) = (v))
+
+#define RING_DEFINE(name, type, cap)                                           \
+_Static_assert((cap) >= 2 && ((cap) & ((cap) - 1)) == 0,                       \
+               #name ": capacidade precisa ser potência de 2");                \
+                                                                               \
+typedef struct {                                                               \
+    uint32_t head;              /* Próxima escrita (produtor) */               \
+    uint32_t tail;              /* Próxima leitura (consumidor) */             \
+    type     data[cap];                                                        \
+} name##_t;                                                                    \
+                                                                               \
+static inline void name##_init(name##_t *rb) {                                 \
+    rb->head = 0;                                                              \
+    rb->tail = 0;                                                              \
+}                                                                              \
+                                                                               \
+static inline uint32_t name##_count(name##_t *rb) {                            \
+    return RING_LOAD(rb->head) - RING_LOAD(rb->tail);                          \
+}                                                                              \
+                                                                               \
+static inline uint32_t name##_space(name##_t *rb) {                            \
+    return (cap) - name##_count(rb);                                           \
+}                                                                              \
+                                                                               \
+/* --- Produtor --- */                                                         \
+                                                                               \
+/* Região contígua livre a partir de head (pode ser menor que o espaço    */   \
+/* total quando cruza o fim do vetor). Preencha e chame _write_commit.    */   \
+static inline uint32_t name##_write_peek(name##_t *rb, type **ptr) {           \
+    uint32_t head = rb->head;                                                  \
+    uint32_t tail = RING_LOAD(rb->tail);                                       \
+    RING_ACQUIRE(); /* Consumidor já terminou de ler o que liberou */          \
+    uint32_t idx = head & ((cap) - 1);                                         \
+    uint32_t n = (cap) - (head - tail);                                        \
+    if (n > (cap) - idx) n = (cap) - idx;                                      \
+    *ptr = &rb->data[idx];                                                     \
+    return n;                                                                  \
+}                                                                              \
+                                                                               \
+static inline void name##_write_commit(name##_t *rb, uint32_t n) {             \
+    RING_RELEASE(); /* Dados visíveis antes do novo head */                    \
+    RING_STORE(rb->head, rb->head + n);                                        \
+}                                                                              \
+                                                                               \
+static inline int name##_push(name##_t *rb, type val) {                        \
+    uint32_t head = rb->head;                                                  \
+    if (head - RING_LOAD(rb->tail) == (cap)) return 0; /* Cheio */             \
+    RING_ACQUIRE();                                                            \
+    rb->data[head & ((cap) - 1)] = val;                                        \
+    RING_RELEASE();                                                            \
+    RING_STORE(rb->head, head + 1);                                            \
+    return 1;                                                                  \
+}                                                                              \
+                                                                               \
+/* Copia até n elementos; retorna quantos couberam. */                        \
+static inline uint32_t name##_push_n(name##_t *rb, const type *src,            \
+                                     uint32_t n) {                             \
+    uint32_t done = 0;                                                         \
+    type *dst;                                                                 \
+    for (int part = 0; part < 2 && done < n; part++) { /* Até 2 pedaços */     \
+        uint32_t chunk = name##_write_peek(rb, &dst);                          \
+        if (chunk == 0) break;                                                 \
+        if (chunk > n - done) chunk = n - done;                                \
+        memcpy(dst, src + done, chunk * sizeof(type));                         \
+        name##_write_commit(rb, chunk);                                        \
+        done += chunk;                                                         \
+    }                                                                          \
+    return done;                                                               \
+}                                                                              \
+                                                                               \
+/* --- Consumidor --- */                                                       \
+                                                                               \
+/* Região contígua ocupada a partir de tail. Consuma e chame             */   \
+/* _read_commit com quantos elementos foram usados.                      */   \
+static inline uint32_t name##_read_peek(name##_t *rb, type **ptr) {            \
+    uint32_t tail = rb->tail;                                                  \
+    uint32_t head = RING_LOAD(rb->head);                                       \
+    RING_ACQUIRE(); /* Dados do produtor visíveis após ler head */             \
+    uint32_t idx = tail & ((cap) - 1);                                         \
+    uint32_t n = head - tail;                                                  \
+    if (n > (cap) - idx) n = (cap) - idx;                                      \
+    *ptr = &rb->data[idx];                                                     \
+    return n;                                                                  \
+}                                                                              \
+                                                                               \
+static inline void name##_read_commit(name##_t *rb, uint32_t n) {              \
+    RING_RELEASE(); /* Leituras terminam antes de liberar os slots */          \
+    RING_STORE(rb->tail, rb->tail + n);                                        \
+}                                                                              \
+                                                                               \
+static inline int name##_pop(name##_t *rb, type *val) {                        \
+    uint32_t tail = rb->tail;                                                  \
+    if (RING_LOAD(rb->head) == tail) return 0; /* Vazio */                     \
+    RING_ACQUIRE();                                                            \
+    *val = rb->data[tail & ((cap) - 1)];                                       \
+    RING_RELEASE();                                                            \
+    RING_STORE(rb->tail, tail + 1);                                            \
+    return 1;                                                                  \
+}                                                                              \
+                                                                               \
+/* Copia até n elementos; retorna quantos havia. */                           \
+static inline uint32_t name##_pop_n(name##_t *rb, type *dst, uint32_t n) {     \
+    uint32_t done = 0;                                                         \
+    type *src;                                                                 \
+    for (int part = 0; part < 2 && done < n; part++) {                         \
+        uint32_t chunk = name##_read_peek(rb, &src);                           \
+        if (chunk == 0) break;                                                 \
+        if (chunk > n - done) chunk = n - done;                                \
+        memcpy(dst + done, src, chunk * sizeof(type));                         \
+        name##_read_commit(rb, chunk);                                         \
+        done += chunk;                                                         \
+    }                                                                          \
+    return done;                                                               \
+}
+
+#endif
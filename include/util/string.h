@@ -0,0 +1,24 @@
+#ifndef UTIL_STRING_H
+#define UTIL_STRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================================
+ * BIBLIOTECA DE MEMÓRIA (Freestanding, RV32I)
+ * ============================================================================
+ *
+ * Implementação própria de memcpy/memset/memmove/memcmp (não há libc).
+ * As rotinas alinham o destino, movem palavras de 32 bits com laços
+ * desenrolados e tratam as pontas desalinhadas byte a byte.
+ *
+ * Os nomes seguem o padrão C porque o GCC também gera chamadas a
+ * memcpy/memset sozinho (cópia/zeragem de structs grandes).
+ */
+
+void *memcpy(void *dst, const void *src, size_t n);
+void *memmove(void *dst, const void *src, size_t n);
+void *memset(void *dst, int c, size_t n);
+int   memcmp(const void *a, const void *b, size_t n);
+
+#endif /* UTIL_STRING_H */
@@ -0,0 +1,36 @@
+#include "../../include/sys/syscall.h"
+#include "../../include/apps/shell_utils.h"
+#include "../../include/kernel/klog.h"
+
+// ======================================================================================
+// TASK: LOGGER (Esvazia o KLOG e imprime)
+// ======================================================================================
+
+// Intervalo entre esvaziamentos do ring
+#define LOGGER_PERIOD_MS 50
+
+void task_logger(void) {
+    klog_record_t rec;
+    char line[128];
+    char num[12];
+
+    while (1) {
+        // O editor ocupa a tela inteira: segura o log até ele fechar
+        if (g_editor_mode == 0) {
+            while (klog_pop(&rec)) {
+                klog_format(&rec, line, sizeof(line));
+                safe_puts(line);
+            }
+
+            uint32_t lost = klog_take_dropped();
+            if (lost) {
+                uint_to_str(lost, num);
+                safe_puts(SH_YELLOW "[ LOG   ] ");
+                safe_puts(num);
+                safe_puts(" records dropped (ring full)\n" SH_RESET);
+            }
+        }
+
+        sys_sleep(LOGGER_PERIOD_MS);
+    }
+}
@@ -2,8 +2,10 @@
 #include "sys/syscall.h"
 #include "kernel/mutex.h"
 #include "hal/hal_uart.h"
-#include "util/circular_buffer.h"
 #include "apps/commands.h"
+#include "apps/apps_tasks.h"
+#include "kernel/bootlog.h"
+#include "hal/hal_sys.h"
 
 // ======================================================================================
 // Definições de CORES para o SHELL
@@ -23,9 +25,6 @@
 // Mutex para uso da UART (definido em apps.c)
 extern mutex_t uart_mutex;
 
-// Buffer do teclado (definido em apps.c)
-extern cbuf_t rx_buffer;
-
 // Modo editor global
 volatile int g_editor_mode = 0;
 
@@ -34,9 +33,9 @@ volatile int g_editor_mode = 0;
 // ======================================================================================
 
 void uart_isr(void) {
-    if (hal_uart_kbhit()) {
-        char c = hal_uart_getc();
-        cbuf_push(&rx_buffer, (uint8_t)c);
+    // Drena a FIFO inteira numa interrupção só; sem espaço, o byte é descartado
+    while (hal_uart_kbhit()) {
+        rx_ring_push(&rx_buffer, (uint8_t)hal_uart_getc());
     }
 }
 
@@ -73,7 +72,7 @@ char shell_getc(void) {
     uint8_t c;
     while (1) {
         // Tenta pegar um char do buffer circular
-        if (cbuf_pop(&rx_buffer, &c)) {
+        if (rx_ring_pop(&rx_buffer, &c)) {
             return (char)c;
         }
         // Se vazio, cede a CPU para não travar o sistema
@@ -95,6 +94,10 @@ static const shell_cmd_t shell_commands[] = {
     {"clear",   cmd_clear},
     {"reboot",  cmd_reboot},
     {"panic",   cmd_panic},
+    {"bench",   cmd_bench},
+    {"bootlog", cmd_bootlog},
+    {"trace",   cmd_trace},
+    {"prof",    cmd_prof},
     {"ps",      cmd_ps},
     {"memtest", cmd_memtest},
     {"heap",    cmd_heap},
@@ -103,14 +106,21 @@ static const shell_cmd_t shell_commands[] = {
     {"alloc",   cmd_alloc}, 
     {"stop",    cmd_stop},  
     {"resume",  cmd_resume},
+    {"kill",    cmd_kill},
     {"free",    cmd_free},
     {"defrag",  cmd_defrag},
+    {"quota",   cmd_quota},
     {"ls",      cmd_ls},
     {"touch",   cmd_touch},
     {"rm",      cmd_rm},
     {"cat",     cmd_cat},
     {"write",   cmd_write_file},
-    {"edit",    cmd_edit}
+    {"edit",    cmd_edit},
+    {"df",      cmd_df},
+    {"npuload", cmd_npuload},
+    {"sync",    cmd_sync},
+    {"mkdir",   cmd_mkdir},
+    {"rmdir",   cmd_rmdir}
 };
 
 #define CMD_COUNT (sizeof(shell_commands) / sizeof(shell_cmd_t))
@@ -125,12 +135,26 @@ void task_shell(void) {
     char cmd_buf[CMD_MAX_LEN];
     int cmd_idx = 0;
 
+    // Shell no ar: fim do "time-to-shell" medido pelo 'bootlog'
+    boot_mark("shell");
+
+#ifdef CONFIG_BENCH
+    // Imagem de benchmark (make bench): roda todas as suítes e encerra o QEMU
+    // com o número de autoverificações que falharam.
+    hal_sys_exit(bench_run_all());
+#endif
+
+#ifdef FAST_BOOT
+    // O banner do Kernel foi adiado para cá (cabeçalho curto)
+    clear_screen();
+#else
     safe_puts("\n"); 
+#endif
     show_prompt();
     
     while (1) {
         
-        if (cbuf_pop(&rx_buffer, &c)) {
+        if (rx_ring_pop(&rx_buffer, &c)) {
             
             // --- CTRL+L (Form Feed) ---
             if (c == 12) { 
@@ -0,0 +1,728 @@
+#include "apps/shell_utils.h"
+#include "kernel/mm.h"
+#include "kernel/kmem.h"
+#include "kernel/fs.h"
+#include "kernel/task.h"
+#include "hal/hal_timer.h"
+#include "util/string.h"
+#include "util/math_ops.h"
+#include "hal/hal_npu.h"
+#include "hal/hal_uart.h"
+
+// ======================================================================================
+// COMANDO: BENCH (Microbenchmarks)
+// ======================================================================================
+//
+//  Uso: bench <suite>    (bench all = todas as suítes da 'make bench')
+//
+//  Cada resultado sai numa linha própria, fácil de filtrar/parsear no host:
+//
+//      BENCH <suite>.<caso> <tamanho> <valor> <unidade>
+//
+//  O 'bench all' termina com "BENCH_DONE failures=<n>" (autoverificações
+//  que falharam). tools/bench_compare.py compara as linhas com um baseline.
+//
+//  "Ciclos" aqui são os ticks de hal_timer_get_cycles(): 100MHz na FPGA
+//  (= clock da CPU) e 10MHz no QEMU (apenas para comparação relativa).
+//
+// ======================================================================================
+
+// Símbolo do linker: usamos a própria imagem do Kernel como origem das cópias
+// (memória sempre válida e grande o bastante, sem gastar Heap).
+extern void _start(void);
+
+// Quantidade de bytes movidos por medição (repete tamanhos pequenos)
+#define BENCH_BYTES_PER_RUN  (64 * 1024)
+#define BENCH_MAX_SIZE       (32 * 1024)
+
+// Autoverificações que falharam desde o boot (código de saída da 'make bench')
+static uint32_t bench_failures = 0;
+
+static void bench_fail(const char *msg) {
+    bench_failures++;
+    safe_puts(SH_RED "bench: ");
+    safe_puts(msg);
+    safe_puts(" FAILED\n" SH_RESET);
+}
+
+// Imprime um valor em ponto fixo x100 como "123.45"
+static void bench_put_x100(uint32_t v) {
+    char buf[12];
+    uint_to_str(v / 100, buf);
+    safe_puts(buf);
+    safe_puts(".");
+    uint32_t frac = v % 100;
+    buf[0] = '0' + (frac / 10);
+    buf[1] = '0' + (frac % 10);
+    buf[2] = 0;
+    safe_puts(buf);
+}
+
+static void bench_line(const char *name, uint32_t size, uint32_t value_x100, const char *unit) {
+    char buf[12];
+    safe_puts("BENCH ");
+    safe_puts(name);
+    safe_puts(" ");
+    uint_to_str(size, buf);
+    safe_puts(buf);
+    safe_puts(" ");
+    bench_put_x100(value_x100);
+    safe_puts(" ");
+    safe_puts(unit);
+    safe_puts("\n");
+}
+
+// Throughput em bytes/ciclo (x100)
+static uint32_t bench_bpc_x100(uint32_t bytes, uint64_t cycles) {
+    if (cycles == 0) cycles = 1;
+    return (bytes * 100) / (uint32_t)cycles;
+}
+
+// Referência: cópia ingênua byte a byte (como o código antigo do Kernel fazia)
+__attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+static void bench_byte_copy(uint8_t *d, const uint8_t *s, uint32_t n) {
+    while (n--) *d++ = *s++;
+}
+
+// --------------------------------------------------------------------------------------
+// SUITE: MEM (memcpy/memset/memcmp, 4B a 32KB)
+// --------------------------------------------------------------------------------------
+
+static void bench_mem(void) {
+    const uint8_t *src = (const uint8_t *)_start;
+    uint32_t max_size = BENCH_MAX_SIZE;
+    uint8_t *dst = NULL;
+
+    // Tenta o maior buffer possível (o Heap pode estar ocupado pela RamFS)
+    while (max_size >= 1024 && !(dst = (uint8_t *)kmalloc(max_size + 8))) max_size >>= 1;
+    if (!dst) { bench_fail("out of memory"); return; }
+
+    for (uint32_t size = 4; size <= max_size; size <<= 2) {
+        uint32_t reps = BENCH_BYTES_PER_RUN / size;
+        if (reps == 0) reps = 1;
+        uint32_t bytes = reps * size;
+        uint64_t t0, t1;
+
+        t0 = hal_timer_get_cycles();
+        for (uint32_t r = 0; r < reps; r++) bench_byte_copy(dst, src, size);
+        t1 = hal_timer_get_cycles();
+        bench_line("mem.bytecopy", size, bench_bpc_x100(bytes, t1 - t0), "B/cycle");
+
+        t0 = hal_timer_get_cycles();
+        for (uint32_t r = 0; r < reps; r++) memcpy(dst, src, size);
+        t1 = hal_timer_get_cycles();
+        bench_line("mem.memcpy", size, bench_bpc_x100(bytes, t1 - t0), "B/cycle");
+
+        // Origem e destino com alinhamentos diferentes (caminho com shifts)
+        t0 = hal_timer_get_cycles();
+        for (uint32_t r = 0; r < reps; r++) memcpy(dst, src + 1, size);
+        t1 = hal_timer_get_cycles();
+        bench_line("mem.memcpy_unaligned", size, bench_bpc_x100(bytes, t1 - t0), "B/cycle");
+
+        t0 = hal_timer_get_cycles();
+        for (uint32_t r = 0; r < reps; r++) memset(dst, r, size);
+        t1 = hal_timer_get_cycles();
+        bench_line("mem.memset", size, bench_bpc_x100(bytes, t1 - t0), "B/cycle");
+
+        // Buffers iguais: o memcmp percorre tudo
+        volatile int sink;
+        memcpy(dst, src, size);
+        t0 = hal_timer_get_cycles();
+        for (uint32_t r = 0; r < reps; r++) sink = memcmp(dst, src, size);
+        (void)sink;
+        t1 = hal_timer_get_cycles();
+        bench_line("mem.memcmp", size, bench_bpc_x100(bytes, t1 - t0), "B/cycle");
+
+        // 4, 16, 64 ... 16K e depois o tamanho máximo (32K)
+        if (size < max_size && (size << 2) > max_size) size = max_size >> 2;
+    }
+
+    kfree(dst);
+}
+
+// --------------------------------------------------------------------------------------
+// SUITE: DMA (CPU x DMA por tamanho; mede e aplica o limiar do kmemcpy)
+// --------------------------------------------------------------------------------------
+
+static void bench_dma(void) {
+    const uint8_t *src = (const uint8_t *)_start;
+    uint32_t max_size = 16 * 1024;
+    uint8_t *dst = NULL;
+
+    while (max_size >= 1024 && !(dst = (uint8_t *)kmalloc_aligned(max_size, 4))) max_size >>= 1;
+    if (!dst) { bench_fail("out of memory"); return; }
+
+    uint32_t old_threshold = kmem_get_dma_threshold();
+    uint32_t crossover = KMEM_DMA_OFF;
+
+    for (uint32_t size = 16; size <= max_size; size <<= 1) {
+        uint32_t reps = BENCH_BYTES_PER_RUN / size;
+        if (reps == 0) reps = 1;
+        uint32_t bytes = reps * size;
+        uint64_t t0, cpu, dma;
+
+        kmem_set_dma_threshold(KMEM_DMA_OFF);
+        t0 = hal_timer_get_cycles();
+        for (uint32_t r = 0; r < reps; r++) kmemcpy(dst, src, size);
+        cpu = hal_timer_get_cycles() - t0;
+        bench_line("dma.cpu", size, bench_bpc_x100(bytes, cpu), "B/cycle");
+
+        kmem_set_dma_threshold(0);
+        t0 = hal_timer_get_cycles();
+        for (uint32_t r = 0; r < reps; r++) kmemcpy(dst, src, size);
+        dma = hal_timer_get_cycles() - t0;
+        bench_line("dma.dma", size, bench_bpc_x100(bytes, dma), "B/cycle");
+
+        // Crossover: menor tamanho a partir do qual o DMA não perde mais
+        if (dma < cpu) {
+            if (crossover == KMEM_DMA_OFF) crossover = size;
+        } else {
+            crossover = KMEM_DMA_OFF;
+        }
+    }
+
+    kfree(dst);
+
+    char buf[12];
+    kmem_set_dma_threshold(crossover);
+    if (crossover == KMEM_DMA_OFF) {
+        safe_puts("DMA never wins: kmemcpy stays on the CPU");
+    } else {
+        safe_puts("DMA threshold set to ");
+        uint_to_str(crossover, buf);
+        safe_puts(buf);
+        safe_puts(" bytes");
+    }
+    safe_puts(" (was ");
+    if (old_threshold == KMEM_DMA_OFF) {
+        safe_puts("off");
+    } else {
+        uint_to_str(old_threshold, buf);
+        safe_puts(buf);
+    }
+    safe_puts(")\n");
+}
+
+// --------------------------------------------------------------------------------------
+// SUITE: MATH (runtime de mul/div em software, ciclos por operação)
+// --------------------------------------------------------------------------------------
+
+#define BENCH_MATH_OPS  1000
+
+// Ciclos por operação (x100)
+static uint32_t bench_cpo_x100(uint64_t cycles) {
+    return ((uint32_t)cycles * 100) / BENCH_MATH_OPS;
+}
+
+typedef uint32_t (*bench_op32_t)(uint32_t, uint32_t);
+typedef uint64_t (*bench_op64_t)(uint64_t, uint64_t);
+
+static volatile uint32_t bench_sink32;
+static volatile uint64_t bench_sink64;
+
+// Operandos lidos de volatile a cada volta: com -O2 o cálculo não sai do laço
+static void bench_op32(const char *name, bench_op32_t fn, uint32_t a, uint32_t b) {
+    volatile uint32_t va = a, vb = b;
+    uint64_t t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_MATH_OPS; i++) bench_sink32 = fn(va, vb);
+    uint64_t t1 = hal_timer_get_cycles();
+    bench_line(name, BENCH_MATH_OPS, bench_cpo_x100(t1 - t0), "cycles/op");
+}
+
+static void bench_op64(const char *name, bench_op64_t fn, uint64_t a, uint64_t b) {
+    volatile uint64_t va = a, vb = b;
+    uint64_t t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_MATH_OPS; i++) bench_sink64 = fn(va, vb);
+    uint64_t t1 = hal_timer_get_cycles();
+    bench_line(name, BENCH_MATH_OPS, bench_cpo_x100(t1 - t0), "cycles/op");
+}
+
+static uint64_t op_udiv64(uint64_t a, uint64_t b) { return __udivdi3(a, b); }
+static uint64_t op_umod64(uint64_t a, uint64_t b) { return __umoddi3(a, b); }
+
+// O runtime de 32 bits (math_ops.c) só existe no build RV32I
+#ifndef __riscv_mul
+
+// Referências: as rotinas bit-serial originais do math_ops.c
+static uint32_t ref_mul32(uint32_t a, uint32_t b) {
+    uint32_t res = 0;
+    while (b != 0) {
+        if (b & 1) res += a;
+        a <<= 1;
+        b >>= 1;
+    }
+    return res;
+}
+
+static uint32_t ref_udiv32(uint32_t n, uint32_t d) {
+    uint32_t q = 0, r = 0;
+    for (int i = 31; i >= 0; i--) {
+        r = (r << 1) | ((n >> i) & 1);
+        if (r >= d) { r -= d; q |= (1U << i); }
+    }
+    return q;
+}
+
+static uint64_t ref_mul64(uint64_t a, uint64_t b) {
+    uint64_t res = 0;
+    while (b != 0) {
+        if (b & 1) res += a;
+        a <<= 1;
+        b >>= 1;
+    }
+    return res;
+}
+
+// Chamadas explícitas (o -O0 não dobra constantes, mas deixamos claro)
+static uint32_t op_mul32(uint32_t a, uint32_t b)  { return (uint32_t)__mulsi3((int32_t)a, (int32_t)b); }
+static uint32_t op_udiv32(uint32_t a, uint32_t b) { return __udivsi3(a, b); }
+static uint32_t op_umod32(uint32_t a, uint32_t b) { return __umodsi3(a, b); }
+static uint64_t op_mul64(uint64_t a, uint64_t b)  { return (uint64_t)__muldi3((int64_t)a, (int64_t)b); }
+
+static void bench_math_soft32(void) {
+    // Multiplicador pequeno à esquerda: o antigo rodava 32 passos
+    bench_op32("math.mul32_ref.small",  ref_mul32, 7, 1000);
+    bench_op32("math.mul32.small",      op_mul32,  7, 1000);
+    bench_op32("math.mul32_ref.large",  ref_mul32, 0x12345, 0x6789);
+    bench_op32("math.mul32.large",      op_mul32,  0x12345, 0x6789);
+    bench_op32("math.mul32.pow2",       op_mul32,  12345, 1024);
+
+    // print_dec: divisões por 10
+    bench_op32("math.udiv32_ref.by10",  ref_udiv32, 123456789, 10);
+    bench_op32("math.udiv32.by10",      op_udiv32,  123456789, 10);
+    bench_op32("math.udiv32_ref.small", ref_udiv32, 1000, 7);
+    bench_op32("math.udiv32.small",     op_udiv32,  1000, 7);
+    bench_op32("math.udiv32.pow2",      op_udiv32,  123456789, 4096);
+    bench_op32("math.umod32.by10",      op_umod32,  123456789, 10);
+
+    // scheduler_sleep: ms * (freq / 1000) em 64 bits
+    bench_op64("math.mul64_ref",        ref_mul64, 250, 100000);
+    bench_op64("math.mul64",            op_mul64,  250, 100000);
+
+    // Conferência rápida contra as referências
+    if (op_mul32(0x12345, 0x6789) != ref_mul32(0x12345, 0x6789) ||
+        op_udiv32(123456789, 10) != ref_udiv32(123456789, 10) ||
+        op_mul64(0xFFFFFFFFull, 0x10001ull) != ref_mul64(0xFFFFFFFFull, 0x10001ull)) {
+        bench_fail("math self-check");
+    }
+}
+
+#endif // __riscv_mul
+
+static void bench_math(void) {
+#ifndef __riscv_mul
+    bench_math_soft32();
+#endif
+    // Divisão de 64 bits: em software nos dois builds
+    bench_op64("math.udiv64.by1000",    op_udiv64, 0x123456789ABull, 1000);
+    bench_op64("math.udiv64.small",     op_udiv64, 1000000, 7);
+    bench_op64("math.umod64.by1000",    op_umod64, 0x123456789ABull, 1000);
+
+    if (op_udiv64(0x123456789ABull, 1000) != 1250999896ull) {
+        bench_fail("math self-check");
+    }
+}
+
+// --------------------------------------------------------------------------------------
+// SUITE: ISA (cargas reais que usam mul/div; rodar nas imagens rv32i e rv32im
+//             e comparar as linhas BENCH para ver o ganho da extensão M)
+// --------------------------------------------------------------------------------------
+
+#define BENCH_NPU_K     64   // Profundidade do produto escalar
+#define BENCH_NPU_OUT   8    // Saídas por rodada (divide BENCH_MATH_OPS)
+
+static void bench_isa(void) {
+#ifdef __riscv_mul
+    safe_puts("ISA: rv32im (hardware mul/div)\n");
+#else
+    safe_puts("ISA: rv32i (software mul/div)\n");
+#endif
+    uint64_t t0, t1;
+
+    // 1. Escalonador: conversão ms -> ciclos do scheduler_sleep
+    uint32_t freq = hal_timer_get_freq();
+    t0 = hal_timer_get_cycles();
+    for (uint32_t ms = 1; ms <= BENCH_MATH_OPS; ms++) {
+        bench_sink64 = hal_timer_get_cycles() + (uint64_t)ms * (freq / 1000);
+    }
+    t1 = hal_timer_get_cycles();
+    bench_line("isa.sched_sleep", BENCH_MATH_OPS, bench_cpo_x100(t1 - t0), "cycles/op");
+
+    // 2. Formatação decimal (ps, free, print_dec...)
+    char buf[12];
+    uint32_t val = 12345;
+    t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_MATH_OPS; i++) {
+        uint_to_str(val, buf);
+        val += 4000037;
+    }
+    t1 = hal_timer_get_cycles();
+    bench_line("isa.fmt_dec", BENCH_MATH_OPS, bench_cpo_x100(t1 - t0), "cycles/op");
+
+    // 3. Quantização da NPU (referência em software):
+    //    acc = sum(w * x) em int8; out = clamp(((acc * mult) >> shift) + zp)
+    int8_t w[BENCH_NPU_K], x[BENCH_NPU_K];
+    for (int k = 0; k < BENCH_NPU_K; k++) {
+        w[k] = (int8_t)(k * 37 - 100);
+        x[k] = (int8_t)(50 - k * 3);
+    }
+    npu_quant_params_t q = { .mult = 1518500250u, .shift = 20, .zero_point = 3, .relu = 1 };
+
+    uint32_t rounds = BENCH_MATH_OPS / BENCH_NPU_OUT;
+    t0 = hal_timer_get_cycles();
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (int o = 0; o < BENCH_NPU_OUT; o++) {
+            int32_t acc = (int32_t)r; // Depende da rodada: não pode sair do laço
+            for (int k = 0; k < BENCH_NPU_K; k++) acc += (int32_t)w[k] * (int32_t)(x[k] + o);
+            int32_t out = (int32_t)(((int64_t)acc * q.mult) >> q.shift) + (int32_t)q.zero_point;
+            if (q.relu && out < 0) out = 0;
+            if (out > 127) out = 127;
+            if (out < -128) out = -128;
+            bench_sink32 = (uint32_t)out;
+        }
+    }
+    t1 = hal_timer_get_cycles();
+    bench_line("isa.npu_quant", rounds * BENCH_NPU_OUT, bench_cpo_x100(t1 - t0), "cycles/op");
+}
+
+// --------------------------------------------------------------------------------------
+// SUITE: SWITCH (troca de contexto: trap + escalonador + restauração)
+// --------------------------------------------------------------------------------------
+//
+//  O escalonador sempre escolhe a maior prioridade: sozinho nela, o shell
+//  voltaria para ele mesmo a cada yield. Um par na mesma prioridade faz o
+//  pingue-pongue (shell -> par -> shell = duas trocas por yield). O par é
+//  criado no primeiro uso e fica pausado entre as medições. Na imagem
+//  completa as MAX_TASKS já estão ocupadas: a suíte é pulada.
+
+#define BENCH_SWITCH_OPS  1000
+
+static volatile uint32_t bench_peer_runs = 0;
+static int bench_peer_tid = -1;
+
+static void bench_peer(void) {
+    while (1) {
+        bench_peer_runs++;
+        sys_yield();
+    }
+}
+
+static void bench_switch(void) {
+    if (bench_peer_tid < 0) bench_peer_tid = task_create(bench_peer, "Bench Peer", current_task->priority);
+    else sys_resume((uint32_t)bench_peer_tid);
+    if (bench_peer_tid < 0) { safe_puts("switch: skipped (no free task slot for the peer)\n"); return; }
+    sys_yield(); // O par já está no laço
+
+    uint32_t runs0 = bench_peer_runs;
+    uint64_t t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_SWITCH_OPS; i++) sys_yield();
+    uint64_t t1 = hal_timer_get_cycles();
+    uint32_t runs = bench_peer_runs - runs0;
+    sys_suspend((uint32_t)bench_peer_tid);
+
+    bench_line("switch.yield", 2 * BENCH_SWITCH_OPS, ((uint32_t)(t1 - t0) * 100) / (2 * BENCH_SWITCH_OPS), "cycles/op");
+    if (runs < BENCH_SWITCH_OPS) bench_fail("switch: yield did not reach the peer");
+}
+
+// --------------------------------------------------------------------------------------
+// SUITE: SYSCALL (custo de uma syscall sem troca de tarefa)
+// --------------------------------------------------------------------------------------
+
+#define BENCH_SYSCALL_OPS  1000
+#define BENCH_TASKS_MAX    8
+
+static void bench_syscall(void) {
+    volatile uint32_t word = 0x1234;
+    task_info_t info[BENCH_TASKS_MAX];
+    uint64_t t0, t1;
+
+    // Mínimo: ecall + despacho + mret
+    t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_SYSCALL_OPS; i++) bench_sink32 = sys_peek((uint32_t)&word);
+    t1 = hal_timer_get_cycles();
+    bench_line("syscall.peek", BENCH_SYSCALL_OPS, ((uint32_t)(t1 - t0) * 100) / BENCH_SYSCALL_OPS, "cycles/op");
+
+    // Com cópia de dados para o usuário
+    t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_SYSCALL_OPS; i++) bench_sink32 = sys_get_tasks(info, BENCH_TASKS_MAX);
+    t1 = hal_timer_get_cycles();
+    bench_line("syscall.get_tasks", BENCH_SYSCALL_OPS, ((uint32_t)(t1 - t0) * 100) / BENCH_SYSCALL_OPS, "cycles/op");
+
+    if (bench_sink32 == 0 || sys_peek((uint32_t)&word) != 0x1234) bench_fail("syscall self-check");
+}
+
+// --------------------------------------------------------------------------------------
+// SUITE: KMALLOC (par alloc/free por tamanho, heap limpo e fragmentado)
+// --------------------------------------------------------------------------------------
+
+#define BENCH_ALLOC_OPS    200
+#define BENCH_FRAG_BLOCKS  16
+
+static void bench_alloc_pairs(const char *name, uint32_t size) {
+    uint64_t t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_ALLOC_OPS; i++) {
+        void *p = kmalloc(size);
+        if (!p) { bench_fail("kmalloc"); return; }
+        kfree(p);
+    }
+    uint64_t t1 = hal_timer_get_cycles();
+    bench_line(name, size, ((uint32_t)(t1 - t0) * 100) / BENCH_ALLOC_OPS, "cycles/op");
+}
+
+static void bench_kmalloc(void) {
+    bench_alloc_pairs("kmalloc.pair", 16);
+    bench_alloc_pairs("kmalloc.pair", 256);
+    bench_alloc_pairs("kmalloc.pair", 2048);
+
+    // Heap fragmentado: buracos de 64B intercalados com blocos vivos
+    void *blocks[BENCH_FRAG_BLOCKS];
+    for (int i = 0; i < BENCH_FRAG_BLOCKS; i++) blocks[i] = kmalloc(64);
+    for (int i = 0; i < BENCH_FRAG_BLOCKS; i += 2) { kfree(blocks[i]); blocks[i] = NULL; }
+    bench_alloc_pairs("kmalloc.frag", 128);
+    for (int i = 1; i < BENCH_FRAG_BLOCKS; i += 2) kfree(blocks[i]);
+
+    // Via syscall (quota e dono contabilizados)
+    uint64_t t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_ALLOC_OPS; i++) {
+        void *p = sys_malloc(64);
+        if (!p) { bench_fail("sys_malloc"); return; }
+        sys_free(p);
+    }
+    uint64_t t1 = hal_timer_get_cycles();
+    bench_line("kmalloc.syscall", 64, ((uint32_t)(t1 - t0) * 100) / BENCH_ALLOC_OPS, "cycles/op");
+}
+
+// --------------------------------------------------------------------------------------
+// SUITE: FS (RamFS: escrita/leitura de um arquivo via syscalls)
+// --------------------------------------------------------------------------------------
+
+#define BENCH_FS_OPS   50
+#define BENCH_FS_MAX   8192   // 32 blocos de 256B (um extent contíguo)
+#define BENCH_FS_NAME  "bench.dat"
+#define BENCH_FS_FILES 16     // Arquivos extras no Root para o lookup (potência de 2)
+
+// Wrappers de syscall do shell (file_cmds.c)
+extern int sys_fs_create(const char *name);
+extern int sys_fs_write(const char *name, const char *data, int len);
+extern int sys_fs_read(const char *name, char *buf, int max);
+extern int sys_fs_delete(const char *name);
+extern int sys_fs_open(const char *name, int flags);
+extern int sys_fs_close(int fd);
+extern int sys_fs_fwrite(int fd, const char *data, int len);
+extern int sys_fs_lseek(int fd, int off, int whence);
+extern int sys_fs_map(const char *name, const uint8_t **ptr, uint32_t *len);
+extern int sys_fs_unmap(const uint8_t *ptr);
+extern int sys_fs_sync(void);
+extern int sys_fs_mkdir(const char *path);
+extern int sys_fs_rmdir(const char *path);
+extern int sys_fs_opendir(const char *path);
+extern int sys_fs_readdir(int fd, fs_dirent_t *out, int max);
+
+static void bench_fs(void) {
+    static const uint32_t sizes[] = { 64, 256, 1536, BENCH_FS_MAX };
+    char *data = (char *)kmalloc(BENCH_FS_MAX);
+    char *back = (char *)kmalloc(BENCH_FS_MAX);
+    if (!data || !back) { kfree(data); kfree(back); bench_fail("out of memory"); return; }
+
+    for (uint32_t i = 0; i < BENCH_FS_MAX; i++) data[i] = (char)(i * 7 + 1);
+
+    sys_fs_delete(BENCH_FS_NAME);
+    uint64_t t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_FS_OPS; i++) {
+        sys_fs_create(BENCH_FS_NAME);
+        sys_fs_delete(BENCH_FS_NAME);
+    }
+    uint64_t t1 = hal_timer_get_cycles();
+    bench_line("fs.create_delete", BENCH_FS_OPS, ((uint32_t)(t1 - t0) * 100) / BENCH_FS_OPS, "cycles/op");
+
+    if (sys_fs_create(BENCH_FS_NAME) < 0) { bench_fail("fs create"); goto out; }
+
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint32_t size  = sizes[s];
+        uint32_t bytes = size * BENCH_FS_OPS;
+
+        t0 = hal_timer_get_cycles();
+        for (uint32_t i = 0; i < BENCH_FS_OPS; i++) {
+            if (sys_fs_write(BENCH_FS_NAME, data, size) < 0) { bench_fail("fs write"); goto out; }
+        }
+        t1 = hal_timer_get_cycles();
+        bench_line("fs.write", size, bench_bpc_x100(bytes, t1 - t0), "B/cycle");
+
+        // Mesmos bytes no lugar pelo descritor: o custo da cópia na escrita
+        // é a diferença para a linha de cima
+        int wfd = sys_fs_open(BENCH_FS_NAME, FS_O_WRITE);
+        t0 = hal_timer_get_cycles();
+        for (uint32_t i = 0; i < BENCH_FS_OPS; i++) {
+            sys_fs_lseek(wfd, 0, FS_SEEK_SET);
+            sys_fs_fwrite(wfd, data, size);
+        }
+        t1 = hal_timer_get_cycles();
+        sys_fs_close(wfd);
+        bench_line("fs.write_inplace", size, bench_bpc_x100(bytes, t1 - t0), "B/cycle");
+
+        t0 = hal_timer_get_cycles();
+        for (uint32_t i = 0; i < BENCH_FS_OPS; i++) sys_fs_read(BENCH_FS_NAME, back, size);
+        t1 = hal_timer_get_cycles();
+        bench_line("fs.read", size, bench_bpc_x100(bytes, t1 - t0), "B/cycle");
+
+        if (memcmp(data, back, size) != 0) bench_fail("fs read-back");
+    }
+
+    // Mapear em vez de copiar (fs.read acima): custo fixo, sem buffer
+    const uint8_t *map;
+    uint32_t map_len;
+    t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_FS_OPS; i++) {
+        if (sys_fs_map(BENCH_FS_NAME, &map, &map_len) < 0) { bench_fail("fs map"); goto out; }
+        sys_fs_unmap(map);
+    }
+    t1 = hal_timer_get_cycles();
+    bench_line("fs.map", BENCH_FS_MAX, ((uint32_t)(t1 - t0) * 100) / BENCH_FS_OPS, "cycles/op");
+
+    sys_fs_map(BENCH_FS_NAME, &map, &map_len);
+    if (map_len != BENCH_FS_MAX || memcmp(data, map, BENCH_FS_MAX) != 0) bench_fail("fs map contents");
+    sys_fs_unmap(map);
+
+    // Anexar 16 bytes pelo descritor (offset no fim, sem reescrever o arquivo)
+    sys_fs_write(BENCH_FS_NAME, data, 1024);
+    int fd = sys_fs_open(BENCH_FS_NAME, FS_O_WRITE | FS_O_APPEND);
+    if (fd < 0) { bench_fail("fs open"); goto out; }
+    t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_FS_OPS; i++) sys_fs_fwrite(fd, data, 8);
+    t1 = hal_timer_get_cycles();
+    sys_fs_close(fd);
+    bench_line("fs.append", 8, ((uint32_t)(t1 - t0) * 100) / BENCH_FS_OPS, "cycles/op");
+
+    // Sync: no disco em RAM é só o syscall; com virtio (make run-disk) grava
+    // os blocos sujos e os metadados
+    t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_FS_OPS; i++) sys_fs_sync();
+    t1 = hal_timer_get_cycles();
+    bench_line("fs.sync", 0, ((uint32_t)(t1 - t0) * 100) / BENCH_FS_OPS, "cycles/op");
+
+    // Abrir por nome (leitura de 0 bytes = só o lookup) com o Root povoado
+    char name[4] = "b?";
+    for (uint32_t i = 0; i < BENCH_FS_FILES; i++) {
+        name[1] = 'a' + i;
+        if (sys_fs_create(name) < 0) { bench_fail("fs create (lookup)"); break; }
+    }
+    t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_FS_OPS; i++) {
+        uint32_t f = (i * 7) & (BENCH_FS_FILES - 1);
+        name[1] = 'a' + f;
+        sys_fs_read(name, back, 0);
+    }
+    t1 = hal_timer_get_cycles();
+    bench_line("fs.open", BENCH_FS_FILES, ((uint32_t)(t1 - t0) * 100) / BENCH_FS_OPS, "cycles/op");
+
+    // Listar o Root (BENCH_FS_FILES + o arquivo de bench) em lotes de 8
+    fs_dirent_t ents[8];
+    uint32_t listed = 0;
+    t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_FS_OPS; i++) {
+        int dfd = sys_fs_opendir(0);
+        int n;
+        while ((n = sys_fs_readdir(dfd, ents, 8)) > 0) listed += n;
+        sys_fs_close(dfd);
+    }
+    t1 = hal_timer_get_cycles();
+    if (listed < (BENCH_FS_FILES + 1) * BENCH_FS_OPS) bench_fail("fs readdir");
+    bench_line("fs.readdir", BENCH_FS_FILES + 1, ((uint32_t)(t1 - t0) * 100) / BENCH_FS_OPS, "cycles/op");
+    for (uint32_t i = 0; i < BENCH_FS_FILES; i++) {
+        name[1] = 'a' + i;
+        sys_fs_delete(name);
+    }
+
+    // Caminho com 4 níveis: o cache de caminhos evita refazer os componentes
+    static const char *const dirs[] = { "bp", "bp/q", "bp/q/r" };
+    for (uint32_t i = 0; i < 3; i++) sys_fs_mkdir(dirs[i]);
+    if (sys_fs_create("bp/q/r/w") < 0) { bench_fail("fs create (path)"); goto out_dirs; }
+    t0 = hal_timer_get_cycles();
+    for (uint32_t i = 0; i < BENCH_FS_OPS; i++) sys_fs_read("/bp/q/r/w", back, 0);
+    t1 = hal_timer_get_cycles();
+    bench_line("fs.path", 4, ((uint32_t)(t1 - t0) * 100) / BENCH_FS_OPS, "cycles/op");
+    sys_fs_delete("bp/q/r/w");
+out_dirs:
+    for (int i = 2; i >= 0; i--) sys_fs_rmdir(dirs[i]);
+
+out:
+    sys_fs_delete(BENCH_FS_NAME);
+    kfree(back);
+    kfree(data);
+}
+
+// --------------------------------------------------------------------------------------
+// SUITE: UART (transmissão por polling, ciclos por byte)
+// --------------------------------------------------------------------------------------
+
+#define BENCH_UART_LINES  32
+#define BENCH_UART_LINE   64   // Inclui o '\n'
+
+static void bench_uart(void) {
+    char line[BENCH_UART_LINE + 1];
+    for (int i = 0; i < BENCH_UART_LINE - 1; i++) line[i] = '.';
+    line[BENCH_UART_LINE - 1] = '\n';
+    line[BENCH_UART_LINE] = 0;
+
+    // Direto no driver (sem o custo do sys_write por caractere)
+    while (sys_mutex_lock(&uart_mutex) == 0) sys_yield();
+    uint64_t t0 = hal_timer_get_cycles();
+    for (int i = 0; i < BENCH_UART_LINES; i++) hal_uart_puts(line);
+    uint64_t t1 = hal_timer_get_cycles();
+    sys_mutex_unlock(&uart_mutex);
+
+    uint32_t bytes = BENCH_UART_LINES * BENCH_UART_LINE;
+    bench_line("uart.puts", bytes, ((uint32_t)(t1 - t0) * 100) / bytes, "cycles/B");
+}
+
+// --------------------------------------------------------------------------------------
+// TODAS AS SUÍTES (make bench)
+// --------------------------------------------------------------------------------------
+
+int bench_run_all(void) {
+    char buf[12];
+
+    bench_switch();
+    bench_syscall();
+    bench_kmalloc();
+    bench_fs();
+    bench_mem();
+    bench_math();
+    bench_uart();
+
+    safe_puts("BENCH_DONE failures=");
+    uint_to_str(bench_failures, buf);
+    safe_puts(buf);
+    safe_puts("\n");
+    return (int)bench_failures;
+}
+
+// ======================================================================================
+// DESPACHANTE
+// ======================================================================================
+
+void cmd_bench(const char *args) {
+    if (args && sys_strcmp(args, "mem") == 0) {
+        bench_mem();
+    } else if (args && sys_strcmp(args, "dma") == 0) {
+        bench_dma();
+    } else if (args && sys_strcmp(args, "math") == 0) {
+        bench_math();
+    } else if (args && sys_strcmp(args, "isa") == 0) {
+        bench_isa();
+    } else if (args && sys_strcmp(args, "switch") == 0) {
+        bench_switch();
+    } else if (args && sys_strcmp(args, "syscall") == 0) {
+        bench_syscall();
+    } else if (args && sys_strcmp(args, "kmalloc") == 0) {
+        bench_kmalloc();
+    } else if (args && sys_strcmp(args, "fs") == 0) {
+        bench_fs();
+    } else if (args && sys_strcmp(args, "uart") == 0) {
+        bench_uart();
+    } else if (args && sys_strcmp(args, "all") == 0) {
+        bench_run_all();
+    } else {
+        safe_puts("Usage: bench <all|mem|dma|math|isa|switch|syscall|kmalloc|fs|uart>\n");
+    }
+}
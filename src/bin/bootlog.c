@@ -0,0 +1,54 @@
+#include "apps/shell_utils.h"
+#include "hal/hal_timer.h"
+
+// ======================================================================================
+// COMANDO: BOOTLOG (Tempo de cada fase do boot)
+// ======================================================================================
+//
+//  As marcas são gravadas pelo kernel_main (boot_mark) e pela primeira
+//  execução do shell. AT = tempo desde "entry", DELTA = duração da fase.
+//
+// ======================================================================================
+
+#define BOOTLOG_ROWS 16
+
+// Imprime 'val' alinhado à direita em 'width' colunas
+static void put_dec_padded(uint32_t val, int width) {
+    char buf[12];
+    uint_to_str(val, buf);
+    int len = 0; while (buf[len]) len++;
+    for (int s = len; s < width; s++) safe_puts(" ");
+    safe_puts(buf);
+}
+
+void cmd_bootlog(const char *args) {
+    (void)args;
+
+    bootlog_entry_t list[BOOTLOG_ROWS];
+    int count = sys_bootlog(list, BOOTLOG_ROWS);
+    if (count <= 0) { safe_puts("bootlog: empty.\n"); return; }
+
+    uint32_t cycles_per_us = hal_timer_get_freq() / 1000000;
+    uint64_t t0 = list[0].cycles;
+
+    safe_puts(SH_BOLD "\n  PHASE            AT (us)   DELTA (us)\n" SH_RESET);
+    safe_puts(SH_GRAY "  -------------------------------------\n" SH_RESET);
+
+    for (int i = 0; i < count; i++) {
+        uint32_t at    = (uint32_t)(list[i].cycles - t0) / cycles_per_us;
+        uint32_t delta = (i == 0) ? 0 : (uint32_t)(list[i].cycles - list[i - 1].cycles) / cycles_per_us;
+
+        safe_puts("  ");
+        safe_puts(list[i].name);
+        int len = 0; while (list[i].name[len]) len++;
+        for (int s = len; s < 12; s++) safe_puts(" ");
+        put_dec_padded(at, 12);
+        put_dec_padded(delta, 13);
+        safe_puts("\n");
+    }
+
+    safe_puts(SH_GRAY "  -------------------------------------\n" SH_RESET);
+    safe_puts("  Total: ");
+    put_dec_padded((uint32_t)(list[count - 1].cycles - t0) / cycles_per_us, 0);
+    safe_puts(" us\n\n");
+}
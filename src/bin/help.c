@@ -16,21 +16,40 @@ void cmd_help(const char *args) {
     safe_puts("  " SH_CYAN "clear     " SH_RESET " Clear screen\n");
     safe_puts("  " SH_CYAN "reboot    " SH_RESET " Reboot system\n");
     safe_puts("  " SH_CYAN "panic     " SH_RESET " Trigger Kernel Panic\n");
+    safe_puts("  " SH_CYAN "bootlog   " SH_RESET " Boot phase timings\n");
+    safe_puts("  " SH_CYAN "trace     " SH_RESET " Kernel event trace (trace [start|stop|clear|dump])\n");
+    safe_puts("  " SH_CYAN "prof      " SH_RESET " PC-sampling profiler (prof [start|stop|dump])\n");
+    safe_puts("  " SH_CYAN "bench     " SH_RESET " Run benchmarks (bench <suite>, bench all)\n");
     
     // Processos
     safe_puts("  " SH_CYAN "ps        " SH_RESET " Process status\n");
     safe_puts("  " SH_CYAN "stop      " SH_RESET " Suspend task (stop <pid>)\n");
     safe_puts("  " SH_CYAN "resume    " SH_RESET " Resume task (resume <pid>)\n");
+    safe_puts("  " SH_CYAN "kill      " SH_RESET " Kill task, reclaim its heap (kill <pid>)\n");
     
     // Memória
     safe_puts("  " SH_CYAN "heap      " SH_RESET " Show heap usage\n");
     safe_puts("  " SH_CYAN "alloc     " SH_RESET " Safe alloc (alloc <bytes>)\n");
     safe_puts("  " SH_CYAN "free      " SH_RESET " Free memory (free <addr>)\n");
     safe_puts("  " SH_CYAN "defrag    " SH_RESET " Defrag heap (merge free blocks)\n");
+    safe_puts("  " SH_CYAN "quota     " SH_RESET " Task heap quota (quota <pid> <bytes>)\n");
     safe_puts("  " SH_CYAN "peek      " SH_RESET " Read memory (peek <addr>)\n");
     safe_puts("  " SH_CYAN "poke      " SH_RESET " Write memory (poke <addr> <val>)\n");
     safe_puts("  " SH_CYAN "memtest   " SH_RESET " Simple malloc test\n");
 
+    // Sistema de arquivos
+    safe_puts("  " SH_CYAN "ls        " SH_RESET " List files (ls [dir])\n");
+    safe_puts("  " SH_CYAN "touch     " SH_RESET " Create file (touch <name>)\n");
+    safe_puts("  " SH_CYAN "rm        " SH_RESET " Delete file (rm <name>)\n");
+    safe_puts("  " SH_CYAN "mkdir     " SH_RESET " Create directory (mkdir <path>)\n");
+    safe_puts("  " SH_CYAN "rmdir     " SH_RESET " Remove empty directory (rmdir <path>)\n");
+    safe_puts("  " SH_CYAN "cat       " SH_RESET " Show file (cat <name>)\n");
+    safe_puts("  " SH_CYAN "write     " SH_RESET " Write file (write [-a] <name> <text>)\n");
+    safe_puts("  " SH_CYAN "edit      " SH_RESET " Edit file (edit <name>)\n");
+    safe_puts("  " SH_CYAN "df        " SH_RESET " Filesystem usage\n");
+    safe_puts("  " SH_CYAN "npuload   " SH_RESET " Load NPU weights from file (npuload <name>)\n");
+    safe_puts("  " SH_CYAN "sync      " SH_RESET " Write cached blocks to disk\n");
+
     safe_puts("\n");
 
 }
@@ -0,0 +1,92 @@
+#include "apps/shell_utils.h"
+#include "kernel/prof.h"
+
+// ======================================================================================
+// COMANDO: PROF (Profiler por amostragem de PC)
+// ======================================================================================
+//
+//  prof             Estado (amostrando?, total de amostras)
+//  prof start       Zera o histograma e começa a amostrar
+//  prof stop        Para de amostrar
+//  prof dump        Lista o histograma pela UART
+//
+//  Formato do dump (capture a serial e rode tools/prof_report.py):
+//
+//    #PROF v1 samples=<n> lost=<n> hz=<amostras/s>
+//    #TASK <tid> <nome>
+//    #S <pc em hexa> <tid> <amostras>       (uma linha por entrada)
+//    #END
+//
+// ======================================================================================
+
+#define PROF_CHUNK 16
+
+static void prof_put_num(const char *label, uint32_t val) {
+    char buf[12];
+    uint_to_str(val, buf);
+    sys_puts(label);
+    sys_puts(buf);
+}
+
+static void prof_dump(void) {
+    prof_entry_t chunk[PROF_CHUNK];
+    task_info_t tasks[8];
+    char hex[11];
+
+    int ntasks = sys_get_tasks(tasks, 8);
+
+    // Segura a UART até o fim para o dump sair inteiro
+    while (sys_mutex_lock(&uart_mutex) == 0) sys_yield();
+
+    prof_put_num("\n#PROF v1 samples=", sys_prof(PROF_OP_TOTAL, 0, 0, 0));
+    prof_put_num(" lost=", sys_prof(PROF_OP_LOST, 0, 0, 0));
+    prof_put_num(" hz=", PROF_HZ);
+    sys_puts("\n");
+
+    for (int i = 0; i < ntasks; i++) {
+        prof_put_num("#TASK ", tasks[i].id);
+        sys_puts(" ");
+        sys_puts(tasks[i].name);
+        sys_puts("\n");
+    }
+
+    uint32_t idx = 0;
+    int n;
+    while ((n = sys_prof(PROF_OP_READ, idx, chunk, PROF_CHUNK)) > 0) {
+        for (int i = 0; i < n; i++) {
+            val_to_hex(chunk[i].pc, hex);
+            sys_puts("#S ");
+            sys_puts(hex);
+            prof_put_num(" ", chunk[i].tid);
+            prof_put_num(" ", chunk[i].count);
+            sys_puts("\n");
+        }
+        idx += n;
+    }
+    sys_puts("#END\n");
+
+    sys_mutex_unlock(&uart_mutex);
+}
+
+void cmd_prof(const char *args) {
+    if (args && sys_strcmp(args, "start") == 0) {
+        sys_prof(PROF_OP_START, 0, 0, 0);
+        safe_puts("prof: sampling.\n");
+    } else if (args && sys_strcmp(args, "stop") == 0) {
+        sys_prof(PROF_OP_STOP, 0, 0, 0);
+    } else if (args && sys_strcmp(args, "dump") == 0) {
+        // Não amostra o próprio dump
+        int running = sys_prof(PROF_OP_RUNNING, 0, 0, 0);
+        sys_prof(PROF_OP_STOP, 0, 0, 0);
+        prof_dump();
+        if (running) safe_puts("prof: stopped for dump, use 'prof start' to restart.\n");
+    } else if (!args) {
+        char buf[12];
+        safe_puts(sys_prof(PROF_OP_RUNNING, 0, 0, 0) ? "Profiler: running, " : "Profiler: stopped, ");
+        uint_to_str(sys_prof(PROF_OP_TOTAL, 0, 0, 0), buf);
+        safe_puts(buf);
+        safe_puts(" samples.\n");
+    } else {
+        safe_puts("Usage: prof [start|stop|dump]\n");
+    }
+}
@@ -11,8 +11,8 @@ void cmd_ps(const char *args) {
     task_info_t list[8]; 
     int count = sys_get_tasks(list, 8);
     
-    safe_puts(SH_BOLD "\n  PID   NAME            PRIO   STATE         SP          WAKE_TIME\n" SH_RESET);
-    safe_puts(SH_GRAY "  --------------------------------------------------------------------\n" SH_RESET);
+    safe_puts(SH_BOLD "\n  PID   NAME            PRIO   STATE         SP          WAKE_TIME   HEAP\n" SH_RESET);
+    safe_puts(SH_GRAY "  ---------------------------------------------------------------------------------\n" SH_RESET);
     
     for (int i = 0; i < count; i++) {
         char pid_str[4]; pid_str[0] = list[i].id + '0'; pid_str[1] = 0;
@@ -23,6 +23,7 @@ void cmd_ps(const char *args) {
             case 1: state_str = SH_CYAN   "RUNNING   " SH_RESET; break;
             case 2: state_str = SH_YELLOW "WAITING   " SH_RESET; break;
             case 3: state_str = SH_RED    "SUSPENDED " SH_RESET; break;
+            case 4: state_str = SH_GRAY   "DEAD      " SH_RESET; break;
             default: state_str =          "UNKNOWN   "         ; break;
         }
 
@@ -46,6 +47,16 @@ void cmd_ps(const char *args) {
         safe_puts(state_str); safe_puts("    ");
         safe_puts(sp_str); safe_puts("  ");
         safe_puts(list[i].state != 2 ? "-         " : wake_str);
+        safe_puts("  ");
+
+        // Uso de heap (bytes) e quota, se houver: "512/4096"
+        char heap_str[12];
+        uint_to_str(list[i].heap_used, heap_str);
+        safe_puts(heap_str);
+        if (list[i].heap_quota) {
+            uint_to_str(list[i].heap_quota, heap_str);
+            safe_puts("/"); safe_puts(heap_str);
+        }
 
         safe_puts("\n");
 
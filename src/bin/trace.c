@@ -0,0 +1,107 @@
+#include "apps/shell_utils.h"
+#include "hal/hal_timer.h"
+
+// ======================================================================================
+// COMANDO: TRACE (Linha do tempo de eventos do kernel)
+// ======================================================================================
+//
+//  trace            Estado do buffer
+//  trace start      Liga a gravação
+//  trace stop       Congela o buffer
+//  trace clear      Esvazia o buffer
+//  trace dump       Envia o buffer em binário pela UART
+//
+//  Formato do dump (capture a serial em arquivo e rode tools/trace2chrome.py):
+//
+//    #TRACE v1 count=<n> lost=<n> freq=<hz>\n
+//    #TASK <tid> <nome>\n              (uma linha por tarefa)
+//    #DATA\n
+//    <n registros trace_record_t, 8 bytes, little-endian>
+//    \n#END\n
+//
+//  O kernel precisa ser compilado com make TRACE=1.
+//
+// ======================================================================================
+
+#define TRACE_CHUNK 32
+
+static void trace_put_num(const char *label, uint32_t val) {
+    char buf[12];
+    uint_to_str(val, buf);
+    sys_puts(label);
+    sys_puts(buf);
+}
+
+static void trace_dump(void) {
+    trace_record_t chunk[TRACE_CHUNK];
+    task_info_t tasks[8];
+
+    // Congela o buffer durante o envio (os próprios sys_write não entram).
+    // Depois volta ao estado anterior: após 'trace stop' continua parado
+    int running = sys_trace(TRACE_OP_RUNNING, 0, 0, 0);
+    sys_trace(TRACE_OP_STOP, 0, 0, 0);
+
+    uint32_t count = sys_trace(TRACE_OP_COUNT, 0, 0, 0);
+    uint32_t lost  = sys_trace(TRACE_OP_LOST, 0, 0, 0);
+    int ntasks = sys_get_tasks(tasks, 8);
+
+    // Segura a UART o dump inteiro para ninguém intercalar texto no binário
+    while (sys_mutex_lock(&uart_mutex) == 0) sys_yield();
+
+    trace_put_num("\n#TRACE v1 count=", count);
+    trace_put_num(" lost=", lost);
+    trace_put_num(" freq=", hal_timer_get_freq());
+    sys_puts("\n");
+
+    for (int i = 0; i < ntasks; i++) {
+        trace_put_num("#TASK ", tasks[i].id);
+        sys_puts(" ");
+        sys_puts(tasks[i].name);
+        sys_puts("\n");
+    }
+
+    sys_puts("#DATA\n");
+    for (uint32_t idx = 0; idx < count; ) {
+        int n = sys_trace(TRACE_OP_READ, idx, chunk, TRACE_CHUNK);
+        if (n <= 0) break;
+
+        const uint8_t *p = (const uint8_t *)chunk;
+        for (uint32_t b = 0; b < n * sizeof(trace_record_t); b++) {
+            sys_write_char((char)p[b]);
+        }
+        idx += n;
+    }
+    sys_puts("\n#END\n");
+
+    sys_mutex_unlock(&uart_mutex);
+
+    if (running) sys_trace(TRACE_OP_START, 0, 0, 0);
+}
+
+void cmd_trace(const char *args) {
+    if (sys_trace(TRACE_OP_COUNT, 0, 0, 0) < 0) {
+        safe_puts("trace: kernel built without tracing (make TRACE=1).\n");
+        return;
+    }
+
+    if (args && sys_strcmp(args, "start") == 0) {
+        sys_trace(TRACE_OP_START, 0, 0, 0);
+    } else if (args && sys_strcmp(args, "stop") == 0) {
+        sys_trace(TRACE_OP_STOP, 0, 0, 0);
+    } else if (args && sys_strcmp(args, "clear") == 0) {
+        sys_trace(TRACE_OP_CLEAR, 0, 0, 0);
+    } else if (args && sys_strcmp(args, "dump") == 0) {
+        trace_dump();
+    } else if (!args || !*args) {
+        char buf[12];
+        safe_puts(sys_trace(TRACE_OP_RUNNING, 0, 0, 0) ? "Trace: running, " : "Trace: stopped, ");
+        uint_to_str(sys_trace(TRACE_OP_COUNT, 0, 0, 0), buf);
+        safe_puts(buf);
+        safe_puts(" events, ");
+        uint_to_str(sys_trace(TRACE_OP_LOST, 0, 0, 0), buf);
+        safe_puts(buf);
+        safe_puts(" overwritten.\n");
+    } else {
+        safe_puts("Usage: trace [start|stop|clear|dump]\n");
+    }
+}
@@ -23,6 +23,28 @@ void cmd_resume(const char *args) {
     else safe_puts("Error.\n");
 }
 
+void cmd_kill(const char *args) {
+    if(!args) { safe_puts("Usage: kill <pid>\n"); return; }
+    uint32_t pid = my_atoi(args);
+    if(sys_kill(pid) == 0) safe_puts("Task killed (heap reclaimed).\n");
+    else safe_puts("Error.\n");
+}
+
+// Define a quota de heap de uma tarefa (quota <pid> <bytes>, 0 = sem limite)
+void cmd_quota(const char *args) {
+    if(!args) { safe_puts("Usage: quota <pid> <bytes>\n"); return; }
+    uint32_t pid = my_atoi(args);
+
+    // Pula o PID e os espaços até o valor
+    while(*args >= '0' && *args <= '9') args++;
+    while(*args == ' ') args++;
+    if(!*args) { safe_puts("Usage: quota <pid> <bytes>\n"); return; }
+
+    uint32_t bytes = my_atoi(args);
+    if(sys_heap_quota(pid, bytes) == 0) safe_puts("Quota updated.\n");
+    else safe_puts("Error.\n");
+}
+
 // Memória Segura: O usuário pede um bloco, o kernel dá o endereço.
 // O usuário então usa 'poke' nesse endereço sabendo que é dele.
 void cmd_alloc(const char *args) {
@@ -1,4 +1,4 @@
-.section .text
+.section .text.init, "ax"
 .global _start
 
 _start:
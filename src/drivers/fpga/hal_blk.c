@@ -0,0 +1,10 @@
+#include "../../../include/hal/hal_blk.h"
+
+// ============================================================================
+// IMPLEMENTAÇÃO DA API
+// ============================================================================
+
+// Sem disco na FPGA: a RamFS fica na imagem linkada ou em RAM
+blkdev_t *hal_blk_probe(void) {
+    return 0;
+}
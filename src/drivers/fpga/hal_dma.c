@@ -5,7 +5,18 @@ int hal_dma_is_busy(void) {
     return (DMA->CTRL & DMA_CTRL_BUSY);
 }
 
-void hal_dma_memcpy(uint32_t src, uint32_t dst, uint32_t size_words, int fixed_dst) {
+void hal_dma_wait(void) {
+    // Bloqueio (Polling) até terminar
+    // Adicionamos NOPs para evitar starvation no barramento se a CPU 
+    // tentar ler status agressivamente enquanto o DMA tenta ler memória.
+    while(hal_dma_is_busy()) {
+        __asm__ volatile ("nop");
+        __asm__ volatile ("nop");
+        __asm__ volatile ("nop");
+    }
+}
+
+void hal_dma_start(uint32_t src, uint32_t dst, uint32_t size_words, int fixed_dst) {
     // 1. Segurança: Aguarda o DMA estar livre
     while(hal_dma_is_busy());
 
@@ -22,13 +33,9 @@ void hal_dma_memcpy(uint32_t src, uint32_t dst, uint32_t size_words, int fixed_d
 
     // 4. Dispara
     DMA->CTRL = cmd;
+}
 
-    // 5. Bloqueio (Polling) até terminar
-    // Adicionamos NOPs para evitar starvation no barramento se a CPU 
-    // tentar ler status agressivamente enquanto o DMA tenta ler memória.
-    while(hal_dma_is_busy()) {
-        __asm__ volatile ("nop");
-        __asm__ volatile ("nop");
-        __asm__ volatile ("nop");
-    }
-}
\ No newline at end of file
+void hal_dma_memcpy(uint32_t src, uint32_t dst, uint32_t size_words, int fixed_dst) {
+    hal_dma_start(src, dst, size_words, fixed_dst);
+    hal_dma_wait();
+}
@@ -0,0 +1,13 @@
+#include "../../../include/hal/hal_sys.h"
+
+// ============================================================================
+// IMPLEMENTAÇÃO DA API
+// ============================================================================
+
+void hal_sys_exit(uint32_t code) {
+    (void)code;
+
+    // Sem dispositivo de saída na FPGA: para a CPU (o reset volta ao boot)
+    asm volatile ("csrci mstatus, 8");
+    while (1) asm volatile ("wfi");
+}
@@ -0,0 +1,258 @@
+#include "../../../include/hal/hal_blk.h"
+#include "../../../include/kernel/mm.h"
+#include "../../../include/kernel/kmem.h"
+#include "memory_map.h"
+
+// ============================================================================
+// VIRTIO-BLK (TRANSPORTE MMIO)
+// ============================================================================
+// O QEMU 'virt' tem 8 transportes virtio-mmio; o disco é o que responde com
+// DeviceID 2. Aceita as duas versões do transporte:
+//   - 1 (legado, padrão do QEMU): fila num endereço de página (QueuePFN);
+//   - 2 (moderno, -global virtio-mmio.force-legacy=false): um registrador
+//     por área da fila e negociação de VIRTIO_F_VERSION_1.
+// Uma requisição por vez (3 descritores: cabeçalho, dados, status) e espera
+// por polling no anel 'used': sem interrupção, o chamador já espera mesmo.
+
+// Registradores (offsets)
+#define VIO_MAGIC            0x000   // "virt"
+#define VIO_VERSION          0x004
+#define VIO_DEVICE_ID        0x008
+#define VIO_DEV_FEATURES     0x010
+#define VIO_DEV_FEATURES_SEL 0x014
+#define VIO_DRV_FEATURES     0x020
+#define VIO_DRV_FEATURES_SEL 0x024
+#define VIO_GUEST_PAGE_SIZE  0x028   // Legado
+#define VIO_QUEUE_SEL        0x030
+#define VIO_QUEUE_NUM_MAX    0x034
+#define VIO_QUEUE_NUM        0x038
+#define VIO_QUEUE_ALIGN      0x03c   // Legado
+#define VIO_QUEUE_PFN        0x040   // Legado
+#define VIO_QUEUE_READY      0x044
+#define VIO_QUEUE_NOTIFY     0x050
+#define VIO_INT_STATUS       0x060
+#define VIO_INT_ACK          0x064
+#define VIO_STATUS           0x070
+#define VIO_QUEUE_DESC_LO    0x080
+#define VIO_QUEUE_DESC_HI    0x084
+#define VIO_QUEUE_AVAIL_LO   0x090
+#define VIO_QUEUE_AVAIL_HI   0x094
+#define VIO_QUEUE_USED_LO    0x0a0
+#define VIO_QUEUE_USED_HI    0x0a4
+#define VIO_CONFIG           0x100   // virtio-blk: capacidade (u64, setores)
+
+#define VIO_MAGIC_VALUE      0x74726976
+#define VIO_ID_BLOCK         2
+
+// Status do dispositivo
+#define VIO_S_ACK            1
+#define VIO_S_DRIVER         2
+#define VIO_S_DRIVER_OK      4
+#define VIO_S_FEATURES_OK    8
+
+// Features (palavra 0) e VERSION_1 (bit 32 = bit 0 da palavra 1)
+#define VIO_BLK_F_RO         (1u << 5)
+#define VIO_BLK_F_FLUSH      (1u << 9)
+#define VIO_F_VERSION_1_HI   (1u << 0)
+
+// Requisições
+#define VIO_BLK_T_IN         0
+#define VIO_BLK_T_OUT        1
+#define VIO_BLK_T_FLUSH      4
+
+#define VIO_DESC_F_NEXT      1
+#define VIO_DESC_F_WRITE     2       // O dispositivo escreve neste buffer
+
+#define SECTOR_SHIFT         9
+#define QUEUE_SIZE           4       // Só 3 descritores em uso
+#define QUEUE_ALIGN          64      // Anel 'used' (legado: QueueAlign)
+#define PAGE_SIZE            4096
+
+#define REG(off)             MMIO32(vio_base + (off))
+
+typedef struct {
+    uint64_t addr;
+    uint32_t len;
+    uint16_t flags;
+    uint16_t next;
+} vring_desc_t;
+
+typedef struct {
+    uint16_t flags;
+    uint16_t idx;
+    uint16_t ring[QUEUE_SIZE];
+    uint16_t used_event;
+} vring_avail_t;
+
+typedef struct {
+    uint16_t flags;
+    uint16_t idx;
+    struct { uint32_t id; uint32_t len; } ring[QUEUE_SIZE];
+    uint16_t avail_event;
+} vring_used_t;
+
+typedef struct {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t sector;
+} blk_req_t;
+
+// Layout da fila (o legado exige: descritores, avail, used alinhado)
+#define USED_OFFSET ((sizeof(vring_desc_t) * QUEUE_SIZE + sizeof(vring_avail_t) + \
+                      QUEUE_ALIGN - 1) & ~(QUEUE_ALIGN - 1))
+
+static uint32_t       vio_base;
+static vring_desc_t  *desc;
+static vring_avail_t *avail;
+static volatile vring_used_t *used;
+static uint16_t       used_seen;
+static uint32_t       features;
+
+static blk_req_t        req;
+static volatile uint8_t req_status;
+
+static blkdev_t blk_dev;
+
+static inline void vio_fence(void) {
+    __asm__ volatile ("fence rw, rw" ::: "memory");
+}
+
+// Uma requisição completa: monta a cadeia, avisa o dispositivo e espera
+static int vio_request(uint32_t type, uint32_t sector, void *buf, uint32_t len) {
+    req.type     = type;
+    req.reserved = 0;
+    req.sector   = sector;
+    req_status   = 0xFF;
+
+    desc[0].addr  = (uint32_t)&req;
+    desc[0].len   = sizeof(req);
+    desc[0].flags = VIO_DESC_F_NEXT;
+    desc[0].next  = 1;
+
+    uint16_t last = 1;
+    if (len) {
+        desc[1].addr  = (uint32_t)buf;
+        desc[1].len   = len;
+        desc[1].flags = VIO_DESC_F_NEXT | (type == VIO_BLK_T_IN ? VIO_DESC_F_WRITE : 0);
+        desc[1].next  = 2;
+        last = 2;
+    } else {
+        desc[0].next = 2; // FLUSH: sem dados
+    }
+    desc[last].addr  = (uint32_t)&req_status;
+    desc[last].len   = 1;
+    desc[last].flags = VIO_DESC_F_WRITE;
+    desc[last].next  = 0;
+
+    avail->ring[avail->idx & (QUEUE_SIZE - 1)] = 0;
+    vio_fence(); // Descritores visíveis antes do novo idx
+    avail->idx++;
+    vio_fence();
+    REG(VIO_QUEUE_NOTIFY) = 0;
+
+    while (used->idx == used_seen) { }
+    vio_fence(); // Status e dados lidos só depois do idx
+    used_seen = used->idx;
+    REG(VIO_INT_ACK) = REG(VIO_INT_STATUS);
+
+    return req_status == 0 ? 0 : -1;
+}
+
+static int vio_read(blkdev_t *dev, uint32_t blk, void *buf, uint32_t count) {
+    if (blk + count > dev->block_count) return -1;
+    return vio_request(VIO_BLK_T_IN, blk, buf, count << SECTOR_SHIFT);
+}
+
+static int vio_write(blkdev_t *dev, uint32_t blk, const void *buf, uint32_t count) {
+    if (blk + count > dev->block_count || (features & VIO_BLK_F_RO)) return -1;
+    return vio_request(VIO_BLK_T_OUT, blk, (void *)buf, count << SECTOR_SHIFT);
+}
+
+static int vio_flush(blkdev_t *dev) {
+    (void)dev;
+    if (!(features & VIO_BLK_F_FLUSH)) return 0; // Sem cache de escrita no host
+    return vio_request(VIO_BLK_T_FLUSH, 0, 0, 0);
+}
+
+// Negocia features e configura a fila 0. 0 = ok.
+static int vio_setup(uint32_t version) {
+    REG(VIO_STATUS) = 0; // Reset
+    REG(VIO_STATUS) = VIO_S_ACK | VIO_S_DRIVER;
+
+    REG(VIO_DEV_FEATURES_SEL) = 0;
+    features = REG(VIO_DEV_FEATURES) & (VIO_BLK_F_RO | VIO_BLK_F_FLUSH);
+    REG(VIO_DRV_FEATURES_SEL) = 0;
+    REG(VIO_DRV_FEATURES) = features;
+
+    if (version >= 2) {
+        REG(VIO_DEV_FEATURES_SEL) = 1;
+        if (!(REG(VIO_DEV_FEATURES) & VIO_F_VERSION_1_HI)) return -1;
+        REG(VIO_DRV_FEATURES_SEL) = 1;
+        REG(VIO_DRV_FEATURES) = VIO_F_VERSION_1_HI;
+
+        REG(VIO_STATUS) = VIO_S_ACK | VIO_S_DRIVER | VIO_S_FEATURES_OK;
+        if (!(REG(VIO_STATUS) & VIO_S_FEATURES_OK)) return -1;
+    } else {
+        REG(VIO_GUEST_PAGE_SIZE) = PAGE_SIZE;
+    }
+
+    REG(VIO_QUEUE_SEL) = 0;
+    if (REG(VIO_QUEUE_NUM_MAX) < QUEUE_SIZE) return -1;
+
+    // Fila numa página só (o legado a endereça pelo número da página)
+    uint8_t *queue = (uint8_t *)kmalloc_aligned(PAGE_SIZE, PAGE_SIZE);
+    if (!queue) return -1;
+    kmemset(queue, 0, PAGE_SIZE);
+    desc  = (vring_desc_t *)queue;
+    avail = (vring_avail_t *)(queue + sizeof(vring_desc_t) * QUEUE_SIZE);
+    used  = (volatile vring_used_t *)(queue + USED_OFFSET);
+    used_seen = 0;
+
+    REG(VIO_QUEUE_NUM) = QUEUE_SIZE;
+    if (version >= 2) {
+        REG(VIO_QUEUE_DESC_LO)  = (uint32_t)desc;
+        REG(VIO_QUEUE_DESC_HI)  = 0;
+        REG(VIO_QUEUE_AVAIL_LO) = (uint32_t)avail;
+        REG(VIO_QUEUE_AVAIL_HI) = 0;
+        REG(VIO_QUEUE_USED_LO)  = (uint32_t)used;
+        REG(VIO_QUEUE_USED_HI)  = 0;
+        REG(VIO_QUEUE_READY)    = 1;
+    } else {
+        REG(VIO_QUEUE_ALIGN) = QUEUE_ALIGN;
+        REG(VIO_QUEUE_PFN)   = (uint32_t)queue >> 12;
+    }
+
+    REG(VIO_STATUS) = REG(VIO_STATUS) | VIO_S_DRIVER_OK;
+    return 0;
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DA API
+// ============================================================================
+
+blkdev_t *hal_blk_probe(void) {
+    for (uint32_t i = 0; i < VIRTIO_MMIO_COUNT; i++) {
+        vio_base = VIRTIO_MMIO_BASE + i * VIRTIO_MMIO_STRIDE;
+        if (REG(VIO_MAGIC) != VIO_MAGIC_VALUE || REG(VIO_DEVICE_ID) != VIO_ID_BLOCK) continue;
+
+        if (vio_setup(REG(VIO_VERSION)) < 0) {
+            REG(VIO_STATUS) = 0;
+            return 0;
+        }
+
+        // Capacidade em setores (os 32 bits altos não cabem no blkdev)
+        uint32_t sectors = REG(VIO_CONFIG);
+        if (REG(VIO_CONFIG + 4)) sectors = 0xFFFFFFFFu;
+
+        blk_dev.name        = "virtio-blk";
+        blk_dev.block_size  = 1u << SECTOR_SHIFT;
+        blk_dev.block_count = sectors;
+        blk_dev.mem         = 0;
+        blk_dev.read        = vio_read;
+        blk_dev.write       = vio_write;
+        blk_dev.flush       = vio_flush;
+        blk_dev.priv        = 0;
+        return &blk_dev;
+    }
+    return 0;
+}
@@ -12,4 +12,11 @@ void hal_dma_memcpy(uint32_t src, uint32_t dst, uint32_t size, int fixed) {
         if(fixed) *d = *s++;
         else *d++ = *s++;
     }
-}
\ No newline at end of file
+}
+
+// Sem DMA no QEMU: a "transferência" termina antes de retornar
+void hal_dma_start(uint32_t src, uint32_t dst, uint32_t size, int fixed) {
+    hal_dma_memcpy(src, dst, size, fixed);
+}
+
+void hal_dma_wait(void) {}
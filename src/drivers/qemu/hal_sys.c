@@ -0,0 +1,18 @@
+#include "../../../include/hal/hal_sys.h"
+#include "memory_map.h" // Acesso aos registradores do QEMU
+
+// ============================================================================
+// IMPLEMENTAÇÃO DA API
+// ============================================================================
+
+void hal_sys_exit(uint32_t code) {
+    // O QEMU termina com 0 para PASS e com 'code' para FAIL
+    if (code == 0) {
+        TEST_FINISHER = TEST_FINISHER_PASS;
+    } else {
+        TEST_FINISHER = (code << 16) | TEST_FINISHER_FAIL;
+    }
+
+    // Não deveria chegar aqui (máquina sem o dispositivo)
+    while (1) asm volatile ("wfi");
+}
@@ -18,6 +18,10 @@
 #define UART0_BASE      0x10000000
 #define CLINT_BASE      0x02000000
 #define PLIC_BASE       0x0c000000
+#define TEST_BASE       0x00100000  // sifive_test (finisher: sai do QEMU)
+#define VIRTIO_MMIO_BASE   0x10001000  // 8 transportes virtio-mmio, um a cada 4KB
+#define VIRTIO_MMIO_STRIDE 0x1000
+#define VIRTIO_MMIO_COUNT  8
 
 // Endereços Fictícios (Stubs) para periféricos que não existem no QEMU
 #define NPU_BASE        0x90000000 
@@ -47,6 +51,13 @@
 #define PLIC_PENDING        MMIO32(PLIC_PENDING_BASE)
 #define PLIC_ENABLE         MMIO32(PLIC_ENABLE_BASE)
 
+/* --- SIFIVE TEST (FINISHER) --- */
+// Escrever aqui encerra o QEMU: 0x5555 = sucesso, (código << 16) | 0x3333 = falha
+
+#define TEST_FINISHER       MMIO32(TEST_BASE)
+#define TEST_FINISHER_PASS  0x5555
+#define TEST_FINISHER_FAIL  0x3333
+
 /* --- UART 16550 REGISTERS --- */
 // A UART do QEMU é uma NS16550A padrão (8 bits, offsets padrão)
 
@@ -5,7 +5,6 @@
 #include "hal/hal_uart.h" 
 #include "hal/hal_irq.h"  
 #include "hal/hal_plic.h" 
-#include "util/circular_buffer.h"
 #include "kernel/logger.h"
 
 // ======================================================================================
@@ -16,7 +15,7 @@
 mutex_t uart_mutex;
 
 // Buffer do teclado
-cbuf_t  rx_buffer;
+rx_ring_t rx_buffer;
 
 // ======================================================================================
 // INICIALIZAÇÃO
@@ -28,7 +27,7 @@ void apps_init(void) {
     
     // 1. Inicializa mutexes e buffers
     mutex_init(&uart_mutex);
-    cbuf_init(&rx_buffer);
+    rx_ring_init(&rx_buffer);
 
     // 2. Configura a interrupção da UART no PLIC
     uint8_t plic_uart_id = get_uart_irq_id();
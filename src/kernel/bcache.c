@@ -0,0 +1,98 @@
+#include "../../include/kernel/bcache.h"
+#include "../../include/kernel/mm.h"
+#include "../../include/kernel/kmem.h"
+#include "../../include/hal/hal_uart.h"
+
+// ============================================================================
+// CACHE DE BLOCOS (LRU, write-back)
+// ============================================================================
+// Poucos buffers (BCACHE_SLOTS): busca linear e LRU por carimbo de uso são
+// mais baratos que hash + lista encadeada nesse tamanho. Os buffers saem de
+// um único bloco alinhado em KMALLOC_DMA_ALIGN (o driver pode fazer DMA
+// direto neles).
+
+int bcache_init(bcache_t *c, blkdev_t *dev, uint32_t bsize) {
+    // bsize = dev->block_size << shift (sem '/': vira laço de shifts)
+    uint32_t shift = 0;
+    if (dev->block_size == 0) return -1;
+    while (shift < 16 && (dev->block_size << shift) < bsize) shift++;
+    if ((dev->block_size << shift) != bsize) return -1;
+
+    uint8_t *mem = (uint8_t *)kmalloc_aligned(bsize * BCACHE_SLOTS, KMALLOC_DMA_ALIGN);
+    if (!mem) return -1;
+
+    c->dev        = dev;
+    c->bsize      = bsize;
+    c->shift      = shift;
+    c->clock      = 0;
+    c->hits       = 0;
+    c->misses     = 0;
+    c->writebacks = 0;
+    for (int i = 0; i < BCACHE_SLOTS; i++) {
+        c->buf[i].valid = 0;
+        c->buf[i].dirty = 0;
+        c->buf[i].stamp = 0;
+        c->buf[i].data  = mem;
+        mem += bsize;
+    }
+    return 0;
+}
+
+void bcache_free(bcache_t *c) {
+    if (!c->dev) return;
+    kfree(c->buf[0].data);
+    c->dev = 0;
+}
+
+static int buf_writeback(bcache_t *c, bcache_buf_t *b) {
+    if (c->dev->write(c->dev, b->blk << c->shift, b->data, 1u << c->shift) < 0) return -1;
+    b->dirty = 0;
+    c->writebacks++;
+    return 0;
+}
+
+uint8_t *bcache_get(bcache_t *c, uint32_t blk, int write) {
+    bcache_buf_t *victim = &c->buf[0];
+
+    for (int i = 0; i < BCACHE_SLOTS; i++) {
+        bcache_buf_t *b = &c->buf[i];
+        if (b->valid && b->blk == blk) {
+            c->hits++;
+            b->stamp = ++c->clock;
+            if (write) b->dirty = 1;
+            return b->data;
+        }
+        // Vítima: um buffer vazio, senão o de uso mais antigo
+        if (!b->valid) { if (victim->valid) victim = b; }
+        else if (victim->valid && b->stamp < victim->stamp) victim = b;
+    }
+
+    // Erros voltam como NULL: o buffer sujo que não foi gravado continua
+    // no cache (sujo), e um bloco que não foi lido não vira um buffer válido
+    // (zeros no lugar dele seriam gravados por cima do bloco real)
+    c->misses++;
+    if (victim->valid && victim->dirty && buf_writeback(c, victim) < 0) {
+        hal_uart_puts("[BCACHE] Write-back failed.\n\r");
+        return 0;
+    }
+
+    victim->valid = 0;
+    if (c->dev->read(c->dev, blk << c->shift, victim->data, 1u << c->shift) < 0) {
+        hal_uart_puts("[BCACHE] Read failed.\n\r");
+        return 0;
+    }
+    victim->valid = 1;
+    victim->dirty = (uint8_t)write;
+    victim->blk   = blk;
+    victim->stamp = ++c->clock;
+    return victim->data;
+}
+
+int bcache_sync(bcache_t *c) {
+    int res = 0;
+    for (int i = 0; i < BCACHE_SLOTS; i++) {
+        bcache_buf_t *b = &c->buf[i];
+        if (b->valid && b->dirty && buf_writeback(c, b) < 0) res = -1;
+    }
+    return res;
+}
@@ -0,0 +1,33 @@
+#include "../../include/kernel/blkdev.h"
+#include "../../include/kernel/kmem.h"
+
+// ============================================================================
+// BACKEND: DISCO EM RAM
+// ============================================================================
+// Mapeado em memória: a RamFS usa 'mem' direto e não chama read/write. Eles
+// existem para quem trata o disco como dispositivo de blocos qualquer.
+
+#define RAM_BLOCK_SHIFT 9   // Blocos de 512 bytes (setor)
+
+static int ram_read(blkdev_t *dev, uint32_t blk, void *buf, uint32_t count) {
+    if (blk + count > dev->block_count) return -1;
+    kmemcpy(buf, &dev->mem[blk << RAM_BLOCK_SHIFT], count << RAM_BLOCK_SHIFT);
+    return 0;
+}
+
+static int ram_write(blkdev_t *dev, uint32_t blk, const void *buf, uint32_t count) {
+    if (blk + count > dev->block_count) return -1;
+    kmemcpy(&dev->mem[blk << RAM_BLOCK_SHIFT], buf, count << RAM_BLOCK_SHIFT);
+    return 0;
+}
+
+void blkdev_ram_init(blkdev_t *dev, uint8_t *mem, uint32_t size) {
+    dev->name        = "ram";
+    dev->block_size  = 1u << RAM_BLOCK_SHIFT;
+    dev->block_count = size >> RAM_BLOCK_SHIFT;
+    dev->mem         = mem;
+    dev->read        = ram_read;
+    dev->write       = ram_write;
+    dev->flush       = 0;
+    dev->priv        = 0;
+}
@@ -0,0 +1,43 @@
+#include "../../include/kernel/bootlog.h"
+#include "../../include/hal/hal_timer.h"
+
+// ============================================================================
+// LOG DE BOOT
+// ============================================================================
+// Só grava (nome, ciclos) em RAM: nada de UART no caminho crítico.
+// A formatação fica para o comando 'bootlog' do shell.
+
+typedef struct {
+    const char *phase;
+    uint64_t    cycles;
+} boot_event_t;
+
+static boot_event_t boot_events[BOOTLOG_MAX];
+static int boot_event_count = 0;
+
+void boot_mark(const char *phase) {
+    if (boot_event_count >= BOOTLOG_MAX) return;
+    boot_events[boot_event_count].phase  = phase;
+    boot_events[boot_event_count].cycles = hal_timer_get_cycles();
+    boot_event_count++;
+}
+
+uint64_t bootlog_elapsed(void) {
+    if (boot_event_count == 0) return 0;
+    return hal_timer_get_cycles() - boot_events[0].cycles;
+}
+
+int bootlog_get(bootlog_entry_t *buf, int max_count) {
+    int count = 0;
+    for (int i = 0; i < boot_event_count && count < max_count; i++) {
+        // Nome truncado e sempre terminado em 0
+        int j = 0;
+        for (; j < (int)sizeof(buf[i].name) - 1 && boot_events[i].phase[j]; j++) {
+            buf[i].name[j] = boot_events[i].phase[j];
+        }
+        buf[i].name[j] = 0;
+        buf[i].cycles = boot_events[i].cycles;
+        count++;
+    }
+    return count;
+}
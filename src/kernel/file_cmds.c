@@ -2,6 +2,8 @@
 #include "../../include/apps/commands.h"
 #include "../../include/apps/shell_utils.h"
 #include "../../include/sys/syscall.h"
+#include "../../include/kernel/fs.h"
+#include "../../include/hal/hal_npu.h"
 
 // ============================================================================
 // VARIÁVEIS GLOBAIS
@@ -16,35 +18,119 @@ extern volatile int g_editor_mode;
 int sys_fs_create(const char *name) {
     int ret; 
     asm volatile("li a7, %1; mv a0, %2; ecall; mv %0, a0" 
-                 : "=r"(ret) : "i"(SYS_FS_CREATE), "r"(name) : "a0", "a7");
+                 : "=r"(ret) : "i"(SYS_FS_CREATE), "r"(name) : "a0", "a7", "memory");
     return ret;
 }
 
 int sys_fs_write(const char *name, const char *data, int len) {
     int ret; 
     asm volatile("li a7, %1; mv a0, %2; mv a1, %3; mv a2, %4; ecall; mv %0, a0" 
-                 : "=r"(ret) : "i"(SYS_FS_WRITE), "r"(name), "r"(data), "r"(len) : "a0", "a1", "a2", "a7");
+                 : "=r"(ret) : "i"(SYS_FS_WRITE), "r"(name), "r"(data), "r"(len) : "a0", "a1", "a2", "a7", "memory");
     return ret;
 }
 
 int sys_fs_read(const char *name, char *buf, int max) {
     int ret; 
     asm volatile("li a7, %1; mv a0, %2; mv a1, %3; mv a2, %4; ecall; mv %0, a0" 
-                 : "=r"(ret) : "i"(SYS_FS_READ), "r"(name), "r"(buf), "r"(max) : "a0", "a1", "a2", "a7");
+                 : "=r"(ret) : "i"(SYS_FS_READ), "r"(name), "r"(buf), "r"(max) : "a0", "a1", "a2", "a7", "memory");
     return ret;
 }
 
-int sys_fs_list(char *buf, int max) {
+int sys_fs_opendir(const char *path) {
     int ret; 
-    asm volatile("li a7, %1; mv a0, %2; mv a1, %3; ecall; mv %0, a0" 
-                 : "=r"(ret) : "i"(SYS_FS_LIST), "r"(buf), "r"(max) : "a0", "a1", "a7");
+    asm volatile("li a7, %1; mv a0, %2; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_OPENDIR), "r"(path) : "a0", "a7", "memory");
+    return ret;
+}
+
+int sys_fs_readdir(int fd, fs_dirent_t *out, int max) {
+    int ret; 
+    asm volatile("li a7, %1; mv a0, %2; mv a1, %3; mv a2, %4; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_READDIR), "r"(fd), "r"(out), "r"(max) : "a0", "a1", "a2", "a7", "memory");
     return ret;
 }
 
 int sys_fs_delete(const char *name) {
     int ret; 
     asm volatile("li a7, %1; mv a0, %2; ecall; mv %0, a0" 
-                 : "=r"(ret) : "i"(SYS_FS_DELETE), "r"(name) : "a0", "a7");
+                 : "=r"(ret) : "i"(SYS_FS_DELETE), "r"(name) : "a0", "a7", "memory");
+    return ret;
+}
+
+int sys_fs_statfs(fs_statfs_t *st) {
+    int ret; 
+    asm volatile("li a7, %1; mv a0, %2; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_STATFS), "r"(st) : "a0", "a7", "memory");
+    return ret;
+}
+
+int sys_fs_open(const char *name, int flags) {
+    int ret; 
+    asm volatile("li a7, %1; mv a0, %2; mv a1, %3; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_OPEN), "r"(name), "r"(flags) : "a0", "a1", "a7", "memory");
+    return ret;
+}
+
+int sys_fs_close(int fd) {
+    int ret; 
+    asm volatile("li a7, %1; mv a0, %2; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_CLOSE), "r"(fd) : "a0", "a7", "memory");
+    return ret;
+}
+
+int sys_fs_fread(int fd, char *buf, int len) {
+    int ret; 
+    asm volatile("li a7, %1; mv a0, %2; mv a1, %3; mv a2, %4; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_FREAD), "r"(fd), "r"(buf), "r"(len) : "a0", "a1", "a2", "a7", "memory");
+    return ret;
+}
+
+int sys_fs_fwrite(int fd, const char *data, int len) {
+    int ret; 
+    asm volatile("li a7, %1; mv a0, %2; mv a1, %3; mv a2, %4; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_FWRITE), "r"(fd), "r"(data), "r"(len) : "a0", "a1", "a2", "a7", "memory");
+    return ret;
+}
+
+int sys_fs_lseek(int fd, int off, int whence) {
+    int ret; 
+    asm volatile("li a7, %1; mv a0, %2; mv a1, %3; mv a2, %4; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_LSEEK), "r"(fd), "r"(off), "r"(whence) : "a0", "a1", "a2", "a7", "memory");
+    return ret;
+}
+
+int sys_fs_map(const char *name, const uint8_t **ptr, uint32_t *len) {
+    int ret; 
+    asm volatile("li a7, %1; mv a0, %2; mv a1, %3; mv a2, %4; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_MAP), "r"(name), "r"(ptr), "r"(len) : "a0", "a1", "a2", "a7", "memory");
+    return ret;
+}
+
+int sys_fs_unmap(const uint8_t *ptr) {
+    int ret; 
+    asm volatile("li a7, %1; mv a0, %2; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_UNMAP), "r"(ptr) : "a0", "a7", "memory");
+    return ret;
+}
+
+int sys_fs_sync(void) {
+    int ret; 
+    asm volatile("li a7, %1; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_SYNC) : "a0", "a7", "memory");
+    return ret;
+}
+
+int sys_fs_mkdir(const char *path) {
+    int ret; 
+    asm volatile("li a7, %1; mv a0, %2; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_MKDIR), "r"(path) : "a0", "a7", "memory");
+    return ret;
+}
+
+int sys_fs_rmdir(const char *path) {
+    int ret; 
+    asm volatile("li a7, %1; mv a0, %2; ecall; mv %0, a0" 
+                 : "=r"(ret) : "i"(SYS_FS_RMDIR), "r"(path) : "a0", "a7", "memory");
     return ret;
 }
 
@@ -52,29 +138,46 @@ int sys_fs_delete(const char *name) {
 // COMANDOS DO SHELL
 // ============================================================================
 
-// --- LS: Lista arquivos ---
+// --- LS: Lista arquivos (ls [diretório]) ---
+// Lotes de LS_BATCH registros pelo readdir: a pilha não cresce com o
+// tamanho do diretório.
+#define LS_BATCH 8
+
 void cmd_ls(const char *args) {
-    (void)args;
-    char buf[256];
-    
-    // Limpa buffer
-    for(int i=0;i<256;i++) buf[i]=0;
+    static const char pad[FS_MAX_NAME + 1] = "                            "; // FS_MAX_NAME espaços
+    fs_dirent_t ents[LS_BATCH];
+    char num[11];
 
-    int res = sys_fs_list(buf, 256);
-    
-    if (res < 0) {
-        safe_puts(SH_RED "Error reading directory.\n" SH_RESET);
+    int fd = sys_fs_opendir((args && *args) ? args : 0);
+    if (fd < 0) {
+        safe_puts(SH_RED "Error: not a directory.\n" SH_RESET);
         return;
     }
 
     safe_puts(SH_BOLD "\n  FILES:\n" SH_RESET);
     safe_puts(SH_GRAY "  -------------------\n" SH_RESET);
     
-    if (buf[0] == 0) {
-        safe_puts("  (empty)\n");
-    } else {
-        safe_puts(buf); // O Kernel já formata com \n
+    uint32_t count = 0;
+    int n;
+    while ((n = sys_fs_readdir(fd, ents, LS_BATCH)) > 0) {
+        for (int i = 0; i < n; i++) {
+            // Nome (diretório com '/') alinhado em FS_MAX_NAME colunas, depois o tamanho
+            int len = 0;
+            while (ents[i].name[len]) len++;
+            safe_puts("  ");
+            safe_puts(ents[i].name);
+            if (ents[i].type == FS_TYPE_DIR) { safe_puts("/"); len++; }
+            if (len < FS_MAX_NAME) safe_puts(&pad[len]);
+
+            if (ents[i].type == FS_TYPE_DIR) safe_puts(SH_GRAY "<dir>" SH_RESET);
+            else { uint_to_str(ents[i].size, num); safe_puts(num); safe_puts(" B"); }
+            safe_puts("\n");
+        }
+        count += n;
     }
+    sys_fs_close(fd);
+
+    if (count == 0) safe_puts("  (empty)\n");
     safe_puts("\n");
 }
 
@@ -88,6 +191,7 @@ void cmd_touch(const char *args) {
     int res = sys_fs_create(args);
     if (res == 0) safe_puts("File created.\n");
     else if (res == -1) safe_puts("Error: File exists.\n");
+    else if (res == -6) safe_puts("Error: Parent directory not found.\n");
     else safe_puts("Error: Disk full or invalid name.\n");
 }
 
@@ -100,6 +204,8 @@ void cmd_rm(const char *args) {
 
     int res = sys_fs_delete(args);
     if (res == 0) safe_puts("File deleted.\n");
+    else if (res == -2) safe_puts("Error: Is a directory (use rmdir).\n");
+    else if (res == -3) safe_puts("Error: File is open or mapped.\n");
     else safe_puts("Error: File not found.\n");
 }
 
@@ -110,28 +216,40 @@ void cmd_cat(const char *args) {
         return;
     }
 
-    char buf[512]; // Buffer temporário na pilha
-    int len = sys_fs_read(args, buf, 511);
-    
-    if (len < 0) {
+    int fd = sys_fs_open(args, FS_O_READ);
+    if (fd < 0) {
         safe_puts("File not found.\n");
-    } else {
+        return;
+    }
+
+    // Lê em pedaços pelo descritor: qualquer tamanho com 128B de pilha
+    char buf[129];
+    int len;
+    while ((len = sys_fs_fread(fd, buf, sizeof(buf) - 1)) > 0) {
         buf[len] = 0; // Garante fim da string
         safe_puts(buf);
-        safe_puts("\n");
     }
+    sys_fs_close(fd);
+    safe_puts("\n");
 }
 
 // --- WRITE: Escreve texto simples (Ex: write notas.txt OlaMundo) ---
+// 'write -a <file> <data>' anexa uma linha ao fim sem reescrever o arquivo
 void cmd_write_file(const char *args) {
-    if (!args) { safe_puts("Usage: write <file> <data>\n"); return; }
+    if (!args) { safe_puts("Usage: write [-a] <file> <data>\n"); return; }
+
+    int append = 0;
+    if (args[0] == '-' && args[1] == 'a' && args[2] == ' ') {
+        append = 1;
+        args += 3;
+    }
     
-    char name[32];
+    char name[64]; // Caminho (dir/arquivo)
     char *data = NULL;
     
     // Parser manual simples para separar nome e conteúdo
     int i=0;
-    while(args[i] && args[i] != ' ' && i < 31) {
+    while(args[i] && args[i] != ' ' && i < 63) {
         name[i] = args[i];
         i++;
     }
@@ -147,15 +265,62 @@ void cmd_write_file(const char *args) {
 
     // Calcula tamanho da string de dados
     int len = 0; while(data[len]) len++;
-    
-    int res = sys_fs_write(name, data, len);
-    if (res >= 0) safe_puts("Written.\n");
+
+    // Sobrescrever: cópia na escrita (se falhar, o arquivo fica como estava)
+    if (!append) {
+        int res = sys_fs_write(name, data, len);
+        if (res == -1 && sys_fs_create(name) == 0) res = sys_fs_write(name, data, len);
+
+        if (res == len) safe_puts("Written.\n");
+        else if (res == -1) safe_puts("Error: Cannot create file.\n");
+        else if (res == -2) safe_puts("Error: File too large.\n");
+        else if (res == -3) safe_puts("Error: File is mapped.\n");
+        else if (res == -4) safe_puts("Error: Disk full (file unchanged).\n");
+        else if (res == -7) safe_puts("Error: I/O error (file unchanged).\n");
+        else safe_puts("Error writing file.\n");
+        return;
+    }
+
+    // Anexar: no lugar, pelo descritor
+    int fd = sys_fs_open(name, FS_O_WRITE | FS_O_CREATE | FS_O_APPEND);
+    if (fd < 0) { safe_puts("Error opening file.\n"); return; }
+
+    int res = sys_fs_fwrite(fd, data, len);
+    if (res == len) {
+        int nl = sys_fs_fwrite(fd, "\n", 1);
+        if (nl > 0) res += nl;
+    }
+    sys_fs_close(fd);
+
+    if (res == len + 1) safe_puts("Written.\n");
+    else if (res >= 0) safe_puts("Error: Partial write (disk full?).\n");
+    else if (res == -7) safe_puts("Error: I/O error.\n");
     else safe_puts("Error writing file (Disk full?).\n");
 }
 
-static char edit_buffer[2048]; // 2KB para edição 
+// Buffer de edição dinâmico: começa pequeno e cresce (sys_realloc) conforme
+// o texto aumenta. Quando o bloco vizinho está livre, cresce sem cópia.
+#define EDIT_INITIAL_CAP 256
+
+static char *edit_buffer = NULL;
+static int   edit_cap    = 0;
 extern char shell_getc(void);  // A função que criamos acima
 
+// Garante espaço para 'len' caracteres + terminador (dobra a capacidade)
+static int edit_reserve(int len) {
+    if (len < edit_cap) return 1;
+
+    int cap = edit_cap ? edit_cap : EDIT_INITIAL_CAP;
+    while (cap <= len) cap <<= 1;
+
+    char *p = (char*)sys_realloc(edit_buffer, cap);
+    if (!p) return 0; // OOM/quota: o buffer antigo continua válido
+
+    edit_buffer = p;
+    edit_cap = cap;
+    return 1;
+}
+
 // Helper: Imprime buffer convertendo \n em \r\n para o terminal não fazer "escada"
 static void safe_print_buffer(const char *buf) {
     while (*buf) {
@@ -187,14 +352,39 @@ static void nano_redraw(const char *filename, const char *status_msg) {
     safe_print_buffer(edit_buffer);
 }
 
+// Helper: Grava o buffer (criando o arquivo no primeiro save) e retorna a
+// mensagem de status. Cópia na escrita: se falhou, o arquivo fica como estava.
+static const char *edit_save(const char *filename, int len) {
+    int res = sys_fs_write(filename, edit_buffer, len);
+    if (res == -1) {
+        int cr = sys_fs_create(filename);
+        if (cr == -1) return SH_RED "  [NOT SAVED: IS A DIRECTORY]" SH_RESET;
+        if (cr == -4) return SH_RED "  [NOT SAVED: INVALID NAME]" SH_RESET;
+        if (cr == -6) return SH_RED "  [NOT SAVED: PARENT DIRECTORY NOT FOUND]" SH_RESET;
+        if (cr < 0)   return SH_RED "  [NOT SAVED: CANNOT CREATE FILE]" SH_RESET;
+        res = sys_fs_write(filename, edit_buffer, len);
+    }
+
+    if (res == len) return SH_GREEN "  [SAVED]" SH_RESET;
+    if (res == -2)  return SH_RED "  [NOT SAVED: FILE TOO LARGE]" SH_RESET;
+    if (res == -3)  return SH_RED "  [NOT SAVED: FILE MAPPED]" SH_RESET;
+    if (res == -4)  return SH_RED "  [NOT SAVED: DISK FULL]" SH_RESET;
+    if (res == -7)  return SH_RED "  [NOT SAVED: I/O ERROR]" SH_RESET;
+    return SH_RED "  [NOT SAVED]" SH_RESET;
+}
+
 void cmd_edit(const char *args) {
     if (!args || !*args) { safe_puts("Usage: edit <file>\n"); return; }
 
+    if (!edit_reserve(0)) { safe_puts("Error: Out of memory.\n"); return; }
+
     g_editor_mode = 1; // Pausa Uptime
 
-    // Carrega arquivo e limpa buffer
-    for(int i=0; i<2048; i++) edit_buffer[i] = 0;
-    int len = sys_fs_read(args, edit_buffer, 2047);
+    // Carrega arquivo: se encheu o buffer, cresce e lê de novo
+    int len = sys_fs_read(args, edit_buffer, edit_cap - 1);
+    while (len == edit_cap - 1 && edit_reserve(edit_cap)) {
+        len = sys_fs_read(args, edit_buffer, edit_cap - 1);
+    }
     if (len < 0) len = 0;
     edit_buffer[len] = 0;
 
@@ -208,8 +398,7 @@ void cmd_edit(const char *args) {
         
         // --- SALVAR: Ctrl+W ---
         else if (c == 23) {
-            sys_fs_write(args, edit_buffer, len);
-            nano_redraw(args, SH_GREEN "  [SAVED]" SH_RESET);
+            nano_redraw(args, edit_save(args, len));
         }
         
         // --- BACKSPACE ---
@@ -231,7 +420,7 @@ void cmd_edit(const char *args) {
         
         // --- ENTER ---
         else if (c == '\r') {
-            if (len < 2047) {
+            if (edit_reserve(len + 1)) {
                 edit_buffer[len++] = '\n'; // Salva apenas \n no arquivo
                 edit_buffer[len] = 0;
                 safe_puts("\r\n");         // Na tela, imprime \r\n (Enter Visual Correto)
@@ -240,7 +429,7 @@ void cmd_edit(const char *args) {
         
         // --- TEXTO ---
         else if (c >= 32 && c <= 126) {
-            if (len < 2047) {
+            if (edit_reserve(len + 1)) {
                 edit_buffer[len++] = c;
                 edit_buffer[len] = 0;
                 char s[2] = {c, 0};
@@ -249,10 +438,111 @@ void cmd_edit(const char *args) {
         }
     }
 
-    // SAIDA: Limpa tela e prepara espaço para o prompt 
+    // SAIDA: Devolve o buffer ao Heap
+    sys_free(edit_buffer);
+    edit_buffer = NULL;
+    edit_cap = 0;
+
+    // Limpa tela e prepara espaço para o prompt 
     clear_screen();
     
     // Libera Uptime
     g_editor_mode = 0;
 
-}
\ No newline at end of file
+}
+
+// --- DF: Uso do disco ---
+void cmd_df(const char *args) {
+    (void)args;
+    fs_statfs_t st;
+    char num[11];
+
+    if (sys_fs_statfs(&st) < 0) {
+        safe_puts(SH_RED "Error: filesystem not mounted.\n" SH_RESET);
+        return;
+    }
+
+    safe_puts(SH_BOLD "\n  RAMFS USAGE\n" SH_RESET);
+    safe_puts(SH_GRAY "  -------------------\n" SH_RESET);
+
+    safe_puts("  Blocks: ");
+    uint_to_str(st.total_blocks - st.free_blocks, num); safe_puts(num);
+    safe_puts(" used / ");
+    uint_to_str(st.total_blocks, num); safe_puts(num);
+    safe_puts(" (");
+    uint_to_str(st.block_size, num); safe_puts(num);
+    safe_puts(" B each)\n");
+
+    safe_puts("  Free:   ");
+    uint_to_str(st.free_blocks * st.block_size, num); safe_puts(num);
+    safe_puts(" bytes\n");
+
+    safe_puts("  Inodes: ");
+    uint_to_str(st.total_inodes - st.free_inodes, num); safe_puts(num);
+    safe_puts(" used / ");
+    uint_to_str(st.total_inodes, num); safe_puts(num);
+    safe_puts("\n\n");
+}
+
+// --- NPULOAD: Pesos da NPU direto do arquivo ---
+// O arquivo é mapeado (sem cópia para buffer) e o ponteiro vai direto para a
+// FIFO de pesos, via DMA se estiver habilitado. Conteúdo: palavras int8x4.
+void cmd_npuload(const char *args) {
+    if (!args || !*args) {
+        safe_puts("Usage: npuload <filename>\n");
+        return;
+    }
+
+    const uint8_t *ptr;
+    uint32_t len;
+    int res = sys_fs_map(args, &ptr, &len);
+    if (res == -1) { safe_puts("File not found.\n"); return; }
+    if (res == -3) { safe_puts("Error: File is open for writing.\n"); return; }
+    if (res < 0)   { safe_puts("Error: Cannot map file (fragmented, or disk behind cache).\n"); return; }
+
+    uint32_t words = len >> 2;
+    hal_npu_load_weights((const uint32_t *)ptr, words);
+    sys_fs_unmap(ptr);
+
+    char num[11];
+    safe_puts("Loaded ");
+    uint_to_str(words, num); safe_puts(num);
+    safe_puts(" weight words.\n");
+    if (len & 3) safe_puts(SH_YELLOW "Warning: trailing bytes ignored (size not multiple of 4).\n" SH_RESET);
+}
+
+// --- SYNC: Grava no disco o que só está em RAM ---
+// Só faz diferença no disco virtio (make run-disk); em RAM já está tudo lá.
+void cmd_sync(const char *args) {
+    (void)args;
+    if (sys_fs_sync() == 0) safe_puts("Filesystem synced.\n");
+    else safe_puts(SH_RED "Error: sync failed (I/O error or not mounted).\n" SH_RESET);
+}
+
+// --- MKDIR / RMDIR: Diretórios ---
+void cmd_mkdir(const char *args) {
+    if (!args || !*args) {
+        safe_puts("Usage: mkdir <path>\n");
+        return;
+    }
+
+    int res = sys_fs_mkdir(args);
+    if (res == 0) safe_puts("Directory created.\n");
+    else if (res == -1) safe_puts("Error: Already exists.\n");
+    else if (res == -6) safe_puts("Error: Parent directory not found.\n");
+    else if (res == -4) safe_puts("Error: Invalid name.\n");
+    else safe_puts("Error: Disk or directory full.\n");
+}
+
+void cmd_rmdir(const char *args) {
+    if (!args || !*args) {
+        safe_puts("Usage: rmdir <path>\n");
+        return;
+    }
+
+    int res = sys_fs_rmdir(args);
+    if (res == 0) safe_puts("Directory removed.\n");
+    else if (res == -2) safe_puts("Error: Directory not empty.\n");
+    else if (res == -3) safe_puts("Error: Directory is open.\n");
+    else safe_puts("Error: Directory not found.\n");
+}
@@ -1,94 +1,677 @@
 #include "../../include/kernel/fs.h"
 #include "../../include/kernel/mm.h"
+#include "../../include/kernel/kmem.h"
+#include "../../include/kernel/blkdev.h"
+#include "../../include/kernel/bcache.h"
 #include "../../include/hal/hal_uart.h"
+#include "../../include/hal/hal_blk.h"
+#include "../../include/util/string.h"
+#include "../../include/util/math_ops.h"
 
 // ============================================================================
-// ESTRUTURA FÍSICA DO DISCO VIRTUAL (RAM)
+// ESTRUTURA FÍSICA DO DISCO
 // ============================================================================
-// Layout da Memória:
+// Layout do disco:
 // [ SUPERBLOCK ] [ INODE BITMAP ] [ BLOCK BITMAP ] [ INODE TABLE ] [ DATA BLOCKS ... ]
+//
+// Os metadados (até a tabela de inodes) ficam sempre em RAM. Os blocos de
+// dados são usados no lugar quando o dispositivo é mapeado em memória (RAM,
+// imagem linkada) ou passam pelo cache de blocos (virtio-blk); nesse caso
+// fs_sync grava no dispositivo o que só está em RAM.
 
-static uint8_t *disk_memory = NULL; // Ponteiro para o início do nosso "HD" na RAM
+static blkdev_t *disk_dev    = NULL; // Dispositivo montado
+static blkdev_t  ram_dev;            // Backend RAM (disco volátil ou imagem)
+static bcache_t  fs_cache;           // Só para dispositivos não mapeados
+static uint8_t  *disk_memory = NULL; // Metadados (mapeado: o disco inteiro)
+static int       disk_owned  = 0;    // 1 = disk_memory alocado por nós
 
 // Ponteiros de conveniência para as regiões internas
 static superblock_t *sb;
-static uint8_t      *inode_bitmap;
-static uint8_t      *block_bitmap;
+static struct meta_hdr *meta_hdr; // Cabeçalho da cópia dos metadados em RAM
+static uint32_t     *inode_bitmap;
+static uint32_t     *block_bitmap;
 static inode_t      *inode_table;
 static uint8_t      *data_blocks;
 
+// Descritores de arquivo abertos (ver DESCRITORES DE ARQUIVO)
+typedef struct {
+    inode_t *inode;     // NULL = descritor livre
+    uint32_t offset;
+    uint16_t inode_idx;
+    uint16_t flags;     // FS_O_*
+} fs_fd_t;
+
+static fs_fd_t fd_table[FS_MAX_FD];
+
+// Mapeamentos ativos (fs_map) por inode: enquanto != 0 o arquivo não muda
+static uint8_t map_count[FS_MAX_INODES];
+
+// Bitmaps em palavras de 32 bits (logo depois do cabeçalho da cópia, então
+// as palavras ficam alinhadas)
+#define FS_INODE_WORDS ((FS_MAX_INODES + 31) / 32)
+#define FS_BLOCK_WORDS ((FS_MAX_BLOCKS + 31) / 32)
+
+// Unidade de E/S do cache: um bloco da RamFS, no mínimo um setor (512)
+#define FS_IO_SIZE (FS_BLOCK_SIZE > 512 ? FS_BLOCK_SIZE : 512)
+
+// Layout dos metadados: [superbloco][cópia 0][cópia 1], cada parte
+// arredondada para FS_IO_SIZE. O superbloco fica sozinho no primeiro setor
+// (a gravação dele é atômica) e diz qual cópia (bitmaps + inodes) é a do
+// último commit; o commit grava a outra (ver fs_sync). Nenhum bloco de
+// dados cruza um setor/buffer do cache e, com o disco alocado alinhado em
+// KMALLOC_DMA_ALIGN, todo bloco começa num burst do DMA (fs_map).
+typedef struct meta_hdr {
+    uint32_t generation; // Commit que gravou esta cópia (0 = nunca gravada)
+    uint32_t checksum;   // meta_checksum() do resto da cópia
+} meta_hdr_t;
+
+#define META_COPY_SIZE ((sizeof(meta_hdr_t) + \
+                         (FS_INODE_WORDS * 4) + \
+                         (FS_BLOCK_WORDS * 4) + \
+                         (sizeof(inode_t) * FS_MAX_INODES) + \
+                         FS_IO_SIZE - 1) & ~(FS_IO_SIZE - 1))
+#define DISK_META_SIZE (FS_IO_SIZE + 2 * META_COPY_SIZE)
+
+// Em RAM (disco com cache) ficam só o superbloco e uma cópia
+#define META_RAM_SIZE  (FS_IO_SIZE + META_COPY_SIZE)
+
+_Static_assert((FS_IO_SIZE & (KMALLOC_DMA_ALIGN - 1)) == 0, "blocos precisam de alinhamento de DMA");
+_Static_assert(((FS_BLOCK_SIZE * FS_MAX_BLOCKS) & (FS_IO_SIZE - 1)) == 0, "disco precisa ter setores inteiros");
+
 // Tamanho total do disco
-#define DISK_SIZE (sizeof(superblock_t) + \
-                   (FS_MAX_INODES/8) + \
-                   (FS_MAX_BLOCKS/8) + \
-                   (sizeof(inode_t) * FS_MAX_INODES) + \
-                   (FS_BLOCK_SIZE * FS_MAX_BLOCKS))
+#define DISK_SIZE (DISK_META_SIZE + (FS_BLOCK_SIZE * FS_MAX_BLOCKS))
 
 // ============================================================================
 // HELPERS DE BITMAP
 // ============================================================================
+// Varredura de 32 bits por vez: palavra cheia (0xFFFFFFFF) é pulada com uma
+// comparação, e o primeiro zero sai do ctz do complemento. Sem '/' e '%'
+// (no RV32I viram chamadas de divisão por software).
+// A busca é next-fit: começa na palavra da última alocação, então encher o
+// disco não repassa toda vez pelas palavras já cheias do começo.
+
+static uint32_t inode_hint; // Palavra onde a próxima busca começa
+static uint32_t block_hint;
+
+// Marca como usados os bits além de 'nbits' na última palavra
+static void bitmap_init(uint32_t *bitmap, uint32_t words, uint32_t nbits) {
+    for (uint32_t w = 0; w < words; w++) bitmap[w] = 0;
+    if (nbits & 31) bitmap[words - 1] = ~0u << (nbits & 31);
+}
 
-// Busca o primeiro bit livre (0), marca como usado (1) e retorna o índice
-static int alloc_bit(uint8_t *bitmap, int size) {
-    for (int i = 0; i < size; i++) {
-        // Verifica bit a bit dentro do byte (simplificado: byte a byte se size < 8)
-        // Como nossos bitmaps são pequenos (32 inodes = 4 bytes), podemos fazer simples:
-        if ((bitmap[i/8] >> (i%8)) & 1) continue; // Já usado
-        
-        // Achou livre! Marca.
-        bitmap[i/8] |= (1 << (i%8));
-        return i;
+// Busca um bit livre (0) a partir de *hint, marca como usado e retorna o índice
+static int alloc_bit(uint32_t *bitmap, uint32_t words, uint32_t *hint) {
+    uint32_t w = *hint;
+    for (uint32_t n = 0; n < words; n++) {
+        uint32_t v = bitmap[w];
+        if (v != 0xFFFFFFFFu) {
+            uint32_t bit = math_ctz32(~v); // Primeiro zero
+            bitmap[w] = v | (1u << bit);
+            *hint = w;
+            return (int)((w << 5) + bit);
+        }
+        if (++w == words) w = 0;
     }
     return -1; // Disco cheio
 }
 
-static void free_bit(uint8_t *bitmap, int idx) {
-    bitmap[idx/8] &= ~(1 << (idx%8));
+static void free_bit(uint32_t *bitmap, int idx) {
+    bitmap[idx >> 5] &= ~(1u << (idx & 31));
+}
+
+// Alocação com os contadores do superbloco em dia (fs_statfs é O(1))
+static int alloc_inode(void) {
+    int idx = alloc_bit(inode_bitmap, FS_INODE_WORDS, &inode_hint);
+    if (idx >= 0) sb->free_inodes--;
+    return idx;
+}
+
+static int alloc_block(void) {
+    int idx = alloc_bit(block_bitmap, FS_BLOCK_WORDS, &block_hint);
+    if (idx >= 0) sb->free_blocks--;
+    return idx;
+}
+
+static void free_inode(int idx) {
+    free_bit(inode_bitmap, idx);
+    sb->free_inodes++;
+}
+
+// Bloco liberado com o disco atrás do cache não volta já ao bitmap: os
+// metadados gravados no dispositivo ainda podem apontar para ele, e um
+// despejo do cache com dados novos estragaria o arquivo antigo se faltar
+// energia antes do fs_sync. Fica reservado até o próximo commit.
+static uint32_t pending_bitmap[FS_BLOCK_WORDS];
+static uint32_t pending_blocks;
+static uint32_t pending_writes; // fs_write desde o último commit
+
+static void free_block(int idx) {
+    if (!data_blocks) {
+        pending_bitmap[idx >> 5] |= 1u << (idx & 31);
+        pending_blocks++;
+        return;
+    }
+    free_bit(block_bitmap, idx);
+    sb->free_blocks++;
+}
+
+// Devolve ao bitmap os blocos reservados (só no commit, ver fs_sync).
+// release = 0 desfaz a devolução: o commit falhou e os metadados no
+// dispositivo ainda apontam para eles.
+static void pending_apply(int release) {
+    for (uint32_t w = 0; w < FS_BLOCK_WORDS; w++) {
+        if (release) block_bitmap[w] &= ~pending_bitmap[w];
+        else         block_bitmap[w] |= pending_bitmap[w];
+    }
+    if (release) sb->free_blocks += pending_blocks;
+    else         sb->free_blocks -= pending_blocks;
+}
+
+// Zera as reservas (commit gravado: os reservados passam a ser livres de
+// vez; ou disco novo/formatado)
+static void pending_clear(void) {
+    kmemset(pending_bitmap, 0, sizeof(pending_bitmap));
+    pending_blocks = 0;
+    pending_writes = 0;
+}
+
+// Antes de alocar 'n' blocos: se só os reservados dariam conta, o commit
+// os libera (o commit é a única gravação de metadados)
+static void blocks_reserve(uint32_t n) {
+    if (pending_blocks && sb->free_blocks < n) fs_sync();
+}
+
+static int block_is_free(uint32_t b) {
+    return !(block_bitmap[b >> 5] & (1u << (b & 31)));
+}
+
+// Marca como usados até 'max' blocos livres consecutivos a partir de 'start'
+static uint32_t claim_run(uint32_t start, uint32_t max) {
+    uint32_t n = 0;
+    while (n < max && start + n < FS_MAX_BLOCKS && block_is_free(start + n)) {
+        block_bitmap[(start + n) >> 5] |= 1u << ((start + n) & 31);
+        n++;
+    }
+    sb->free_blocks -= n;
+    return n;
+}
+
+// Aloca um trecho contíguo: o primeiro com 'want' blocos livres ou, se não
+// houver, o maior encontrado. Palavras cheias do bitmap são puladas inteiras.
+static uint32_t alloc_run(uint32_t want, uint16_t *start) {
+    uint32_t best_start = 0, best_len = 0;
+    uint32_t b = 0;
+
+    while (b < FS_MAX_BLOCKS) {
+        if ((b & 31) == 0 && block_bitmap[b >> 5] == 0xFFFFFFFFu) { b += 32; continue; }
+        if (!block_is_free(b)) { b++; continue; }
+
+        uint32_t run_start = b;
+        while (b < FS_MAX_BLOCKS && b - run_start < want && block_is_free(b)) b++;
+        if (b - run_start > best_len) { best_start = run_start; best_len = b - run_start; }
+        if (best_len == want) break;
+    }
+    if (best_len == 0) return 0;
+    *start = (uint16_t)best_start;
+    return claim_run(best_start, best_len);
+}
+
+// Bloco de dados 'b': no lugar (disco mapeado) ou no buffer do cache.
+// write = 1 marca o buffer sujo (vai para o disco no despejo ou no fs_sync).
+// Com cache o ponteiro vale só até BCACHE_SLOTS-1 outros blocos (bcache.h).
+// NULL = erro de E/S no dispositivo (ou bloco fora do disco): quem chama
+// devolve -7 sem mexer em nada.
+static uint8_t *block_ptr(uint32_t b, int write) {
+    if (b >= FS_MAX_BLOCKS) return NULL;
+    if (data_blocks) return &data_blocks[b * FS_BLOCK_SIZE];
+    uint32_t off = DISK_META_SIZE + b * FS_BLOCK_SIZE;
+    uint8_t *buf = bcache_get(&fs_cache, off / FS_IO_SIZE, write);
+    return buf ? buf + (off & (FS_IO_SIZE - 1)) : NULL;
 }
 
 // ============================================================================
-// HELPERS DE ARQUIVO
+// MAPEAMENTO DE BLOCOS (extents + indireto)
 // ============================================================================
 
-// Busca um arquivo no Diretório Raiz (Inode 0)
-// Retorna o índice do Inode ou -1
-static int find_inode_by_name(const char *name) {
-    inode_t *root = &inode_table[0]; // Inode 0 é sempre o root
-    
-    // O Root contém entradas do tipo dirent_t em seus blocos de dados
-    for (int i = 0; i < root->blocks_cnt; i++) {
-        uint16_t blk_idx = root->blocks[i];
-        dirent_t *dir_block = (dirent_t *)&data_blocks[blk_idx * FS_BLOCK_SIZE];
-        
-        // Cada bloco pode ter várias entradas. (FS_BLOCK_SIZE / sizeof(dirent_t))
-        int max_entries = FS_BLOCK_SIZE / sizeof(dirent_t);
-        
-        for (int j = 0; j < max_entries; j++) {
-            if (dir_block[j].inode_idx != 0) { // Entrada válida (0 seria vazio/livre aqui? Não, inode 0 é root)
-                // Vamos definir inode_idx=0xFFFF como entrada vazia, pois inode 0 é válido
-                if (dir_block[j].inode_idx == 0xFFFF) continue;
-
-                // Compara string
-                const char *s1 = name;
-                const char *s2 = dir_block[j].name;
-                int match = 1;
-                while (*s1 && *s2) { if (*s1++ != *s2++) { match=0; break; } }
-                if (match && *s1 == *s2) return dir_block[j].inode_idx;
+#define FS_EXTENT_MAX 0xFFFF
+
+static uint16_t *indirect_table(inode_t *inode, int write) {
+    return (uint16_t *)block_ptr(inode->indirect, write);
+}
+
+// Blocos cobertos pelos extents; *last = último extent em uso (-1 = nenhum)
+static uint32_t extent_blocks(inode_t *inode, int *last) {
+    uint32_t n = 0;
+    *last = -1;
+    for (int e = 0; e < FS_INLINE_EXTENTS && inode->extents[e].len; e++) {
+        n += inode->extents[e].len;
+        *last = e;
+    }
+    return n;
+}
+
+// Bloco físico do bloco lógico 'bi' (< blocks_cnt). Em *run, quantos blocos
+// seguem fisicamente contíguos a partir dele (o resto do extent, ou entradas
+// consecutivas da tabela indireta): o chamador copia tudo de uma vez.
+static uint32_t inode_map(inode_t *inode, uint32_t bi, uint32_t *run) {
+    uint32_t ext = 0;
+    for (int e = 0; e < FS_INLINE_EXTENTS && inode->extents[e].len; e++) {
+        fs_extent_t *x = &inode->extents[e];
+        if (bi < x->len) {
+            *run = x->len - bi;
+            return x->start + bi;
+        }
+        bi  -= x->len;
+        ext += x->len;
+    }
+
+    uint16_t *ind = indirect_table(inode, 0);
+    if (!ind) { *run = 1; return FS_NO_BLOCK; } // block_ptr(FS_NO_BLOCK) = NULL
+    uint32_t  cnt = inode->blocks_cnt - ext;
+    uint32_t  n   = 1;
+    while (bi + n < cnt && ind[bi + n] == ind[bi] + n) n++;
+    *run = n;
+    return ind[bi];
+}
+
+// Acrescenta até 'want' blocos no fim do arquivo e retorna quantos conseguiu.
+// Ordem de preferência: estender o último extent (bloco vizinho livre),
+// abrir um extent novo com um trecho contíguo, e só então a tabela indireta.
+static uint32_t inode_grow(inode_t *inode, uint32_t want) {
+    uint32_t got = 0;
+
+    while (got < want) {
+        int last;
+        uint32_t ext     = extent_blocks(inode, &last);
+        uint32_t ind_cnt = inode->blocks_cnt - ext;
+        uint32_t n       = 0;
+
+        // Depois que a tabela indireta começou, os extents ficam congelados
+        if (ind_cnt == 0) {
+            if (last >= 0) {
+                fs_extent_t *x = &inode->extents[last];
+                uint32_t max = want - got;
+                if (max > FS_EXTENT_MAX - x->len) max = FS_EXTENT_MAX - x->len;
+                n = claim_run(x->start + x->len, max);
+                x->len += n;
             }
+            if (n == 0 && last + 1 < FS_INLINE_EXTENTS) {
+                uint16_t start;
+                uint32_t max = want - got;
+                if (max > FS_EXTENT_MAX) max = FS_EXTENT_MAX;
+                n = alloc_run(max, &start);
+                if (n) {
+                    inode->extents[last + 1].start = start;
+                    inode->extents[last + 1].len   = (uint16_t)n;
+                }
+            }
+        }
+
+        if (n == 0) {
+            if (ind_cnt >= FS_INDIRECT_PTRS) break; // Tabela indireta cheia
+            if (inode->indirect == FS_NO_BLOCK) {
+                int blk = alloc_block();
+                if (blk < 0) break;
+                inode->indirect = (uint16_t)blk;
+            }
+            int blk = alloc_block();
+            if (blk < 0) break;
+            uint16_t *ind = indirect_table(inode, 1);
+            if (!ind) { free_block(blk); break; } // Erro de E/S
+            ind[ind_cnt] = (uint16_t)blk;
+            n = 1;
+        }
+
+        inode->blocks_cnt += n;
+        got += n;
+    }
+
+    // Tabela indireta recém-alocada que ficou vazia (disco cheio)
+    int last;
+    if (inode->indirect != FS_NO_BLOCK && inode->blocks_cnt == extent_blocks(inode, &last)) {
+        free_block(inode->indirect);
+        inode->indirect = FS_NO_BLOCK;
+    }
+    return got;
+}
+
+// Corta o arquivo em 'size' bytes, devolvendo os blocos do fim
+static void inode_truncate(inode_t *inode, uint32_t size) {
+    uint32_t keep = (size + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE;
+    int last;
+    uint32_t ext = extent_blocks(inode, &last);
+
+    while (inode->blocks_cnt > keep) {
+        if (inode->blocks_cnt > ext) {
+            // Tabela ilegível (erro de E/S): o bloco fica perdido, marcado usado
+            uint16_t *ind = indirect_table(inode, 0);
+            if (ind) free_block(ind[inode->blocks_cnt - ext - 1]);
+        } else {
+            fs_extent_t *x = &inode->extents[last];
+            free_block(x->start + --x->len);
+            if (x->len == 0) last--;
+            ext--;
         }
+        inode->blocks_cnt--;
+    }
+
+    if (inode->indirect != FS_NO_BLOCK && inode->blocks_cnt <= ext) {
+        free_block(inode->indirect);
+        inode->indirect = FS_NO_BLOCK;
+    }
+    if (inode->size > size) inode->size = size;
+}
+
+// Inode vazio (sem blocos)
+static void inode_reset(inode_t *inode, uint16_t type) {
+    inode->type       = type;
+    inode->size       = 0;
+    inode->blocks_cnt = 0;
+    inode->indirect   = FS_NO_BLOCK;
+    for (int e = 0; e < FS_INLINE_EXTENTS; e++) inode->extents[e].len = 0;
+}
+
+// i-ésimo bloco de entradas do diretório 'dir' (write = 1 para alterar entradas)
+static dirent_t *dir_block(uint32_t dir, uint32_t i, int write) {
+    uint32_t run;
+    return (dirent_t *)block_ptr(inode_map(&inode_table[dir], i, &run), write);
+}
+
+// ============================================================================
+// ÍNDICE DE NOMES / CACHE DE DENTRIES (hash em RAM)
+// ============================================================================
+// Mapeia hash(diretório pai, nome) -> inode + posição do dirent no pai. Como
+// todo inode tem exatamente um dirent, o índice cobre a árvore inteira: cada
+// componente de um caminho custa O(1), sem varrer blocos de diretório. Não
+// vai para o disco: é reconstruído no mount (fs_init) e mantido por
+// create/mkdir/delete/rmdir. Endereçamento aberto com sondagem linear e
+// carga <= 50%. A comparação completa do nome só acontece quando o hash e o
+// pai batem.
+
+#define FS_INDEX_SLOTS  (2 * FS_MAX_INODES)
+#define FS_INDEX_MASK   (FS_INDEX_SLOTS - 1)
+#define FS_INDEX_EMPTY  0xFFFF
+
+_Static_assert((FS_MAX_INODES & (FS_MAX_INODES - 1)) == 0,
+               "FS_MAX_INODES precisa ser potência de 2 (máscara do índice)");
+_Static_assert(FS_DIRENTS_PER_BLOCK <= 255, "posição do dirent não cabe no slot do índice");
+
+#define FS_MAX_DIR_BLOCKS 255   // dir_blk do slot é uint8_t
+
+typedef struct {
+    uint32_t hash;
+    uint16_t inode;     // FS_INDEX_EMPTY = slot livre
+    uint16_t parent;    // Diretório que contém o dirent
+    uint8_t  dir_blk;   // Bloco lógico do pai
+    uint8_t  dir_slot;  // Entrada dentro do bloco
+} name_slot_t;
+
+static name_slot_t *name_index = NULL;
+
+// FNV-1a sobre os 'len' bytes do nome, partindo do inode do pai (o mesmo
+// nome em diretórios diferentes cai em slots diferentes). A multiplicação
+// pelo primo (16777619) vira shifts e somas: no RV32I um '*' seria chamada
+// a __mulsi3.
+static uint32_t name_hash(uint32_t parent, const char *s, uint32_t len) {
+    uint32_t h = 2166136261u ^ parent;
+    while (len--) {
+        h ^= (uint8_t)*s++;
+        h += (h << 1) + (h << 4) + (h << 7) + (h << 8) + (h << 24);
+    }
+    return h;
+}
+
+static uint32_t str_len(const char *s) {
+    const char *e = s;
+    while (*e) e++;
+    return (uint32_t)(e - s);
+}
+
+static dirent_t *slot_dirent(const name_slot_t *slot, int write) {
+    dirent_t *entries = dir_block(slot->parent, slot->dir_blk, write);
+    return entries ? &entries[slot->dir_slot] : NULL;
+}
+
+// Nome do dirent (terminado em 0) == os 'len' bytes de 'b'?
+static int name_equal(const char *a, const char *b, uint32_t len) {
+    while (len && *a == *b) { a++; b++; len--; }
+    return len == 0 && *a == 0;
+}
+
+// Retorna o slot do índice com esse (pai, nome) ou -1
+static int index_find(uint32_t parent, const char *name, uint32_t len, uint32_t hash) {
+    uint32_t i = hash & FS_INDEX_MASK;
+    while (name_index[i].inode != FS_INDEX_EMPTY) {
+        if (name_index[i].hash == hash && name_index[i].parent == parent) {
+            dirent_t *e = slot_dirent(&name_index[i], 0); // NULL: não dá para conferir
+            if (e && name_equal(e->name, name, len)) return (int)i;
+        }
+        i = (i + 1) & FS_INDEX_MASK;
+    }
+    return -1;
+}
+
+static void index_insert(uint32_t hash, uint16_t inode, uint32_t parent, int dir_blk, int dir_slot) {
+    uint32_t i = hash & FS_INDEX_MASK;
+    while (name_index[i].inode != FS_INDEX_EMPTY) i = (i + 1) & FS_INDEX_MASK;
+    name_index[i].hash     = hash;
+    name_index[i].inode    = inode;
+    name_index[i].parent   = (uint16_t)parent;
+    name_index[i].dir_blk  = (uint8_t)dir_blk;
+    name_index[i].dir_slot = (uint8_t)dir_slot;
+}
+
+static void path_cache_clear(void);
+
+// Remoção com deslocamento para trás (sem lápides): puxa para o buraco
+// cada entrada seguinte cuja posição ideal não fica entre o buraco e ela.
+static void index_remove(uint32_t i) {
+    path_cache_clear(); // Slots mudam de lugar: caminhos guardados ficam velhos
+    uint32_t j = i;
+    while (1) {
+        j = (j + 1) & FS_INDEX_MASK;
+        if (name_index[j].inode == FS_INDEX_EMPTY) break;
+        uint32_t home = name_index[j].hash & FS_INDEX_MASK;
+        int stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (stays) continue;
+        name_index[i] = name_index[j];
+        i = j;
+    }
+    name_index[i].inode = FS_INDEX_EMPTY;
+}
+
+// Reconstrói o índice a partir dos dirents de todos os diretórios (mount/format)
+static void index_rebuild(void) {
+    path_cache_clear();
+    for (int i = 0; i < FS_INDEX_SLOTS; i++) name_index[i].inode = FS_INDEX_EMPTY;
+
+    for (uint32_t d = 0; d < FS_MAX_INODES; d++) {
+        if (inode_table[d].type != FS_TYPE_DIR) continue;
+        for (int i = 0; i < inode_table[d].blocks_cnt; i++) {
+            dirent_t *entries = dir_block(d, i, 0);
+            if (!entries) continue; // Erro de E/S: as entradas do bloco somem
+            for (int j = 0; j < FS_DIRENTS_PER_BLOCK; j++) {
+                if (entries[j].inode_idx == 0xFFFF) continue;
+                const char *n = entries[j].name;
+                index_insert(name_hash(d, n, str_len(n)), entries[j].inode_idx, d, i, j);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// CAMINHOS ("/models/net1/w0")
+// ============================================================================
+// Sempre a partir do Root ('/' inicial opcional); barras repetidas ou no fim
+// são ignoradas. Cada componente é uma busca no índice acima. Em cima disso,
+// um cache pequeno de caminhos completos (FS_PATH_CACHE entradas, reposição
+// circular) devolve o slot do índice do último componente com um hash e uma
+// comparação: reabrir o mesmo caminho não percorre os componentes de novo.
+// Só guarda acertos, e qualquer remoção no índice (que move slots) esvazia
+// o cache; criar não invalida nada.
+
+#ifndef FS_PATH_CACHE
+#define FS_PATH_CACHE     8
+#endif
+#define FS_PATH_CACHE_LEN 48   // Caminhos maiores não são guardados
+
+typedef struct {
+    uint32_t hash;
+    uint16_t slot;      // Slot do índice do último componente
+    uint8_t  len;       // 0 = entrada livre
+    char     path[FS_PATH_CACHE_LEN];
+} path_entry_t;
+
+static path_entry_t path_cache[FS_PATH_CACHE];
+static uint32_t     path_cache_next;
+
+static void path_cache_clear(void) {
+    for (int i = 0; i < FS_PATH_CACHE; i++) path_cache[i].len = 0;
+}
+
+static int path_cache_find(const char *path, uint32_t len, uint32_t hash) {
+    for (int i = 0; i < FS_PATH_CACHE; i++) {
+        path_entry_t *e = &path_cache[i];
+        if (e->len == len && e->hash == hash && memcmp(e->path, path, len) == 0) return e->slot;
     }
     return -1;
 }
 
+static void path_cache_add(const char *path, uint32_t len, uint32_t hash, int slot) {
+    if (FS_PATH_CACHE == 0 || len >= FS_PATH_CACHE_LEN) return;
+    path_entry_t *e = &path_cache[path_cache_next];
+    path_cache_next = (path_cache_next + 1) & (FS_PATH_CACHE - 1);
+    e->hash = hash;
+    e->slot = (uint16_t)slot;
+    e->len  = (uint8_t)len;
+    memcpy(e->path, path, len);
+}
+
+_Static_assert((FS_PATH_CACHE & (FS_PATH_CACHE - 1)) == 0, "FS_PATH_CACHE precisa ser potência de 2");
+
+// Próximo componente a partir de *p: início em *comp, tamanho no retorno
+// (0 = acabou). *p avança para depois dele.
+static uint32_t path_next(const char **p, const char **comp) {
+    const char *s = *p;
+    while (*s == '/') s++;
+    *comp = s;
+    while (*s && *s != '/') s++;
+    *p = s;
+    return (uint32_t)(s - *comp);
+}
+
+// NULL, "" e "/" (só barras) = o próprio Root
+static int path_is_root(const char *path) {
+    if (!path) return 1;
+    while (*path == '/') path++;
+    return *path == 0;
+}
+
+// Nome válido para um dirent: cabe com o terminador, e não é "." nem ".."
+static int name_valid(const char *name, uint32_t len) {
+    if (len == 0 || len >= FS_MAX_NAME) return 0;
+    if (name[0] == '.' && (len == 1 || (len == 2 && name[1] == '.'))) return 0;
+    return 1;
+}
+
+// Resolve o diretório que contém o último componente de 'path'. Em *leaf e
+// *leaf_len, o último componente (dentro de 'path'). Retorna o inode do pai;
+// -1 = algum componente intermediário não existe ou não é diretório, -4 =
+// caminho sem componentes (o Root) ou componente longo demais.
+static int path_parent(const char *path, const char **leaf, uint32_t *leaf_len) {
+    uint32_t dir = 0;
+    const char *p = path, *comp;
+    uint32_t len = path_next(&p, &comp);
+    if (len == 0) return -4;
+
+    while (1) {
+        const char *next_comp;
+        const char *q = p;
+        uint32_t next_len = path_next(&q, &next_comp);
+        if (next_len == 0) break; // 'comp' é o último
+
+        if (len >= FS_MAX_NAME) return -4;
+        int slot = index_find(dir, comp, len, name_hash(dir, comp, len));
+        if (slot < 0) return -1;
+        dir = name_index[slot].inode;
+        if (inode_table[dir].type != FS_TYPE_DIR) return -1;
+
+        p = q; comp = next_comp; len = next_len;
+    }
+
+    *leaf = comp;
+    *leaf_len = len;
+    return (int)dir;
+}
+
+// Slot do índice do último componente de 'path', ou -1 (não existe; o Root
+// não tem slot). Caminho de um componente só vai direto ao índice: o cache
+// de caminhos não economizaria nada.
+static int path_lookup(const char *path) {
+    const char *s = path;
+    int deep = 0;
+    while (*s == '/') s++;
+    const char *e = s;
+    while (*e) deep |= (*e++ == '/');
+
+    uint32_t len = (uint32_t)(e - path), hash = 0;
+    if (deep) {
+        hash = name_hash(0, path, len);
+        int slot = path_cache_find(path, len, hash);
+        if (slot >= 0) return slot;
+    }
+
+    const char *leaf;
+    uint32_t leaf_len;
+    int dir = path_parent(path, &leaf, &leaf_len);
+    if (dir < 0 || leaf_len >= FS_MAX_NAME) return -1;
+
+    int slot = index_find(dir, leaf, leaf_len, name_hash(dir, leaf, leaf_len));
+    if (slot >= 0 && deep) path_cache_add(path, len, hash, slot);
+    return slot;
+}
+
+// ============================================================================
+// HELPERS DE ARQUIVO
+// ============================================================================
+
+// Resolve o caminho de um arquivo regular: índice do Inode ou -1
+// (não existe ou é diretório)
+static int find_inode_by_name(const char *name) {
+    int slot = path_lookup(name);
+    if (slot < 0) return -1;
+    int idx = name_index[slot].inode;
+    return (inode_table[idx].type == FS_TYPE_FILE) ? idx : -1;
+}
+
 // ============================================================================
 // INICIALIZAÇÃO
 // ============================================================================
 
 void fs_format(void) {
+#ifndef FAST_BOOT
     hal_uart_puts("[FS] Formatting RamDisk...\n\r");
+#endif
+
+    // 1. Zera os metadados (Superblock, Bitmaps e Tabela de Inodes).
+    //    Formatação preguiçosa: os blocos de dados não são zerados, pois todo
+    //    bloco é escrito antes de ser lido (fs_read para no tamanho do arquivo)
+    //    e o bloco do Root é inicializado abaixo. -DFS_FORMAT_FULL zera tudo.
+    //    A geração e a cópia em uso continuam: o próximo commit grava a
+    //    outra cópia, e a antiga (geração menor) perde para ela no mount.
+    uint32_t generation = sb->generation;
+    uint16_t active     = sb->active;
+    kmemset(disk_memory, 0, data_blocks ? DISK_META_SIZE : META_RAM_SIZE);
+    sb->generation = generation;
+    sb->active     = active;
+    pending_clear();
+#ifdef FS_FORMAT_FULL
+    if (data_blocks) kmemset(data_blocks, 0, FS_BLOCK_SIZE * FS_MAX_BLOCKS);
+#endif
 
-    // 1. Zera todo o disco
-    for(int i=0; i<DISK_SIZE; i++) disk_memory[i] = 0;
+    // Descritores e mapeamentos apontam para inodes que deixam de existir
+    for (int i = 0; i < FS_MAX_FD; i++) fd_table[i].inode = NULL;
+    for (int i = 0; i < FS_MAX_INODES; i++) map_count[i] = 0;
 
     // 2. Configura Superblock
     sb->magic = FS_MAGIC;
@@ -97,231 +680,910 @@ void fs_format(void) {
     sb->free_inodes = FS_MAX_INODES;
     sb->free_blocks = FS_MAX_BLOCKS;
 
+    bitmap_init(inode_bitmap, FS_INODE_WORDS, FS_MAX_INODES);
+    bitmap_init(block_bitmap, FS_BLOCK_WORDS, FS_MAX_BLOCKS);
+    inode_hint = 0;
+    block_hint = 0;
+
     // 3. Cria o Diretório Raiz (Root)
     // Aloca Inode 0 para o Root
-    int root_idx = alloc_bit(inode_bitmap, FS_MAX_INODES); // Vai retornar 0
-    inode_table[root_idx].type = 2; // Diretório
-    inode_table[root_idx].size = 0;
+    int root_idx = alloc_inode(); // Vai retornar 0
+    inode_reset(&inode_table[root_idx], FS_TYPE_DIR);
     
     // Aloca 1 bloco de dados para o Root guardar a lista de arquivos
-    int blk_idx = alloc_bit(block_bitmap, FS_MAX_BLOCKS);
-    inode_table[root_idx].blocks[0] = blk_idx;
-    inode_table[root_idx].blocks_cnt = 1;
+    inode_grow(&inode_table[root_idx], 1);
 
     // Inicializa o bloco do diretório com entradas vazias (0xFFFF)
-    dirent_t *dir_entries = (dirent_t *)&data_blocks[blk_idx * FS_BLOCK_SIZE];
+    dirent_t *dir_entries = dir_block(0, 0, 1);
     int max_entries = FS_BLOCK_SIZE / sizeof(dirent_t);
-    for(int i=0; i<max_entries; i++) dir_entries[i].inode_idx = 0xFFFF;
+    for(int i=0; dir_entries && i<max_entries; i++) dir_entries[i].inode_idx = 0xFFFF;
+
+    // 4. Root vazio: índice de nomes vazio
+    index_rebuild();
+}
+
+// log2 do bloco do dispositivo, ou -1 se não serve (não é potência de 2,
+// maior que FS_IO_SIZE, menor que o superbloco ou o disco não cabe nele)
+static int dev_shift(blkdev_t *dev) {
+    int shift = 0;
+    while (shift < 16 && (1u << shift) < dev->block_size) shift++;
+    if ((1u << shift) != dev->block_size || dev->block_size > FS_IO_SIZE) return -1;
+    if (dev->block_size < sizeof(superblock_t)) return -1;
+    if ((DISK_SIZE >> shift) > dev->block_count) return -1;
+    return shift;
+}
+
+// Passa a usar 'dev' com os metadados em 'meta' ([superbloco][cópia em
+// uso]; no disco mapeado, o próprio dev->mem com a cópia 0) e solta o disco
+// anterior. O estado que só vive em RAM
+// (descritores, mapeamentos, dicas de alocação) recomeça do zero.
+static int disk_use(blkdev_t *dev, uint8_t *meta, int owned) {
+    if (disk_owned && disk_memory != meta) kfree(disk_memory);
+    bcache_free(&fs_cache);
+
+    disk_dev     = dev;
+    disk_memory  = meta;
+    disk_owned   = owned;
+    sb           = (superblock_t *)disk_memory;
+    meta_hdr     = (meta_hdr_t *)(disk_memory + FS_IO_SIZE);
+    inode_bitmap = (uint32_t *)(meta_hdr + 1);
+    block_bitmap = inode_bitmap + FS_INODE_WORDS;
+    inode_table  = (inode_t *)(block_bitmap + FS_BLOCK_WORDS);
+    data_blocks  = dev->mem ? dev->mem + DISK_META_SIZE : NULL;
+
+    if (!dev->mem && bcache_init(&fs_cache, dev, FS_IO_SIZE) < 0) {
+        sb = NULL; // Sem RAM para o cache: nada montado
+        return -1;
+    }
+
+    for (int i = 0; i < FS_MAX_FD; i++) fd_table[i].inode = NULL;
+    for (int i = 0; i < FS_MAX_INODES; i++) map_count[i] = 0;
+    pending_clear();
+    inode_hint = 0;
+    block_hint = 0;
+    return 0;
+}
+
+// ============================================================================
+// CÓPIAS DOS METADADOS (commit atômico)
+// ============================================================================
+//
+// Uma queda no meio de uma gravação de vários setores deixa parte deles
+// novos e parte antigos. Por isso o commit nunca grava por cima da cópia
+// em uso: grava a outra, com a geração seguinte e um checksum, faz o flush
+// e só então troca o superbloco (um setor). O mount fica com a cópia
+// válida mais nova: a do superbloco, ou a gravada por um commit que caiu
+// antes de trocá-lo (consistente: os dados foram antes, com flush).
+
+// Cópia 'c' (0/1) dentro de [superbloco][cópia 0][cópia 1]
+static uint8_t *meta_copy(uint8_t *meta, uint32_t c) {
+    return meta + FS_IO_SIZE + (c ? META_COPY_SIZE : 0);
+}
+
+// Soma com rotação das palavras da cópia (sem o campo do próprio checksum).
+// Cópia zerada não tem checksum válido: geração 0 é recusada à parte.
+static uint32_t meta_checksum(const uint8_t *copy) {
+    const uint32_t *w = (const uint32_t *)copy;
+    uint32_t sum = w[0]; // Geração
+    for (uint32_t i = sizeof(meta_hdr_t) / 4; i < META_COPY_SIZE / 4; i++) {
+        sum = ((sum << 5) | (sum >> 27)) + w[i];
+    }
+    return sum;
+}
+
+// Cópia a montar: a válida (checksum certo, geração até uma à frente do
+// superbloco) mais nova. -1 = nenhuma. Cópias de um disco formatado antes
+// têm geração acima dessa janela e não contam.
+static int meta_pick(uint8_t *meta) {
+    superblock_t *s = (superblock_t *)meta;
+    int best = -1;
+    uint32_t best_gen = 0;
+    for (uint32_t c = 0; c < 2; c++) {
+        uint8_t *copy = meta_copy(meta, c);
+        meta_hdr_t *h = (meta_hdr_t *)copy;
+        if (h->generation == 0 || h->generation > s->generation + 1) continue;
+        if (h->checksum != meta_checksum(copy)) continue; // Rasgada
+        if (best < 0 || h->generation > best_gen) {
+            best = (int)c;
+            best_gen = h->generation;
+        }
+    }
+    return best;
+}
+
+// Disco mapeado não tem commit: carimba a cópia 0 como está, para a
+// imagem (fs_disk) montar também num dispositivo com cache
+static void meta_seal(void) {
+    if (sb->generation == 0) sb->generation = 1;
+    sb->active = 0;
+    meta_hdr->generation = sb->generation;
+    meta_hdr->checksum   = meta_checksum((const uint8_t *)meta_hdr);
+}
+
+// Contadores do superbloco refeitos dos bitmaps (o superbloco gravado
+// pode ser de um commit anterior ao da cópia montada)
+static uint32_t bits_free(const uint32_t *bitmap, uint32_t n) {
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < n; i++) used += (bitmap[i >> 5] >> (i & 31)) & 1;
+    return n - used;
+}
+
+// Metadados do dispositivo: mapeado = no lugar; senão lidos para a RAM
+static uint8_t *meta_load(blkdev_t *dev, int shift) {
+    if (dev->mem) return dev->mem;
+    uint8_t *meta = (uint8_t *)kmalloc_aligned(DISK_META_SIZE, KMALLOC_DMA_ALIGN);
+    if (meta && dev->read(dev, 0, meta, DISK_META_SIZE >> shift) < 0) {
+        kfree(meta);
+        meta = NULL;
+    }
+    return meta;
+}
+
+// Bloco de dados 'b' de um disco ainda não montado (para o image_check):
+// no lugar ou lido em 'buf' (FS_IO_SIZE). NULL = erro de leitura.
+static const uint8_t *check_block(blkdev_t *dev, int shift, uint32_t b, uint8_t *buf) {
+    uint32_t off = DISK_META_SIZE + b * FS_BLOCK_SIZE;
+    if (dev->mem) return dev->mem + off;
+    uint32_t io = off & ~(FS_IO_SIZE - 1);
+    if (dev->read(dev, io >> shift, buf, FS_IO_SIZE >> shift) < 0) return NULL;
+    return buf + (off - io);
+}
+
+// Confere uma imagem antes de montar: tudo o que o resto do código usa
+// como índice sem checar (blocos dos extents e da tabela indireta, inodes
+// das entradas de diretório) precisa estar dentro do disco, e o índice de
+// nomes precisa caber (index_insert não para se a tabela lotar).
+// 0 = ok, -2 = erro de leitura, -3 = imagem inconsistente.
+static int image_check(blkdev_t *dev, uint8_t *copy, int shift) {
+    static uint16_t blocks[FS_MAX_BLOCKS]; // Blocos físicos do inode, em ordem
+    inode_t *table = (inode_t *)(copy + sizeof(meta_hdr_t) +
+                                 FS_INODE_WORDS * 4 + FS_BLOCK_WORDS * 4);
+    if (table[0].type != FS_TYPE_DIR) return -3; // Raiz
+
+    uint8_t *buf = NULL;
+    if (!dev->mem) {
+        buf = (uint8_t *)kmalloc_aligned(FS_IO_SIZE, KMALLOC_DMA_ALIGN);
+        if (!buf) return -2;
+    }
+
+    int      res     = 0;
+    uint32_t entries = 0;
+    for (uint32_t i = 0; i < FS_MAX_INODES && res == 0; i++) {
+        inode_t *inode = &table[i];
+        if (inode->type == 0) continue;
+        if ((inode->type != FS_TYPE_FILE && inode->type != FS_TYPE_DIR) ||
+            inode->blocks_cnt > FS_MAX_BLOCKS ||
+            inode->size > (uint32_t)inode->blocks_cnt * FS_BLOCK_SIZE) { res = -3; break; }
+
+        uint32_t n = 0;
+        for (int e = 0; e < FS_INLINE_EXTENTS && inode->extents[e].len; e++) {
+            fs_extent_t *x = &inode->extents[e];
+            if (x->start + x->len > FS_MAX_BLOCKS || n + x->len > inode->blocks_cnt) { res = -3; break; }
+            for (uint32_t k = 0; k < x->len; k++) blocks[n++] = (uint16_t)(x->start + k);
+        }
+        if (res < 0) break;
+
+        if (n < inode->blocks_cnt) {
+            if (inode->indirect >= FS_MAX_BLOCKS || inode->blocks_cnt - n > FS_INDIRECT_PTRS) { res = -3; break; }
+            const uint16_t *ind = (const uint16_t *)check_block(dev, shift, inode->indirect, buf);
+            if (!ind) { res = -2; break; }
+            for (uint32_t k = 0; n < inode->blocks_cnt; k++) {
+                if (ind[k] >= FS_MAX_BLOCKS) { res = -3; break; }
+                blocks[n++] = ind[k];
+            }
+        }
+        if (res < 0 || inode->type != FS_TYPE_DIR) continue;
+
+        for (uint32_t bi = 0; bi < n && res == 0; bi++) {
+            const dirent_t *d = (const dirent_t *)check_block(dev, shift, blocks[bi], buf);
+            if (!d) { res = -2; break; }
+            for (uint32_t j = 0; j < FS_DIRENTS_PER_BLOCK; j++) {
+                if (d[j].inode_idx == 0xFFFF) continue;
+                if (d[j].inode_idx >= FS_MAX_INODES || table[d[j].inode_idx].type == 0 ||
+                    ++entries > FS_MAX_INODES || d[j].name[FS_MAX_NAME - 1] != 0) { res = -3; break; }
+            }
+        }
+    }
+
+    if (buf) kfree(buf);
+    return res;
+}
+
+// Confere uma imagem (superbloco, cópias, conteúdo) sem mexer em nada.
+// Retorna a cópia a montar (0/1) ou o código de erro do fs_mount_dev.
+static int image_probe(blkdev_t *dev, uint8_t *meta, int shift) {
+    superblock_t *img = (superblock_t *)meta;
+    if (img->magic != FS_MAGIC) return -1;
+    if (img->inode_count != FS_MAX_INODES || img->block_count != FS_MAX_BLOCKS) return -3;
+
+    // Disco mapeado muda sem commit: sem cópia carimbada, vale a em uso
+    int c = meta_pick(meta);
+    if (c < 0 && dev->mem && img->active < 2) c = img->active;
+    if (c < 0) return -3;
+
+    int res = image_check(dev, meta_copy(meta, (uint32_t)c), shift);
+    return res < 0 ? res : c;
 }
 
+// Monta um disco já formatado: sem cópia e sem formatar. Só o que vive em
+// RAM é refeito (índice de nomes, dicas, descritores). A geometria precisa
+// bater com a deste kernel. Os códigos separam "não tem RamFS" (-1: pode
+// formatar) de erro de leitura (-2) e de RamFS que não serve (-3): nesses
+// dois o conteúdo do disco pode ser bom e não deve ser apagado.
+int fs_mount_dev(blkdev_t *dev) {
+    int shift = dev_shift(dev);
+    if (!name_index || shift < 0) return -2;
+
+    uint8_t *meta = meta_load(dev, shift);
+    if (!meta) return -2; // Erro de E/S ou sem RAM
+
+    int c = image_probe(dev, meta, shift);
+    if (c < 0) {
+        if (!dev->mem) kfree(meta);
+        return c;
+    }
+
+    // A cópia escolhida vai para o lugar da cópia 0 ([superbloco][cópia]).
+    // Com cache, 'active' continua dizendo onde ela está no dispositivo e
+    // a RAM da outra cópia é devolvida (o krealloc encolhe no lugar).
+    meta_hdr_t *h = (meta_hdr_t *)meta_copy(meta, (uint32_t)c);
+    superblock_t *img = (superblock_t *)meta;
+    img->generation = h->generation;
+    if (c) kmemcpy(meta_copy(meta, 0), meta_copy(meta, 1), META_COPY_SIZE);
+    img->active = dev->mem ? 0 : (uint16_t)c;
+    if (!dev->mem) meta = (uint8_t *)krealloc(meta, META_RAM_SIZE);
+
+    if (disk_use(dev, meta, !dev->mem) < 0) return -2;
+    sb->free_inodes = (uint16_t)bits_free(inode_bitmap, FS_MAX_INODES);
+    sb->free_blocks = (uint16_t)bits_free(block_bitmap, FS_MAX_BLOCKS);
+    index_rebuild();
+    return 0;
+}
+
+// Formata o dispositivo (disco novo ou com outra geometria)
+int fs_format_dev(blkdev_t *dev) {
+    int shift = dev_shift(dev);
+    if (!name_index || shift < 0) return -1;
+
+    uint8_t *meta = dev->mem;
+    if (!meta) meta = (uint8_t *)kmalloc_aligned(META_RAM_SIZE, KMALLOC_DMA_ALIGN);
+    if (!meta) return -1;
+    kmemset(meta, 0, FS_IO_SIZE); // Geração 0 (o fs_format a preserva)
+    if (disk_use(dev, meta, !dev->mem) < 0) return -1;
+
+    fs_format();
+    if (dev->mem) return 0;
+
+    // Um commit em cada cópia: nada do disco antigo sobra para o mount
+    // escolher. Já válido no dispositivo.
+    if (fs_sync() < 0) return -1;
+    return fs_sync();
+}
+
+// Imagem pronta (mkfs do host) em RAM, montada no lugar
+int fs_mount(uint8_t *image, uint32_t size) {
+    if (size != DISK_SIZE || ((uint32_t)image & (KMALLOC_DMA_ALIGN - 1))) return -1;
+
+    // Recusa antes de mexer no ram_dev (pode ser o disco montado agora)
+    blkdev_t probe;
+    blkdev_ram_init(&probe, image, size);
+    if (image_probe(&probe, image, 0) < 0) return -1;
+
+    blkdev_ram_init(&ram_dev, image, size);
+    return fs_mount_dev(&ram_dev) == 0 ? 0 : -1;
+}
+
+// Commit: grava no dispositivo o que só está em RAM, sem nunca gravar por
+// cima do que o último commit deixou (ver CÓPIAS DOS METADADOS):
+//   1. blocos sujos do cache (os dados novos) e flush: o dispositivo pode
+//      reordenar gravações, e os metadados não podem chegar ao meio físico
+//      antes dos dados para os quais apontam;
+//   2. a cópia dos metadados (a troca dos inodes, os blocos reservados já
+//      livres) na cópia fora de uso, com a geração seguinte, e flush;
+//   3. o superbloco apontando para ela (um setor) e flush.
+// Se algo falhar, a RAM volta a apontar para a cópia antiga e os blocos
+// reservados continuam reservados: o disco pode ter ficado no commit
+// anterior, que ainda aponta para eles.
+// Disco mapeado: nada a fazer (a RAM é o disco).
+int fs_sync(void) {
+    if (!sb) return -1;
+    if (data_blocks) return 0;
+
+    if (bcache_sync(&fs_cache) < 0) return -1;
+    if (disk_dev->flush && disk_dev->flush(disk_dev) < 0) return -1;
+
+    int shift = dev_shift(disk_dev);
+    uint32_t old = sb->active;
+    uint32_t slot = old ^ 1;
+    uint8_t *copy = (uint8_t *)meta_hdr;
+
+    pending_apply(1); // Os metadados gravados já vão sem os reservados
+    meta_hdr->generation = sb->generation + 1;
+    meta_hdr->checksum   = meta_checksum(copy);
+    int res = disk_dev->write(disk_dev, (FS_IO_SIZE + (slot ? META_COPY_SIZE : 0)) >> shift,
+                              copy, META_COPY_SIZE >> shift);
+    if (res >= 0 && disk_dev->flush) res = disk_dev->flush(disk_dev);
+
+    if (res >= 0) {
+        sb->active     = (uint16_t)slot;
+        sb->generation = meta_hdr->generation;
+        res = disk_dev->write(disk_dev, 0, disk_memory, 1);
+        if (res >= 0 && disk_dev->flush) res = disk_dev->flush(disk_dev);
+        if (res < 0) {
+            sb->active = (uint16_t)old;
+            sb->generation--;
+        }
+    }
+
+    if (res < 0) {
+        pending_apply(0);
+        return -1;
+    }
+    pending_clear();
+    return 0;
+}
+
+const uint8_t *fs_disk(uint32_t *size) {
+    *size = data_blocks ? DISK_SIZE : 0;
+    if (!data_blocks) return NULL;
+    meta_seal();
+    return disk_memory;
+}
+
+#ifdef __riscv
+// Imagem inicial linkada na seção .fsimage (make FS_DIR=...). Sem imagem,
+// o linker script deixa início == fim.
+extern uint8_t _fs_image_start[], _fs_image_end[];
+#endif
+
 void fs_init(void) {
-    // Aloca a memória física do disco virtual
-    disk_memory = (uint8_t*)kmalloc(DISK_SIZE);
-    
-    if (!disk_memory) {
-        hal_uart_puts("[FS] Critical: Not enough RAM for Disk!\n\r");
+    // Boot: nada montado antes (no host, o heap anterior já foi descartado)
+    disk_memory  = NULL;
+    disk_owned   = 0;
+    fs_cache.dev = NULL;
+
+    // Índice de nomes (só em RAM, reconstruído pelo fs_format/fs_mount)
+    name_index = (name_slot_t *)kmalloc(sizeof(name_slot_t) * FS_INDEX_SLOTS);
+    if (!name_index) {
+        hal_uart_puts("[FS] Critical: Not enough RAM for name index!\n\r");
         return;
     }
 
-    // Define os ponteiros baseados nos offsets
-    sb = (superblock_t *)disk_memory;
-    inode_bitmap = disk_memory + sizeof(superblock_t);
-    block_bitmap = inode_bitmap + (FS_MAX_INODES/8);
-    inode_table  = (inode_t *)(block_bitmap + (FS_MAX_BLOCKS/8));
-    data_blocks  = (uint8_t *)(inode_table + FS_MAX_INODES);
+#ifdef __riscv
+    // 1. Disco persistente (virtio-blk no QEMU): monta, ou formata se vazio
+    // Só formata um disco lido com sucesso e sem RamFS: erro de leitura ou
+    // RamFS de outra geometria não apagam o conteúdo
+    blkdev_t *blk = hal_blk_probe();
+    if (blk) {
+        int res = fs_mount_dev(blk);
+        if (res == 0) {
+#ifndef FAST_BOOT
+            hal_uart_puts("[FS] Mounted block device.\n\r");
+#endif
+            return;
+        }
+        if (res == -1) {
+            hal_uart_puts("[FS] Formatting block device...\n\r");
+            if (fs_format_dev(blk) == 0) return;
+        }
+        hal_uart_puts("[FS] Block device unusable, using RAM.\n\r");
+    }
 
-    // Formata o disco (já que é volátil, sempre formata no boot)
-    fs_format();
+    // 2. Imagem linkada no kernel
+    uint32_t image_size = (uint32_t)(_fs_image_end - _fs_image_start);
+    if (image_size) {
+        if (fs_mount(_fs_image_start, image_size) == 0) {
+#ifndef FAST_BOOT
+            hal_uart_puts("[FS] Mounted linked image.\n\r");
+#endif
+            return;
+        }
+        hal_uart_puts("[FS] Linked image does not match this kernel, formatting.\n\r");
+    }
+#endif
+
+    // 3. Disco volátil em RAM, formatado no boot
+    uint8_t *mem = (uint8_t*)kmalloc_aligned(DISK_SIZE, KMALLOC_DMA_ALIGN);
+    if (!mem) {
+        hal_uart_puts("[FS] Critical: Not enough RAM for Disk!\n\r");
+        return;
+    }
+    blkdev_ram_init(&ram_dev, mem, DISK_SIZE);
+    fs_format_dev(&ram_dev);
+    disk_owned = 1; // kfree do disco se outro for montado
     
+#ifndef FAST_BOOT
     hal_uart_puts("[FS] Mounted. Size: ");
     // print_dec(DISK_SIZE);
     hal_uart_puts(" bytes.\n\r");
+#endif
 }
 
 // ============================================================================
 // OPERAÇÕES (CREATE, WRITE, READ)
 // ============================================================================
 
-int fs_create(const char *name) {
-    if (find_inode_by_name(name) != -1) return -1; // Já existe
+// Cria um inode vazio do tipo 'type' e o liga em 'path' (arquivo ou diretório)
+static int dir_add(const char *path, uint16_t type) {
+    const char *name;
+    uint32_t name_len;
+    int parent = path_parent(path, &name, &name_len);
+    if (parent == -1) return -6;          // Diretório pai não existe
+    if (parent < 0 || !name_valid(name, name_len)) return -4;
+
+    uint32_t hash = name_hash(parent, name, name_len);
+    if (index_find(parent, name, name_len, hash) != -1) return -1; // Já existe
 
     // 1. Aloca um Inode
-    int inode_idx = alloc_bit(inode_bitmap, FS_MAX_INODES);
+    int inode_idx = alloc_inode();
     if (inode_idx < 0) return -2; // Sem inodes livres
 
-    // 2. Configura o Inode
-    inode_table[inode_idx].type = 1; // Arquivo Regular
-    inode_table[inode_idx].size = 0;
-    inode_table[inode_idx].blocks_cnt = 0;
+    // 2. Configura o Inode (diretório novo começa sem blocos: o primeiro
+    //    vem com a primeira entrada)
+    inode_reset(&inode_table[inode_idx], type);
 
-    // 3. Adiciona entrada no Diretório Raiz (Inode 0)
-    inode_t *root = &inode_table[0];
-    dirent_t *dir_entry = NULL;
+    // 3. Adiciona entrada no diretório pai
+    inode_t *dir = &inode_table[parent];
+    int dir_blk = 0, dir_slot = 0, found = 0;
+    dirent_t *entries = NULL;
     
-    // Varre os blocos do root procurando vaga
-    for (int i=0; i < root->blocks_cnt; i++) {
-        dirent_t *entries = (dirent_t *)&data_blocks[root->blocks[i] * FS_BLOCK_SIZE];
-        for (int j=0; j < (FS_BLOCK_SIZE/sizeof(dirent_t)); j++) {
-            if (entries[j].inode_idx == 0xFFFF) {
-                dir_entry = &entries[j];
-                break;
+    // Varre os blocos do pai procurando vaga
+    for (dir_blk=0; dir_blk < dir->blocks_cnt && !found; dir_blk++) {
+        entries = dir_block(parent, dir_blk, 0);
+        if (!entries) break; // Erro de E/S
+        for (dir_slot=0; dir_slot < FS_DIRENTS_PER_BLOCK; dir_slot++) {
+            if (entries[dir_slot].inode_idx == 0xFFFF) { found = 1; break; }
+        }
+    }
+    if (found) dir_blk--;
+
+    int res = 0;
+    if (!found && dir_blk < dir->blocks_cnt) {
+        res = -7;
+    } else if (!found) {
+        // Blocos do pai cheios: cresce o diretório com mais um bloco
+        blocks_reserve(2);
+        if (dir->blocks_cnt >= FS_MAX_DIR_BLOCKS || inode_grow(dir, 1) != 1) {
+            res = -3;
+        } else {
+            dir_blk  = dir->blocks_cnt - 1;
+            dir_slot = 0;
+            entries = dir_block(parent, dir_blk, 1);
+            if (entries) {
+                for (int j=0; j < FS_DIRENTS_PER_BLOCK; j++) entries[j].inode_idx = 0xFFFF;
+            } else {
+                inode_truncate(dir, (uint32_t)dir_blk * FS_BLOCK_SIZE); // Devolve o bloco
+                res = -7;
             }
         }
-        if (dir_entry) break;
     }
 
-    if (!dir_entry) {
-        // Diretório cheio (precisaria alocar mais um bloco pro root... simplificando: erro)
-        free_bit(inode_bitmap, inode_idx);
-        return -3; 
+    // Salva o nome e linka o inode (de novo pelo dir_block: marca o bloco sujo)
+    if (res == 0) {
+        entries = dir_block(parent, dir_blk, 1);
+        if (!entries) res = -7;
+    }
+    if (res < 0) {
+        inode_table[inode_idx].type = 0;
+        free_inode(inode_idx);
+        return res;
     }
 
-    // Salva o nome e linka o inode
+    dirent_t *dir_entry = &entries[dir_slot];
     dir_entry->inode_idx = inode_idx;
-    for(int i=0; i<FS_MAX_NAME; i++) dir_entry->name[i] = name[i];
+    for(int i=0; i<FS_MAX_NAME; i++) dir_entry->name[i] = ((uint32_t)i < name_len) ? name[i] : 0;
+    index_insert(hash, inode_idx, parent, dir_blk, dir_slot);
     
     return 0;
 }
 
+int fs_create(const char *name) {
+    return dir_add(name, FS_TYPE_FILE);
+}
+
+int fs_mkdir(const char *path) {
+    return dir_add(path, FS_TYPE_DIR);
+}
+
+// ----------------------------------------------------------------------------
+// E/S por offset (base de fs_read/fs_write e dos descritores)
+// ----------------------------------------------------------------------------
+// FS_BLOCK_SIZE é potência de 2: '/' e '%' por ele viram shift e máscara.
+
+_Static_assert((FS_BLOCK_SIZE & (FS_BLOCK_SIZE - 1)) == 0, "FS_BLOCK_SIZE precisa ser potência de 2");
+
+// Nenhum arquivo passa do tamanho do disco
+#define FS_MAX_FILE_SIZE ((uint32_t)FS_MAX_BLOCKS * FS_BLOCK_SIZE)
+
+// Uma cópia por trecho contíguo (extent), não por bloco. Bytes lidos ou
+// -7 (erro de E/S)
+static int inode_read(inode_t *inode, uint32_t off, uint8_t *buffer, uint32_t len) {
+    if (off >= inode->size) return 0;
+    if (len > inode->size - off) len = inode->size - off;
+
+    uint32_t done = 0;
+    while (done < len) {
+        uint32_t pos   = off + done;
+        uint32_t inblk = pos % FS_BLOCK_SIZE;
+        uint32_t run;
+        uint32_t phys  = inode_map(inode, pos / FS_BLOCK_SIZE, &run);
+
+        // Mapeado: o extent inteiro de uma vez (DMA). Com cache: um bloco
+        // por vez, cópia síncrona (o buffer pode ser reciclado logo depois)
+        uint32_t chunk = (data_blocks ? run * FS_BLOCK_SIZE : FS_BLOCK_SIZE) - inblk;
+        if (chunk > len - done) chunk = len - done;
+
+        uint8_t *src = block_ptr(phys, 0);
+        if (!src) { kmem_wait(); return -7; }
+        if (data_blocks) kmemcpy_async(&buffer[done], src + inblk, chunk);
+        else kmemcpy(&buffer[done], src + inblk, chunk);
+        done += chunk;
+    }
+    kmem_wait();
+    return (int)done;
+}
+
+// Escreve a partir de 'off' (<= size). Os blocos que faltam são alocados
+// todos de uma vez (trecho contíguo sempre que possível) e os que o arquivo
+// já tem são reaproveitados. Retorna os bytes escritos (menos que 'len' se
+// o disco ou a tabela indireta acabarem) ou -7 (erro de E/S; o tamanho do
+// arquivo não muda).
+static int inode_write(inode_t *inode, uint32_t off, const uint8_t *data, uint32_t len) {
+    if (off >= FS_MAX_FILE_SIZE) return 0;
+    if (len > FS_MAX_FILE_SIZE - off) len = FS_MAX_FILE_SIZE - off;
+
+    uint32_t need = (off + len + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE;
+    if (need > inode->blocks_cnt) {
+        blocks_reserve(need - inode->blocks_cnt + 1); // + a tabela indireta
+        inode_grow(inode, need - inode->blocks_cnt);
+    }
+
+    uint32_t avail = (uint32_t)inode->blocks_cnt * FS_BLOCK_SIZE;
+    if (off >= avail) return 0;
+    if (len > avail - off) len = avail - off;
+
+    uint32_t done = 0;
+    while (done < len) {
+        uint32_t pos   = off + done;
+        uint32_t inblk = pos % FS_BLOCK_SIZE;
+        uint32_t run;
+        uint32_t phys  = inode_map(inode, pos / FS_BLOCK_SIZE, &run);
+
+        uint32_t chunk = (data_blocks ? run * FS_BLOCK_SIZE : FS_BLOCK_SIZE) - inblk;
+        if (chunk > len - done) chunk = len - done;
+
+        uint8_t *dst = block_ptr(phys, 1);
+        if (!dst) { kmem_wait(); return -7; }
+        if (data_blocks) kmemcpy_async(dst + inblk, &data[done], chunk);
+        else kmemcpy(dst + inblk, &data[done], chunk);
+        done += chunk;
+    }
+    kmem_wait();
+
+    if (off + done > inode->size) inode->size = off + done;
+    return (int)done;
+}
+
+// Substitui o conteúdo inteiro com cópia na escrita: o conteúdo novo vai
+// para blocos novos, descritos por um inode sombra; só com tudo escrito o
+// inode do arquivo é trocado pela sombra (uma cópia de 24 bytes) e os
+// blocos antigos são liberados. Falta de espaço no meio = nada muda.
+// Com o disco atrás do cache, a troca chega ao dispositivo no commit: a
+// cada FS_COMMIT_BATCH escritas (ou fs_sync), não uma gravação de
+// metadados por escrita.
 int fs_write(const char *name, const uint8_t *data, uint32_t len) {
     int idx = find_inode_by_name(name);
     if (idx < 0) return -1;
+    if (len > FS_MAX_FILE_SIZE) return -2; // Maior que o disco
+    if (map_count[idx]) return -3;          // Mapeado: somente leitura
 
     inode_t *inode = &inode_table[idx];
-    
-    // Simplificação: Sobrescreve tudo. Libera blocos antigos.
-    // (Num FS real, reutilizariamos)
-    for(int i=0; i<inode->blocks_cnt; i++) {
-        free_bit(block_bitmap, inode->blocks[i]);
+    inode_t shadow;
+    inode_reset(&shadow, inode->type);
+    int written = inode_write(&shadow, 0, data, len);
+    if (written != (int)len) {
+        inode_truncate(&shadow, 0);
+        return written < 0 ? written : -4; // E/S ou disco cheio: o arquivo continua como estava
     }
-    inode->blocks_cnt = 0;
-    inode->size = 0;
-
-    // Calcula quantos blocos precisamos
-    int blocks_needed = (len + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE;
-    if (blocks_needed > 6) return -2; // Arquivo muito grande para ponteiros diretos
-
-    int bytes_written = 0;
-    const uint8_t *src_ptr = data;
-
-    for (int i=0; i<blocks_needed; i++) {
-        int blk_idx = alloc_bit(block_bitmap, FS_MAX_BLOCKS);
-        if (blk_idx < 0) break; // Disco cheio
-
-        inode->blocks[i] = blk_idx;
-        inode->blocks_cnt++;
-        
-        // Copia dados para o bloco
-        uint8_t *dst_ptr = &data_blocks[blk_idx * FS_BLOCK_SIZE];
-        int chunk = (len > FS_BLOCK_SIZE) ? FS_BLOCK_SIZE : len;
-        
-        for(int k=0; k<chunk; k++) dst_ptr[k] = *src_ptr++;
-        
-        len -= chunk;
-        bytes_written += chunk;
-        inode->size += chunk;
-    }
-    
-    return bytes_written;
+
+    inode_t old = *inode;
+    *inode = shadow;
+    inode_truncate(&old, 0);
+
+    if (!data_blocks && ++pending_writes >= FS_COMMIT_BATCH) fs_sync();
+    return (int)len;
 }
 
 int fs_read(const char *name, uint8_t *buffer, uint32_t max_len) {
     int idx = find_inode_by_name(name);
     if (idx < 0) return -1;
+    return inode_read(&inode_table[idx], 0, buffer, max_len);
+}
+
+// ----------------------------------------------------------------------------
+// DESCRITORES DE ARQUIVO
+// ----------------------------------------------------------------------------
+// Tabela global (o shell e as apps compartilham o mesmo espaço): o nome é
+// resolvido só no open; depois cada operação usa o inode guardado e o
+// offset do descritor. Anexar uma linha custa O(linha), não O(arquivo).
+
+static fs_fd_t *fd_get(int fd) {
+    if (fd < 0 || fd >= FS_MAX_FD || !fd_table[fd].inode) return NULL;
+    return &fd_table[fd];
+}
+
+// Algum descritor aberto com (pelo menos) 'flags' no inode? 0 = qualquer um
+static int inode_is_open(int inode_idx, uint32_t flags) {
+    for (int i = 0; i < FS_MAX_FD; i++) {
+        if (fd_table[i].inode && fd_table[i].inode_idx == inode_idx &&
+            (fd_table[i].flags & flags) == flags) return 1;
+    }
+    return 0;
+}
+
+int fs_open(const char *name, uint32_t flags) {
+    int idx = find_inode_by_name(name);
+    if (idx < 0) {
+        if (!(flags & FS_O_CREATE)) return -1;
+        int res = fs_create(name);
+        if (res < 0) return res;
+        idx = find_inode_by_name(name);
+    }
+
+    if ((flags & FS_O_WRITE) && map_count[idx]) return -3; // Mapeado: somente leitura
+
+    int fd = 0;
+    while (fd < FS_MAX_FD && fd_table[fd].inode) fd++;
+    if (fd == FS_MAX_FD) return -5; // Sem descritores livres
 
     inode_t *inode = &inode_table[idx];
-    uint32_t total_read = 0;
-    
-    for (int i=0; i < inode->blocks_cnt; i++) {
-        if (total_read >= max_len) break;
-        
-        uint8_t *src = &data_blocks[inode->blocks[i] * FS_BLOCK_SIZE];
-        
-        // Quanto ler deste bloco?
-        // Se for o último bloco, lemos apenas o que resta do 'inode->size'
-        // Mas simplificando: lemos FS_BLOCK_SIZE ou o que cabe no buffer
-        
-        int chunk = FS_BLOCK_SIZE;
-        // Ajuste fino para não ler lixo além do EOF seria necessário aqui
-        // Mas como zeramos o disco na formatação, ok.
-        
-        for(int k=0; k<chunk && total_read < max_len && total_read < inode->size; k++) {
-            buffer[total_read++] = src[k];
-        }
+    if ((flags & FS_O_TRUNC) && (flags & FS_O_WRITE)) inode_truncate(inode, 0);
+
+    fd_table[fd].inode     = inode;
+    fd_table[fd].inode_idx = (uint16_t)idx;
+    fd_table[fd].flags     = (uint16_t)flags;
+    fd_table[fd].offset    = 0;
+    return fd;
+}
+
+int fs_close(int fd) {
+    fs_fd_t *f = fd_get(fd);
+    if (!f) return -1;
+    f->inode = NULL;
+    return 0;
+}
+
+int fs_fread(int fd, uint8_t *buffer, uint32_t len) {
+    fs_fd_t *f = fd_get(fd);
+    if (!f || !(f->flags & FS_O_READ)) return -1;
+    int n = inode_read(f->inode, f->offset, buffer, len);
+    if (n < 0) return n; // Erro de E/S
+    f->offset += n;
+    return n;
+}
+
+int fs_fwrite(int fd, const uint8_t *data, uint32_t len) {
+    fs_fd_t *f = fd_get(fd);
+    if (!f || !(f->flags & FS_O_WRITE)) return -1;
+    if (f->flags & FS_O_APPEND) f->offset = f->inode->size;
+    // O arquivo pode ter encolhido com o descritor aberto (fs_write pelo
+    // nome, FS_O_TRUNC de outro descritor): sem buracos, continua do fim
+    if (f->offset > f->inode->size) f->offset = f->inode->size;
+
+    int n = inode_write(f->inode, f->offset, data, len);
+    if (n < 0) return n;              // Erro de E/S
+    if (n == 0 && len > 0) return -2; // Disco cheio ou arquivo no tamanho máximo
+    f->offset += n;
+    return n;
+}
+
+// Sem buracos: o offset fica entre 0 e o tamanho atual do arquivo (num
+// diretório o tamanho é 0: só volta ao início)
+int fs_lseek(int fd, int32_t off, int whence) {
+    fs_fd_t *f = fd_get(fd);
+    if (!f) return -1;
+
+    int32_t base;
+    if      (whence == FS_SEEK_SET) base = 0;
+    else if (whence == FS_SEEK_CUR) base = (int32_t)f->offset;
+    else if (whence == FS_SEEK_END) base = (int32_t)f->inode->size;
+    else return -1;
+
+    int32_t pos = base + off;
+    if (pos < 0 || (uint32_t)pos > f->inode->size) return -1;
+    f->offset = (uint32_t)pos;
+    return pos;
+}
+
+// ----------------------------------------------------------------------------
+// MAPEAMENTO DIRETO (fs_map)
+// ----------------------------------------------------------------------------
+
+// Junta o arquivo num único extent: aloca um trecho com todos os blocos,
+// copia o conteúdo e devolve os blocos antigos. Já contíguo = nada a fazer.
+static int inode_make_contiguous(inode_t *inode) {
+    int last;
+    if (inode->blocks_cnt == extent_blocks(inode, &last) && last <= 0) return 0;
+
+    uint16_t start;
+    uint32_t n = alloc_run(inode->blocks_cnt, &start);
+    if (n < inode->blocks_cnt) {
+        for (uint32_t i = 0; i < n; i++) free_block(start + i);
+        return -2; // Nenhum trecho livre do tamanho do arquivo
     }
-    return total_read;
+
+    uint32_t size = inode->size;
+    inode_read(inode, 0, &data_blocks[start * FS_BLOCK_SIZE], size);
+    inode_truncate(inode, 0);
+
+    inode->extents[0].start = start;
+    inode->extents[0].len   = (uint16_t)n;
+    inode->blocks_cnt       = (uint16_t)n;
+    inode->size             = size;
+    return 0;
 }
 
-int fs_list(char *buffer, uint32_t max_len) {
+int fs_map(const char *name, const uint8_t **ptr, uint32_t *len) {
+    int idx = find_inode_by_name(name);
+    if (idx < 0) return -1;
+    if (inode_is_open(idx, FS_O_WRITE)) return -3; // Alguém pode mudar o conteúdo
 
-    inode_t *root = &inode_table[0];
-    uint32_t pos = 0;
-    
-    for (int i = 0; i < root->blocks_cnt; i++) {
-        dirent_t *entries = (dirent_t *)&data_blocks[root->blocks[i] * FS_BLOCK_SIZE];
-        
-        for (int j = 0; j < (FS_BLOCK_SIZE/sizeof(dirent_t)); j++) {
-            
-            if (entries[j].inode_idx != 0xFFFF) {
-                
-                // Margem
-                if (pos < max_len - 1) buffer[pos++] = ' ';
-                if (pos < max_len - 1) buffer[pos++] = ' ';
-
-                // Copia nome
-                const char *n = entries[j].name;
-                while (*n && pos < max_len - 1) buffer[pos++] = *n++;
-                
-                // Nova linha
-                if (pos < max_len - 1) buffer[pos++] = '\n';
-            }
-        }
+    if (!data_blocks) return -2; // Disco atrás do cache: nada para apontar
+
+    inode_t *inode = &inode_table[idx];
+    *len = inode->size;
+    if (inode->size == 0) { *ptr = NULL; return 0; } // Nada para mapear
+
+    if (map_count[idx] == 0xFF) return -5;
+    if (map_count[idx] == 0) {
+        int res = inode_make_contiguous(inode);
+        if (res < 0) return res;
     }
-    
-    buffer[pos] = 0;
+
+    map_count[idx]++;
+    *ptr = &data_blocks[inode->extents[0].start * FS_BLOCK_SIZE];
     return 0;
+}
 
+int fs_unmap(const uint8_t *ptr) {
+    if (!ptr) return 0; // Arquivo vazio: fs_map não pegou referência
+
+    for (int i = 0; i < FS_MAX_INODES; i++) {
+        if (map_count[i] &&
+            ptr == &data_blocks[inode_table[i].extents[0].start * FS_BLOCK_SIZE]) {
+            map_count[i]--;
+            return 0;
+        }
+    }
+    return -1;
 }
 
-// Comando para deletar arquivo
-int fs_delete(const char *name) {
+// ----------------------------------------------------------------------------
+// LEITURA DE DIRETÓRIOS (fs_opendir/fs_readdir)
+// ----------------------------------------------------------------------------
+// O diretório aberto ocupa um descritor comum (flag FS_O_DIR, sem leitura
+// nem escrita de bytes). O offset do descritor é o cursor: (bloco << 8) |
+// entrada, então continuar de onde parou não custa divisão nem varredura,
+// e remover entradas entre duas chamadas não repete as que ficaram.
 
-    // 1. Busca o arquivo
-    int inode_idx = find_inode_by_name(name);
-    if (inode_idx < 0) return -1; // Erro: Não existe
+_Static_assert(FS_DIRENTS_PER_BLOCK < 256, "entrada do cursor não cabe em 8 bits");
 
-    inode_t *inode = &inode_table[inode_idx];
+int fs_opendir(const char *path) {
+    uint32_t dir = 0;
+    if (!path_is_root(path)) {
+        int slot = path_lookup(path);
+        if (slot < 0) return -1;
+        dir = name_index[slot].inode;
+    }
+    if (inode_table[dir].type != FS_TYPE_DIR) return -1;
+
+    int fd = 0;
+    while (fd < FS_MAX_FD && fd_table[fd].inode) fd++;
+    if (fd == FS_MAX_FD) return -5; // Sem descritores livres
 
-    // 2. Libera os blocos de dados que o arquivo usava
-    for (int i = 0; i < inode->blocks_cnt; i++) {
-        free_bit(block_bitmap, inode->blocks[i]);
+    fd_table[fd].inode     = &inode_table[dir];
+    fd_table[fd].inode_idx = (uint16_t)dir;
+    fd_table[fd].flags     = FS_O_DIR;
+    fd_table[fd].offset    = 0;
+    return fd;
+}
+
+int fs_readdir(int fd, fs_dirent_t *out, uint32_t max) {
+    fs_fd_t *f = fd_get(fd);
+    if (!f || !(f->flags & FS_O_DIR)) return -1;
+
+    inode_t *d   = f->inode;
+    uint32_t blk = f->offset >> 8;
+    uint32_t pos = f->offset & 0xFF;
+    uint32_t n   = 0;
+
+    while (n < max && blk < d->blocks_cnt) {
+        dirent_t *entries = dir_block(f->inode_idx, blk, 0);
+        if (!entries) {
+            if (n == 0) return -7; // Erro de E/S (o cursor fica onde estava)
+            break;
+        }
+        for (; pos < FS_DIRENTS_PER_BLOCK && n < max; pos++) {
+            if (entries[pos].inode_idx == 0xFFFF) continue;
+            inode_t *inode = &inode_table[entries[pos].inode_idx];
+            fs_dirent_t *r = &out[n++];
+            r->inode    = entries[pos].inode_idx;
+            r->type     = inode->type;
+            r->size     = inode->size;
+            r->blocks   = inode->blocks_cnt + (inode->indirect != FS_NO_BLOCK);
+            r->reserved = 0;
+            kmemcpy(r->name, entries[pos].name, FS_MAX_NAME);
+        }
+        if (pos == FS_DIRENTS_PER_BLOCK) { blk++; pos = 0; }
     }
 
-    // 3. Limpa o Inode (Metadados) e libera no bitmap
-    inode->size = 0;
-    inode->blocks_cnt = 0;
+    f->offset = (blk << 8) | pos;
+    return (int)n;
+}
+
+// Desliga o dirent do slot e devolve o inode (e os blocos dele).
+// 0, ou -7 se o dirent não pôde ser lido (nada muda)
+static int dir_unlink(int slot) {
+    int inode_idx = name_index[slot].inode;
+    inode_t *inode = &inode_table[inode_idx];
+    dirent_t *entry = slot_dirent(&name_index[slot], 1);
+    if (!entry) return -7;
+
+    // 1. Libera os blocos de dados (extents, indiretos e a própria tabela)
+    inode_truncate(inode, 0);
+
+    // 2. Limpa o Inode (Metadados) e libera no bitmap
     inode->type = 0;
-    free_bit(inode_bitmap, inode_idx);
+    free_inode(inode_idx);
 
-    // 4. Remove a entrada do Diretório Raiz (Unlink)
-    // Precisamos varrer o Inode 0 (Root) para apagar a referência
-    inode_t *root = &inode_table[0];
-    
-    for (int i = 0; i < root->blocks_cnt; i++) {
-        // Acessa o bloco de diretório
-        dirent_t *entries = (dirent_t *)&data_blocks[root->blocks[i] * FS_BLOCK_SIZE];
-        int max_entries = FS_BLOCK_SIZE / sizeof(dirent_t);
-        
-        for (int j = 0; j < max_entries; j++) {
-            // Se encontrar a entrada que aponta para nosso inode...
-            if (entries[j].inode_idx == inode_idx) {
-                entries[j].inode_idx = 0xFFFF; // Marca como vaga livre
-                entries[j].name[0] = 0;        // Limpa o nome
-                return 0; // Sucesso!
-            }
+    // 3. Remove a entrada do diretório pai (Unlink) e do índice
+    entry->inode_idx = 0xFFFF; // Marca como vaga livre
+    entry->name[0] = 0;        // Limpa o nome
+    index_remove(slot);
+    return 0;
+}
+
+// Comando para deletar arquivo
+int fs_delete(const char *name) {
+    // Busca o arquivo (o slot do índice já diz onde está o dirent)
+    int slot = path_lookup(name);
+    if (slot < 0) return -1; // Erro: Não existe
+    int inode_idx = name_index[slot].inode;
+    if (inode_table[inode_idx].type == FS_TYPE_DIR) return -2; // Diretório: fs_rmdir
+    if (inode_is_open(inode_idx, 0) || map_count[inode_idx]) return -3; // Aberto ou mapeado
+
+    return dir_unlink(slot);
+}
+
+// Remove um diretório vazio. Os blocos de um diretório não encolhem quando
+// ele esvazia, então "vazio" é conferido varrendo os dirents.
+int fs_rmdir(const char *path) {
+    int slot = path_lookup(path);
+    if (slot < 0) return -1;
+    uint32_t dir = name_index[slot].inode;
+    inode_t *d = &inode_table[dir];
+    if (d->type != FS_TYPE_DIR) return -1;
+    if (inode_is_open(dir, 0)) return -3; // Aberto por fs_opendir
+
+    for (int i = 0; i < d->blocks_cnt; i++) {
+        dirent_t *entries = dir_block(dir, i, 0);
+        if (!entries) return -7;
+        for (int j = 0; j < FS_DIRENTS_PER_BLOCK; j++) {
+            if (entries[j].inode_idx != 0xFFFF) return -2; // Não vazio
         }
     }
-    
-    return -2; // Erro estranho: Inode existia mas não estava listado no diretório
 
-}
\ No newline at end of file
+    return dir_unlink(slot);
+}
+
+// Uso do disco em O(1): os contadores do superbloco são mantidos pelos
+// alocadores de bitmap
+int fs_statfs(fs_statfs_t *st) {
+    if (!sb) return -1;
+    st->block_size   = FS_BLOCK_SIZE;
+    st->total_blocks = sb->block_count;
+    st->free_blocks  = sb->free_blocks + pending_blocks; // Voltam no commit
+    st->total_inodes = sb->inode_count;
+    st->free_inodes  = sb->free_inodes;
+    return 0;
+}
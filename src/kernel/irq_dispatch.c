@@ -1,5 +1,6 @@
 #include "../include/hal/hal_irq.h"
 #include "../include/hal/hal_plic.h"
+#include "../include/kernel/trace.h"
 #include <stddef.h>
 
 // Tabela de Vetores de Interrupção (RAM)
@@ -46,7 +47,9 @@ void irq_dispatch(uint32_t source) {
     // Verifica se o ID é válido e se existe função registrada
     if (source > 0 && source < PLIC_MAX_SOURCES) {
         if (g_isr_table[source] != NULL) {
+            TRACE_IRQ_ENTER(source);
             g_isr_table[source](); // Executa o Callback da Aplicação
+            TRACE_IRQ_EXIT(source);
         }
     }
 
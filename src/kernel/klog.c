@@ -0,0 +1,156 @@
+#include "../../include/kernel/klog.h"
+#include "../../include/kernel/task.h"
+#include "../../include/hal/hal_irq.h"
+#include "../../include/hal/hal_timer.h"
+
+// ============================================================================
+// RING BUFFER
+// ============================================================================
+// 'head' e 'tail' são contadores livres (só crescem); o índice real é
+// contador & (KLOG_RING_SIZE - 1). Vários produtores (tarefas e trap_handler)
+// num único núcleo: a reserva do slot e a cópia rodam com MIE desligado por
+// poucas instruções, sem mutex e sem nunca bloquear. Consumidor único (Logger).
+
+#define KLOG_MASK (KLOG_RING_SIZE - 1)
+
+static klog_record_t ring[KLOG_RING_SIZE];
+static volatile uint32_t head = 0;   // Escrito pelos produtores
+static volatile uint32_t tail = 0;   // Escrito pelo consumidor
+static volatile uint32_t dropped = 0;
+
+void klog_write(uint32_t id_level, uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t tid  = current_task ? current_task->tid : KLOG_TID_KERNEL;
+    uint32_t time = (uint32_t)hal_timer_get_cycles();
+
+    uint32_t flags = hal_irq_save();
+
+    if (head - tail >= KLOG_RING_SIZE) {
+        // Cheio: descarta o novo (não sobrescreve o que o Logger vai ler)
+        dropped++;
+    } else {
+        klog_record_t *r = &ring[head & KLOG_MASK];
+        r->hdr    = id_level | (tid & 0xFF);
+        r->time   = time;
+        r->arg[0] = a;
+        r->arg[1] = b;
+        r->arg[2] = c;
+        asm volatile ("" ::: "memory"); // Registro completo antes de publicar
+        head++;
+    }
+
+    hal_irq_restore(flags);
+}
+
+int klog_pop(klog_record_t *out) {
+    if (tail == head) return 0;
+
+    const klog_record_t *r = &ring[tail & KLOG_MASK];
+    out->hdr    = r->hdr;
+    out->time   = r->time;
+    out->arg[0] = r->arg[0];
+    out->arg[1] = r->arg[1];
+    out->arg[2] = r->arg[2];
+    asm volatile ("" ::: "memory"); // Copiado antes de liberar o slot
+    tail++;
+    return 1;
+}
+
+uint32_t klog_take_dropped(void) {
+    uint32_t flags = hal_irq_save();
+    uint32_t n = dropped;
+    dropped = 0;
+    hal_irq_restore(flags);
+    return n;
+}
+
+// ============================================================================
+// FORMATAÇÃO (fora do caminho crítico: só a Logger chama)
+// ============================================================================
+
+typedef struct {
+    char *buf;
+    uint32_t pos;
+    uint32_t size;
+} klog_out_t;
+
+static void out_char(klog_out_t *o, char c) {
+    if (o->pos + 1 < o->size) o->buf[o->pos++] = c;
+}
+
+static void out_str(klog_out_t *o, const char *s) {
+    while (*s) out_char(o, *s++);
+}
+
+static void out_dec(klog_out_t *o, uint32_t v) {
+    char tmp[11];
+    int i = 0;
+    do { tmp[i++] = '0' + (v % 10); v /= 10; } while (v);
+    while (i > 0) out_char(o, tmp[--i]);
+}
+
+static void out_hex(klog_out_t *o, uint32_t v, int digits) {
+    static const char hex[] = "0123456789abcdef";
+    for (int i = digits - 1; i >= 0; i--) out_char(o, hex[(v >> (i * 4)) & 0xF]);
+}
+
+#ifndef KLOG_RAW
+
+static const char *const klog_formats[KLOG_ID_COUNT] = {
+#define KLOG_FMT(id, fmt) fmt,
+#include "../../include/kernel/klog_ids.h"
+#undef KLOG_FMT
+};
+
+void klog_format(const klog_record_t *rec, char *buf, uint32_t size) {
+    klog_out_t o = { buf, 0, size };
+    uint32_t id = KLOG_HDR_ID(rec->hdr);
+
+    // Carimbo de tempo em ms
+    out_char(&o, '[');
+    out_dec(&o, rec->time / (hal_timer_get_freq() / 1000));
+    out_str(&o, "] ");
+
+    if (id >= KLOG_ID_COUNT) {
+        out_str(&o, "klog: unknown id ");
+        out_dec(&o, id);
+    } else {
+        const char *f = klog_formats[id];
+        int argi = 0;
+        while (*f) {
+            if (*f != '%') { out_char(&o, *f++); continue; }
+            f++;
+            char spec = *f ? *f++ : 0;
+            uint32_t v = (argi < 3) ? rec->arg[argi] : 0;
+            switch (spec) {
+                case 'u': out_dec(&o, v); argi++; break;
+                case 'd':
+                    if ((int32_t)v < 0) { out_char(&o, '-'); v = 0u - v; }
+                    out_dec(&o, v); argi++;
+                    break;
+                case 'x': out_str(&o, "0x"); out_hex(&o, v, 8); argi++; break;
+                case '%': out_char(&o, '%'); break;
+                default:  break;
+            }
+        }
+    }
+
+    out_char(&o, '\n');
+    buf[o.pos] = 0;
+}
+
+#else
+
+// Sem strings na imagem: "#K <hdr> <time> <a0> <a1> <a2>" para o host
+void klog_format(const klog_record_t *rec, char *buf, uint32_t size) {
+    klog_out_t o = { buf, 0, size };
+    out_str(&o, "#K");
+    const uint32_t *w = (const uint32_t *)rec;
+    for (uint32_t i = 0; i < sizeof(klog_record_t) / 4; i++) {
+        out_char(&o, ' ');
+        out_hex(&o, w[i], 8);
+    }
+    out_char(&o, '\n');
+    buf[o.pos] = 0;
+}
+
+#endif
@@ -0,0 +1,85 @@
+#include "../../include/kernel/kmem.h"
+#include "../../include/hal/hal_dma.h"
+#include "../../include/util/string.h"
+
+// Bytes preenchidos pela CPU antes do kmemset começar a se replicar via DMA
+#define KMEM_SEED_BYTES  64
+
+static uint32_t dma_threshold = KMEM_DMA_THRESHOLD;
+
+void kmem_set_dma_threshold(uint32_t bytes) {
+    dma_threshold = bytes;
+}
+
+uint32_t kmem_get_dma_threshold(void) {
+    return dma_threshold;
+}
+
+// O DMA só move palavras: exige o mesmo alinhamento em origem e destino
+// (e ao menos uma palavra, para a cabeça nunca passar de 'n')
+static int kmem_use_dma(uintptr_t d, uintptr_t s, uint32_t n) {
+    return n >= dma_threshold && n >= 4 && ((d ^ s) & 3) == 0;
+}
+
+void kmemcpy_async(void *dst, const void *src, uint32_t n) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    if (!kmem_use_dma((uintptr_t)d, (uintptr_t)s, n)) {
+        memcpy(d, s, n);
+        return;
+    }
+
+    // 1. Cabeça desalinhada pela CPU
+    uint32_t head = (uint32_t)(-(uintptr_t)d) & 3;
+    if (head) {
+        memcpy(d, s, head);
+        d += head; s += head; n -= head;
+    }
+
+    // 2. Miolo em palavras pelo DMA (não bloqueia)
+    uint32_t words = n >> 2;
+    hal_dma_start((uint32_t)(uintptr_t)s, (uint32_t)(uintptr_t)d, words, 0);
+
+    // 3. Cauda pela CPU enquanto o DMA trabalha (regiões disjuntas)
+    uint32_t body = words << 2;
+    if (n > body) memcpy(d + body, s + body, n - body);
+}
+
+void kmem_wait(void) {
+    hal_dma_wait();
+}
+
+void kmemcpy(void *dst, const void *src, uint32_t n) {
+    kmemcpy_async(dst, src, n);
+    kmem_wait();
+}
+
+void kmemset(void *dst, uint8_t c, uint32_t n) {
+    uint8_t *d = (uint8_t *)dst;
+
+    if (n < dma_threshold || n < 2 * KMEM_SEED_BYTES) {
+        memset(d, c, n);
+        return;
+    }
+
+    // Alinha o destino (cabeça pela CPU)
+    uint32_t head = (uint32_t)(-(uintptr_t)d) & 3;
+    if (head) {
+        memset(d, c, head);
+        d += head; n -= head;
+    }
+
+    uint32_t body = n & ~3u;
+    if (n > body) memset(d + body, c, n - body);
+
+    // O DMA não tem modo "preencher": a CPU escreve uma semente e o DMA
+    // copia a parte já preenchida para frente, dobrando a cada passo.
+    memset(d, c, KMEM_SEED_BYTES);
+    uint32_t done = KMEM_SEED_BYTES;
+    while (done < body) {
+        uint32_t chunk = (body - done < done) ? (body - done) : done;
+        hal_dma_memcpy((uint32_t)(uintptr_t)d, (uint32_t)(uintptr_t)(d + done), chunk >> 2, 0);
+        done += chunk;
+    }
+}
@@ -23,11 +23,6 @@ void log_warn(const char* msg) {
     hal_uart_puts("\n\r");
 }
 
-void log_sched(const char* msg) {
-    hal_uart_puts(ANSI_YELLOW "[ SCHED ] " ANSI_RESET);
-    hal_uart_puts(msg);
-}
-
 void print_hex(unsigned int val) {
     char hex_chars[] = "0123456789ABCDEF";
     hal_uart_puts("0x");
@@ -21,6 +21,9 @@
 #include "../../include/apps/apps.h"
 #include "../../include/kernel/mm.h"
 #include "../../include/kernel/fs.h"
+#include "../../include/kernel/bootlog.h"
+#include "../../include/kernel/trace.h"
+#include "../../include/kernel/prof.h"
 
 // ======================================================================================
 //  PROTÓTIPOS DE FUNÇÕES
@@ -43,6 +46,8 @@ extern void trap_entry();
 // Símbolos do Linker
 extern void _start(void);
 extern void _end(void);
+extern void _dma_start(void);
+extern void _dma_end(void);
 
 // Tamanho da HEAP (128 KB)
 #define HEAP_SIZE 128  
@@ -120,14 +125,34 @@ void trap_handler(unsigned int mcause, unsigned int mepc, uint32_t *ctx) {
         //  TRATAMENTO DE INTERRUPÇÕES (HARDWARE)
         // ==============================================================================
         switch (cause_code) {
-            case 7: // Machine Timer Interrupt
-                // 1. Re-armar o alarme para o futuro
-                hal_timer_set_irq_delta(TICK_DELTA_CYCLES);
-                
-                // 2. O tempo da tarefa atual acabou (Time Slice).
-                // Chamamos o chefe (Scheduler) para escolher a próxima.
-                schedule();
+            case 7: { // Machine Timer Interrupt
+                TRACE_IRQ_ENTER(TRACE_IRQ_TIMER);
+
+                // Profiler ativo: o timer dispara a PROF_HZ para amostrar o PC
+                // e o escalonador só roda quando os períodos somam um tick.
+                static uint32_t slice_cycles = 0;
+                uint32_t period = prof_sample(mepc, current_task ? current_task->tid : 0xFF);
+
+                if (period == 0) {
+                    // 1. Re-armar o alarme para o futuro
+                    hal_timer_set_irq_delta(TICK_DELTA_CYCLES);
+                    slice_cycles = 0;
+
+                    // 2. O tempo da tarefa atual acabou (Time Slice).
+                    // Chamamos o chefe (Scheduler) para escolher a próxima.
+                    schedule();
+                } else {
+                    hal_timer_set_irq_delta(period);
+                    slice_cycles += period;
+                    if (slice_cycles >= TICK_DELTA_CYCLES) {
+                        slice_cycles = 0;
+                        schedule();
+                    }
+                }
+
+                TRACE_IRQ_EXIT(TRACE_IRQ_TIMER);
                 break;
+            }
             
             case 11: // Machine External Interrupt (PLIC)
                 {
@@ -161,6 +186,8 @@ void trap_handler(unsigned int mcause, unsigned int mepc, uint32_t *ctx) {
             uint32_t syscall_num = ctx[16]; // a7: ID da Syscall
             uint32_t arg0        = ctx[9];  // a0: Primeiro argumento
 
+            TRACE_SYSCALL_ENTER(syscall_num);
+
             switch (syscall_num) {
                 case SYS_YIELD:
                     // Tarefa diz: "Pode passar minha vez"
@@ -178,32 +205,20 @@ void trap_handler(unsigned int mcause, unsigned int mepc, uint32_t *ctx) {
                     break;
 
                 case SYS_LOCK: {
-                        // O argumento a0 é o ponteiro para o mutex
+                        // O argumento a0 é o ponteiro para o mutex.
+                        // Retorna 1 (pegou) ou 0 (alguém já trancou) em a0
                         mutex_t *m = (mutex_t *)arg0;
-                        
-                        // Lógica Atômica (Kernel Mode):
-                        if (m->locked == 0) {
-                            // Sucesso! A porta estava aberta.
-                            m->locked = 1;
-                            m->owner_tid = current_task->tid;
-                            ctx[9] = 1; // Retorna 1 em a0 (ctx[9])
-                        } else {
-                            // Falha! Alguém já trancou.
-                            ctx[9] = 0; // Retorna 0 em a0
-                        }
+                        ctx[9] = scheduler_mutex_lock(m);
+
+                        // Trace: início/fim da espera por este mutex
+                        TRACE_MUTEX(m, ctx[9]);
                     }
                     break;
 
-                case SYS_UNLOCK: {
-                        mutex_t *m = (mutex_t *)arg0;
-                        // Segurança: Só o dono pode destrancar!
-                        if (m->locked && m->owner_tid == current_task->tid) {
-                            m->locked = 0;
-                            m->owner_tid = 0;
-                            // Assim que destrancamos, outra tarefa pode tentar pegar.
-                            // O scheduler vai decidir quem roda a seguir.
-                        }
-                    }
+                case SYS_UNLOCK:
+                    // Assim que destrancamos, outra tarefa pode tentar pegar.
+                    // O scheduler vai decidir quem roda a seguir.
+                    scheduler_mutex_unlock((mutex_t *)arg0);
                     break;
 
                 case SYS_GET_TASKS: {
@@ -234,8 +249,32 @@ void trap_handler(unsigned int mcause, unsigned int mepc, uint32_t *ctx) {
                     break;
 
                 case SYS_MALLOC:
-                    // Chama kmalloc e retorna o endereço seguro em a0
-                    frame->a0 = (uint32_t)kmalloc(frame->a0);
+                    // Aloca em nome da tarefa atual (contabilizado na quota dela)
+                    frame->a0 = (uint32_t)kmalloc_task(frame->a0, current_task->tid);
+                    break;
+
+                case SYS_REALLOC:
+                    // a0: ptr, a1: novo tamanho. Retorna o novo endereço em a0
+                    frame->a0 = (uint32_t)krealloc_task((void*)frame->a0, frame->a1, current_task->tid);
+                    break;
+
+                case SYS_BOOTLOG:
+                    // a0 = buffer, a1 = max_count. Retorna a quantidade em a0
+                    frame->a0 = bootlog_get((bootlog_entry_t *)frame->a0, (int)frame->a1);
+                    break;
+
+                case SYS_TRACE:
+                    // a0: op, a1: arg, a2: buffer, a3: max
+#ifdef CONFIG_TRACE
+                    frame->a0 = trace_ctl(frame->a0, frame->a1, (trace_record_t *)frame->a2, frame->a3);
+#else
+                    frame->a0 = -1; // Kernel sem trace (make TRACE=1)
+#endif
+                    break;
+
+                case SYS_PROF:
+                    // a0: op, a1: arg, a2: buffer, a3: max
+                    frame->a0 = prof_ctl(frame->a0, frame->a1, (prof_entry_t *)frame->a2, frame->a3);
                     break;
 
                 case SYS_FREE:
@@ -254,6 +293,21 @@ void trap_handler(unsigned int mcause, unsigned int mepc, uint32_t *ctx) {
                     frame->a0 = scheduler_resume(frame->a0);
                     break;
 
+                case SYS_KILL:
+                    extern int scheduler_kill(uint32_t pid);
+                    frame->a0 = scheduler_kill(frame->a0);
+                    break;
+
+                case SYS_HEAP_QUOTA:
+                    // a0: pid, a1: bytes
+                    if (frame->a0 < MAX_TASKS) {
+                        kheap_set_quota(frame->a0, frame->a1);
+                        frame->a0 = 0;
+                    } else {
+                        frame->a0 = -1;
+                    }
+                    break;
+
                 case SYS_DEFRAG:
                     extern void kheap_defrag(void);
                     kheap_defrag(); 
@@ -278,12 +332,6 @@ void trap_handler(unsigned int mcause, unsigned int mepc, uint32_t *ctx) {
                     ctx[9] = fs_read((const char*)arg0, (uint8_t*)ctx[10], (uint32_t)ctx[11]);
                     break;
 
-                case SYS_FS_LIST:
-                    // a0: buffer, a1: max_len
-                    extern int fs_list(char *buffer, uint32_t max_len);
-                    ctx[9] = fs_list((char*)arg0, (uint32_t)ctx[10]);
-                    break;
-
                 case SYS_FS_DELETE:
                     // a0: nome
                     extern int fs_delete(const char *name);
@@ -295,6 +343,70 @@ void trap_handler(unsigned int mcause, unsigned int mepc, uint32_t *ctx) {
                     fs_format();
                     ctx[9] = 0; // Retorna 0 (sucesso)
                     break;
+
+                case SYS_FS_STATFS:
+                    // a0: fs_statfs_t*
+                    ctx[9] = fs_statfs((fs_statfs_t*)arg0);
+                    break;
+
+                case SYS_FS_OPEN:
+                    // a0: nome, a1: flags (FS_O_*)
+                    ctx[9] = fs_open((const char*)arg0, (uint32_t)ctx[10]);
+                    break;
+
+                case SYS_FS_CLOSE:
+                    // a0: fd
+                    ctx[9] = fs_close((int)arg0);
+                    break;
+
+                case SYS_FS_FREAD:
+                    // a0: fd, a1: buffer, a2: len
+                    ctx[9] = fs_fread((int)arg0, (uint8_t*)ctx[10], (uint32_t)ctx[11]);
+                    break;
+
+                case SYS_FS_FWRITE:
+                    // a0: fd, a1: dados, a2: len
+                    ctx[9] = fs_fwrite((int)arg0, (const uint8_t*)ctx[10], (uint32_t)ctx[11]);
+                    break;
+
+                case SYS_FS_LSEEK:
+                    // a0: fd, a1: offset, a2: whence (FS_SEEK_*)
+                    ctx[9] = fs_lseek((int)arg0, (int32_t)ctx[10], (int)ctx[11]);
+                    break;
+
+                case SYS_FS_MAP:
+                    // a0: nome, a1: const uint8_t** (ponteiro), a2: uint32_t* (tamanho)
+                    ctx[9] = fs_map((const char*)arg0, (const uint8_t**)ctx[10], (uint32_t*)ctx[11]);
+                    break;
+
+                case SYS_FS_UNMAP:
+                    // a0: ponteiro devolvido pelo SYS_FS_MAP
+                    ctx[9] = fs_unmap((const uint8_t*)arg0);
+                    break;
+
+                case SYS_FS_SYNC:
+                    ctx[9] = fs_sync();
+                    break;
+
+                case SYS_FS_MKDIR:
+                    // a0: caminho
+                    ctx[9] = fs_mkdir((const char*)arg0);
+                    break;
+
+                case SYS_FS_RMDIR:
+                    // a0: caminho
+                    ctx[9] = fs_rmdir((const char*)arg0);
+                    break;
+
+                case SYS_FS_OPENDIR:
+                    // a0: caminho (NULL = Root)
+                    ctx[9] = fs_opendir((const char*)arg0);
+                    break;
+
+                case SYS_FS_READDIR:
+                    // a0: fd, a1: fs_dirent_t*, a2: máximo de registros
+                    ctx[9] = fs_readdir((int)arg0, (fs_dirent_t*)ctx[10], (uint32_t)ctx[11]);
+                    break;
                     
                 default:
                     hal_uart_puts("[KERNEL] Syscall desconhecida.\n\r");
@@ -308,6 +420,8 @@ void trap_handler(unsigned int mcause, unsigned int mepc, uint32_t *ctx) {
             // ctx[31] mapeia para o campo 'mepc' na struct context_t.
             ctx[31] += 4;
 
+            TRACE_SYSCALL_EXIT(syscall_num);
+
         } else {
 
             // Se chegamos aqui, foi um erro grave (Crash, Instrução Ilegal, etc)
@@ -331,20 +445,26 @@ void trap_handler(unsigned int mcause, unsigned int mepc, uint32_t *ctx) {
 }
 
 // ======================================================================================
-//  BOOTSTRAP DO SISTEMA (MAIN)
+//  BOOT: BANNER E LOGS
+// ======================================================================================
+//
+//  Cada caractere na UART é enviado por polling, então o texto do boot custa
+//  caro (o banner sozinho tem ~1.5KB). Com -DFAST_BOOT (make FAST_BOOT=1):
+//    - o banner e o relatório de memória não são impressos (o shell mostra
+//      um cabeçalho curto ao iniciar);
+//    - as mensagens [ INFO ] do boot são suprimidas;
+//  Os tempos de cada fase continuam disponíveis no comando 'bootlog'.
+//
 // ======================================================================================
 
-void kernel_main() {
-
-    // ----------------------------------------------------------------------------------
-    // FASE 1: Inicialização de Hardware (Drivers)
-    // ----------------------------------------------------------------------------------
-    
-    hal_uart_init();                           // Inicializa UART
-    hal_uart_puts("\033[2J\033[3;r\033[3;1H"); // Configura terminal
-    hal_uart_puts("\033[2J\033[H\033[2;0H");   // Limpar tela
+#ifdef FAST_BOOT
+#define boot_info(msg)  ((void)0)
+#else
+#define boot_info(msg)  log_info(msg)
+#endif
 
-    // Mensagem com ASCII ART BANNER
+// Mensagem com ASCII ART BANNER
+static void print_banner(void) {
     hal_uart_puts(ANSI_CYAN ANSI_BOLD);
     hal_uart_puts("\n\r");
     hal_uart_puts("   █████╗ ██╗  ██╗ ██████╗ ███╗   ██╗       ██████╗ ███████╗\n\r");
@@ -356,16 +476,17 @@ void kernel_main() {
     hal_uart_puts("\n\r");
     hal_uart_puts(ANSI_RESET);
     hal_uart_puts("     :: AXON RTOS :: (v0.1.0-alpha) \n\r");
+#ifdef __riscv_mul
+    hal_uart_puts("     :: Build: RISC-V 32-bit (RV32IM_Zicsr) \n\r");
+#else
     hal_uart_puts("     :: Build: RISC-V 32-bit (RV32I_Zicsr) \n\r");
+#endif
     hal_uart_puts("\n\r");
+}
 
-    // Mensagem de aviso da inicilização do processo de boot
-    log_info("Boot sequence initiated...");
-    
-    // Diagnóstico de Memória
-    uint32_t kernel_start = (uint32_t)_start;
-    uint32_t kernel_end   = (uint32_t)_end;
-    uint32_t kernel_size  = kernel_end - kernel_start;
+// Diagnóstico de Memória
+static void print_kernel_usage(uint32_t kernel_start, uint32_t kernel_end) {
+    uint32_t kernel_size = kernel_end - kernel_start;
 
     hal_uart_puts(ANSI_CYAN "[ MEM   ] Kernel Memory Usage:\n\r");
     hal_uart_puts("\n  > Start: "); print_hex(kernel_start); hal_uart_puts("\n\r");
@@ -375,8 +496,43 @@ void kernel_main() {
     hal_uart_puts(" bytes (");
     print_dec(kernel_size / 1024);
     hal_uart_puts(" KB)\n\n\r" ANSI_RESET);
+}
+
+// ======================================================================================
+//  BOOTSTRAP DO SISTEMA (MAIN)
+// ======================================================================================
+
+void kernel_main() {
+
+    // Início do boot (referência para o comando 'bootlog')
+    boot_mark("entry");
 
-    // Inicialização da HEAP
+    // ----------------------------------------------------------------------------------
+    // FASE 1: Inicialização de Hardware (Drivers)
+    // ----------------------------------------------------------------------------------
+    
+    hal_uart_init();                           // Inicializa UART
+    hal_uart_puts("\033[2J\033[3;r\033[3;1H"); // Configura terminal
+    hal_uart_puts("\033[2J\033[H\033[2;0H");   // Limpar tela
+    boot_mark("uart");
+
+#ifndef FAST_BOOT
+    print_banner();
+    boot_mark("banner");
+#endif
+
+    // Mensagem de aviso da inicilização do processo de boot
+    boot_info("Boot sequence initiated...");
+    
+    uint32_t kernel_start = (uint32_t)_start;
+    uint32_t kernel_end   = (uint32_t)_end;
+    uint32_t kernel_size  = kernel_end - kernel_start;
+
+#ifndef FAST_BOOT
+    print_kernel_usage(kernel_start, kernel_end);
+#endif
+
+    // Inicialização da HEAP (uma única vez: RamFS e tarefas alocam daqui)
 
     // Definição do tamanho da RAM Total 
     uint32_t ram_total = HEAP_SIZE * 1024;
@@ -385,64 +541,84 @@ void kernel_main() {
     // Reservamos 4KB (4096) no final da RAM para a Pilha de Boot (Stack de segurança)
     uint32_t heap_size = ram_total - kernel_size - 4096;
 
-    hal_uart_puts(ANSI_CYAN "[ MEM   ] Initializing Heap Manager...\n\n\r");
     kmalloc_init((void*)_end, heap_size);
-    
-    // Verifica quanto sobrou
-    uint32_t free_ram = kget_free_memory();
+
+    // Pool de DMA: região separada no linker script (buffers da NPU/DMA)
+    kmalloc_dma_init((void*)_dma_start, (uint32_t)_dma_end - (uint32_t)_dma_start);
+
+#ifndef FAST_BOOT
+    hal_uart_puts(ANSI_CYAN "[ MEM   ] Initializing Heap Manager...\n\n\r");
     hal_uart_puts("  > Available Heap: "); 
-    print_dec(free_ram); 
+    print_dec(kget_free_memory()); 
+    hal_uart_puts(" bytes.\n\r" ANSI_RESET);
+    hal_uart_puts(ANSI_CYAN "  > DMA Pool:       ");
+    print_dec(kget_free_dma_memory());
     hal_uart_puts(" bytes.\n\r" ANSI_RESET);
     hal_uart_putc('\n');
+#endif
+    boot_mark("heap");
 
     // Inicialização do Sistema de Arquivos
-
-    kmalloc_init((void*)_end, heap_size);
-
-    log_info("Initializing RamFS...");
+    boot_info("Initializing RamFS...");
     fs_init();
+    boot_mark("fs");
 
     // ----------------------------------------------------------------------------------
     // FASE 2: Configuração de Interrupções
     // ----------------------------------------------------------------------------------
     
-    log_info("Configuring Trap Vector Table...");
+    boot_info("Configuring Trap Vector Table...");
     
     // Diz à CPU para pular para 'trap_entry' (no assembly) quando algo acontecer
     hal_irq_set_handler(trap_entry);
     
     // Configura e ativa o Timer do sistema
-    log_info("Starting System Timer...");
+    boot_info("Starting System Timer...");
     hal_timer_set_irq_delta(TICK_DELTA_CYCLES);
     hal_irq_mask_enable(IRQ_M_TIMER);
     
     // Libera as interrupções globais (MIE bit)
     hal_irq_global_enable();
+#ifndef FAST_BOOT
     log_ok("Interrupts Enabled.");
+#endif
 
     // Inicializa interrupções de plataforma (PLIC)
     hal_irq_init();  
 
     // Inicializa MUTEXES
     apps_init();
+    boot_mark("irq");
 
     // ----------------------------------------------------------------------------------
     // FASE 3: Criação de Processos
     // ----------------------------------------------------------------------------------
 
-    log_info("Initializing Process Scheduler...");
+    boot_info("Initializing Process Scheduler...");
     scheduler_init();
     
     // Cria as tarefas do usuário (Pilha, Contexto, TCB)
+#ifndef CONFIG_BENCH
+    // Fora da imagem de benchmark: o spinner/uptime sujaria a saída e
+    // roubaria CPU das medições
     task_create(task_leds, "Task LEDs", 1);
     task_create(task_monitor, "Task Monitor", 1);
+#endif
     task_create(task_shell, "Task Shell", 2);
+    // Logger na prioridade 1 (dorme entre esvaziamentos): a 0 é só da Idle,
+    // que stop/kill recusam e o escalonador usa quando ninguém mais roda
+    task_create(task_logger, "Task Logger", 1);
     
     // Cria a tarefa de background (obrigatória para o scheduler não falhar)
     task_create(task_idle, "Idle", 0);
+    boot_mark("tasks");
     
     hal_uart_putc('\n');
     hal_uart_puts(ANSI_GREEN ">>> AXON KERNEL IS READY <<<\n\r" ANSI_RESET);
+
+    hal_uart_puts("     Boot time: ");
+    print_dec((uint32_t)bootlog_elapsed() / (hal_timer_get_freq() / 1000000));
+    hal_uart_puts(" us\n\r");
     
     // ----------------------------------------------------------------------------------
     // FASE 4: Agendamento das Tarefas
@@ -458,4 +634,4 @@ void kernel_main() {
     // Código inalcançável (Failsafe)
     while (1) asm volatile("nop");
 
-}
\ No newline at end of file
+}
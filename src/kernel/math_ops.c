@@ -1,48 +1,125 @@
 #include "../include/util/math_ops.h"
 #include <stdint.h>
 
-/* * Software para Operações Matemáticas (RV32I) */
+/* * Software para Operações Matemáticas (RV32I) 
+ *
+ * Substituto da libgcc (não linkamos a libgcc). Estratégia geral:
+ *  - Multiplicação: laço sobre o MENOR operando (troca se preciso) e termina
+ *    assim que acabam os bits dele; 2 bits por iteração.
+ *  - Divisão: alinha o divisor ao dividendo pelo clz e só executa os passos
+ *    que podem gerar bit de quociente (ex.: 1000/7 = 8 passos, não 32).
+ *  - Potências de 2 viram shift/máscara.
+ *
+ * Cuidado: aqui dentro não se pode usar '*', '/' ou '%' em inteiros, senão
+ * o compilador chama estas mesmas funções (recursão infinita).
+ *
+ * Só entra no build RV32I: com ISA=rv32im o makefile exclui este arquivo
+ * (o compilador emite mul/div direto). A divisão de 64 bits, que nem o M
+ * tem em hardware, fica em math_ops64.c e é usada pelos dois builds.
+ */
 
-// --- Multiplicação (Signed 32-bit) ---
-// Usada pelo compilador para operador '*'
-int32_t __mulsi3(int32_t a, int32_t b) {
-    int32_t res = 0;
+// ============================================================================
+// MULTIPLICAÇÃO
+// ============================================================================
+
+// Núcleo 32x32 -> 32 (módulo 2^32, serve para signed e unsigned)
+static uint32_t umul32(uint32_t a, uint32_t b) {
+    // O laço roda sobre 'b': garante que ele seja o menor
+    if (a < b) { uint32_t t = a; a = b; b = t; }
+    if (b == 0) return 0;
+    if (math_is_pow2(b)) return a << math_ctz32(b);
+
+    uint32_t res = 0;
     while (b != 0) {
         if (b & 1) res += a;
-        a <<= 1;
-        b = (uint32_t)b >> 1; 
+        if (b & 2) res += a << 1;
+        a <<= 2;
+        b >>= 2;
     }
     return res;
 }
 
-// --- Divisão (Unsigned 32-bit) ---
-// Auxiliar para as funções abaixo
-uint32_t __udivsi3(uint32_t n, uint32_t d) {
+// Núcleo 32x32 -> 64 (produto completo, usado pelo __muldi3)
+static uint64_t umul32x64(uint32_t a, uint32_t b) {
+    if (a < b) { uint32_t t = a; a = b; b = t; }
+    if (b == 0) return 0;
+
+    uint32_t lo = 0, hi = 0;
+    uint32_t a_lo = a, a_hi = 0; // 'a' deslocado, em 64 bits (2 palavras)
+    while (b != 0) {
+        if (b & 1) {
+            uint32_t s = lo + a_lo;
+            hi += a_hi + (s < lo); // Carry
+            lo = s;
+        }
+        a_hi = (a_hi << 1) | (a_lo >> 31);
+        a_lo <<= 1;
+        b >>= 1;
+    }
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// --- Multiplicação (Signed 32-bit) ---
+// Usada pelo compilador para operador '*'
+int32_t __mulsi3(int32_t a, int32_t b) {
+    return (int32_t)umul32((uint32_t)a, (uint32_t)b);
+}
+
+// Multiplicação 64-bit 
+// (a_hi:a_lo) * (b_hi:b_lo) mod 2^64 = a_lo*b_lo + ((a_hi*b_lo + a_lo*b_hi) << 32)
+int64_t __muldi3(int64_t a, int64_t b) {
+    uint64_t ua = (uint64_t)a;
+    uint64_t ub = (uint64_t)b;
+    uint32_t a_lo = (uint32_t)ua, a_hi = (uint32_t)(ua >> 32);
+    uint32_t b_lo = (uint32_t)ub, b_hi = (uint32_t)(ub >> 32);
+
+    uint64_t res = umul32x64(a_lo, b_lo);
+    uint32_t cross = umul32(a_hi, b_lo) + umul32(a_lo, b_hi);
+    res += (uint64_t)cross << 32;
+    return (int64_t)res;
+}
+
+// ============================================================================
+// DIVISÃO 32 BITS
+// ============================================================================
+
+// Núcleo: quociente e resto de uma vez
+static uint32_t udivmod32(uint32_t n, uint32_t d, uint32_t *rem) {
+    // Divisão por zero: mesmo resultado da instrução DIVU do RISC-V
+    if (d == 0) { *rem = n; return 0xFFFFFFFFu; }
+    if (n < d)  { *rem = n; return 0; }
+    if (math_is_pow2(d)) {
+        *rem = n & (d - 1);
+        return n >> math_ctz32(d);
+    }
+
+    // Alinha o bit mais alto do divisor com o do dividendo
+    uint32_t shift = math_clz32(d) - math_clz32(n);
+    d <<= shift;
+
     uint32_t q = 0;
-    uint32_t r = 0;
-    // Algoritmo de divisão binária "restoring" simples
-    for (int i = 31; i >= 0; i--) {
-        r <<= 1;
-        r |= (n >> i) & 1;
-        if (r >= d) {
-            r -= d;
-            q |= (1U << i);
+    for (uint32_t i = 0; i <= shift; i++) {
+        q <<= 1;
+        if (n >= d) {
+            n -= d;
+            q |= 1;
         }
+        d >>= 1;
     }
+    *rem = n;
     return q;
 }
 
+// --- Divisão (Unsigned 32-bit) ---
+uint32_t __udivsi3(uint32_t n, uint32_t d) {
+    uint32_t r;
+    return udivmod32(n, d, &r);
+}
+
 // --- Resto (Unsigned 32-bit) ---
-// Auxiliar
 uint32_t __umodsi3(uint32_t n, uint32_t d) {
-    uint32_t r = 0;
-    for (int i = 31; i >= 0; i--) {
-        r <<= 1;
-        r |= (n >> i) & 1;
-        if (r >= d) {
-            r -= d;
-        }
-    }
+    uint32_t r;
+    udivmod32(n, d, &r);
     return r;
 }
 
@@ -50,33 +127,21 @@ uint32_t __umodsi3(uint32_t n, uint32_t d) {
 // Usada pelo compilador para operador '/'
 int32_t __divsi3(int32_t a, int32_t b) {
     int neg = 0;
-    if (a < 0) { a = -a; neg = !neg; }
-    if (b < 0) { b = -b; neg = !neg; }
-    int32_t res = __udivsi3(a, b);
-    return neg ? -res : res;
+    // Negação em unsigned: INT32_MIN não estoura
+    uint32_t ua = (uint32_t)a, ub = (uint32_t)b;
+    if (a < 0) { ua = 0u - ua; neg = !neg; }
+    if (b < 0) { ub = 0u - ub; neg = !neg; }
+    uint32_t res = __udivsi3(ua, ub);
+    return (int32_t)(neg ? 0u - res : res);
 }
 
 // --- Resto (Signed 32-bit) ---
-// Usada pelo compilador para operador '%'
+// Usada pelo compilador para operador '%' (sinal do resto = sinal de 'a')
 int32_t __modsi3(int32_t a, int32_t b) {
     int neg = 0;
-    if (a < 0) { a = -a; neg = 1; }
-    if (b < 0) { b = -b; }
-    int32_t res = __umodsi3(a, b);
-    return neg ? -res : res;
+    uint32_t ua = (uint32_t)a, ub = (uint32_t)b;
+    if (a < 0) { ua = 0u - ua; neg = 1; }
+    if (b < 0) { ub = 0u - ub; }
+    uint32_t res = __umodsi3(ua, ub);
+    return (int32_t)(neg ? 0u - res : res);
 }
-
-// Multiplicação 64-bit 
-int64_t __muldi3(int64_t a, int64_t b) {
-    uint64_t ua = (uint64_t)a;
-    uint64_t ub = (uint64_t)b;
-    uint64_t res = 0;
-
-    // Mesma lógica do 32-bit, mas com registradores de 64-bit
-    while (ub != 0) {
-        if (ub & 1) res += ua;
-        ua <<= 1;
-        ub >>= 1;
-    }
-    return (int64_t)res;
-}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "../include/util/math_ops.h"
+#include <stdint.h>
+
+/* * Divisão de 64 bits em Software
+ *
+ * Nem o RV32I nem o RV32IM têm divisão de 64 bits em hardware, então estas
+ * rotinas entram nos dois builds (o resto do runtime está em math_ops.c).
+ * Mesmo esquema do divisor de 32 bits: alinha pelo clz e só executa os
+ * passos que podem gerar bit de quociente.
+ *
+ * Cuidado: aqui dentro não se pode usar '/' ou '%' em 64 bits.
+ */
+
+// ============================================================================
+// DIVISÃO 64 BITS
+// ============================================================================
+
+// Zeros à esquerda em 64 bits
+static uint32_t clz64(uint64_t x) {
+    uint32_t hi = (uint32_t)(x >> 32);
+    if (hi) return math_clz32(hi);
+    return 32 + math_clz32((uint32_t)x);
+}
+
+static uint64_t udivmod64(uint64_t n, uint64_t d, uint64_t *rem) {
+    if (d == 0) { *rem = n; return 0xFFFFFFFFFFFFFFFFull; }
+    if (n < d)  { *rem = n; return 0; }
+
+    // Tudo cabe em 32 bits: divisão de 32 bits (DIVU no RV32IM,
+    // __udivsi3 no RV32I)
+    if ((n >> 32) == 0) {
+        *rem = (uint32_t)n % (uint32_t)d;
+        return (uint32_t)n / (uint32_t)d;
+    }
+
+    // Divisor potência de 2
+    if ((d & (d - 1)) == 0) {
+        *rem = n & (d - 1);
+        return n >> (63 - clz64(d));
+    }
+
+    uint32_t shift = clz64(d) - clz64(n);
+    d <<= shift;
+
+    uint64_t q = 0;
+    for (uint32_t i = 0; i <= shift; i++) {
+        q <<= 1;
+        if (n >= d) {
+            n -= d;
+            q |= 1;
+        }
+        d >>= 1;
+    }
+    *rem = n;
+    return q;
+}
+
+uint64_t __udivdi3(uint64_t n, uint64_t d) {
+    uint64_t r;
+    return udivmod64(n, d, &r);
+}
+
+uint64_t __umoddi3(uint64_t n, uint64_t d) {
+    uint64_t r;
+    udivmod64(n, d, &r);
+    return r;
+}
+
+int64_t __divdi3(int64_t a, int64_t b) {
+    int neg = 0;
+    uint64_t ua = (uint64_t)a, ub = (uint64_t)b;
+    if (a < 0) { ua = 0ull - ua; neg = !neg; }
+    if (b < 0) { ub = 0ull - ub; neg = !neg; }
+    uint64_t res = __udivdi3(ua, ub);
+    return (int64_t)(neg ? 0ull - res : res);
+}
+
+int64_t __moddi3(int64_t a, int64_t b) {
+    int neg = 0;
+    uint64_t ua = (uint64_t)a, ub = (uint64_t)b;
+    if (a < 0) { ua = 0ull - ua; neg = 1; }
+    if (b < 0) { ub = 0ull - ub; }
+    uint64_t res = __umoddi3(ua, ub);
+    return (int64_t)(neg ? 0ull - res : res);
+}
@@ -1,12 +1,16 @@
 #include "../../include/kernel/mm.h"
+#include "../../include/kernel/task.h"
 #include "../../include/hal/hal_uart.h"
+#include "../../include/kernel/klog.h"
+#include "../../include/util/string.h"
 
 // Cabeçalho de cada bloco de memória
 // Cada alocação terá este "ticket" escondido antes dos dados.
 typedef struct block_meta {
     size_t size;             // Tamanho do dado (sem contar este header)
     struct block_meta *next; // Próximo bloco na lista
-    int free;                // 1 = Livre, 0 = Ocupado
+    uint16_t free;           // 1 = Livre, 0 = Ocupado
+    uint16_t owner;          // TID dono do bloco (MM_OWNER_KERNEL = Kernel)
     uint32_t canary;         // Para detecção de corrupção
 } block_t;
 
@@ -14,6 +18,17 @@ typedef struct block_meta {
 #define BLOCK_SIZE  sizeof(block_t)
 #define CANRY_VALUE 0xCAFEBABE
 
+// Sobra mínima (além do header) para valer a pena dividir um bloco
+#define SPLIT_MARGIN 8
+
+// Uma região gerenciada (lista encadeada de blocos em ordem de endereço)
+// Temos duas: o Heap principal e o Pool de DMA (região separada no linker).
+typedef struct {
+    void    *start;
+    void    *end;
+    block_t *head;
+} heap_t;
+
 static void debug_hex(uint32_t val) {
     char buf[12];
     const char hex[] = "0123456789ABCDEF";
@@ -23,12 +38,17 @@ static void debug_hex(uint32_t val) {
     hal_uart_puts(buf);
 }
 
-static void *heap_start = NULL;
-static void *heap_end   = NULL;
-static block_t *heap_head = NULL;
+static heap_t kheap    = { NULL, NULL, NULL }; // Heap principal (kmalloc)
+static heap_t dma_heap = { NULL, NULL, NULL }; // Pool de DMA (kmalloc_dma)
 
-// Inicializa o gerenciador
-void kmalloc_init(void* start_addr, uint32_t size) {
+// Contabilidade por tarefa (indexado pelo TID)
+// usage: bytes de dados atualmente alocados pela tarefa
+// quota: limite em bytes (MM_QUOTA_UNLIMITED = sem limite)
+static uint32_t task_usage[MAX_TASKS];
+static uint32_t task_quota[MAX_TASKS];
+
+// Prepara uma região como um único bloco livre
+static void heap_init(heap_t *h, void* start_addr, uint32_t size) {
     // Alinha o endereço inicial em 4 bytes (Word Align)
     uint32_t addr = (uint32_t)start_addr;
     if (addr & 3) {
@@ -37,74 +57,174 @@ void kmalloc_init(void* start_addr, uint32_t size) {
         size -= padding;
     }
 
-    heap_start = (void*)addr;
-    heap_end   = (void*)(addr + size);
+    h->start = (void*)addr;
+    h->end   = (void*)(addr + size);
     
     // Cria o "Bloco Gênesis": Um único bloco gigante livre
-    heap_head = (block_t*)heap_start;
-    heap_head->size = size - BLOCK_SIZE;
-    heap_head->next = NULL;
-    heap_head->free = 1;
-    heap_head->canary = CANRY_VALUE;
+    h->head = (block_t*)h->start;
+    h->head->size = size - BLOCK_SIZE;
+    h->head->next = NULL;
+    h->head->free = 1;
+    h->head->owner = MM_OWNER_KERNEL;
+    h->head->canary = CANRY_VALUE;
+}
+
+// Inicializa o gerenciador
+void kmalloc_init(void* start_addr, uint32_t size) {
+    heap_init(&kheap, start_addr, size);
+
+    // Zera a contabilidade (quotas configuradas são mantidas)
+    for (int i = 0; i < MAX_TASKS; i++) task_usage[i] = 0;
 
 }
 
-// Aloca memória
-void* kmalloc(uint32_t size) {
-    block_t *curr = heap_head;
+// Inicializa o Pool de DMA (região dedicada definida no linker script)
+void kmalloc_dma_init(void* start_addr, uint32_t size) {
+    heap_init(&dma_heap, start_addr, size);
+}
+
+// Aloca 'size' bytes cuja área de dados começa num múltiplo de 'align'
+// (potência de 2, >= 4) e marca o bloco com o dono 'owner'.
+static void* heap_alloc(heap_t *h, uint32_t size, uint32_t align, uint16_t owner) {
+    block_t *curr = h->head;
+    int over_quota = 0; // Algum bloco servia, mas a tarefa não podia pagar
     
     // Alinha o tamanho solicitado em 4 bytes (segurança para RISC-V)
     if (size & 3) size += 4 - (size & 3);
 
     while (curr) {
 
+#ifdef MM_TRACE
+        // Rastreio da busca (caro: UART por polling a cada bloco visitado)
         hal_uart_puts("Inspecting Block at: "); debug_hex((uint32_t)curr);
         hal_uart_puts(" Size: "); debug_hex(curr->size);
         hal_uart_puts(" Free: "); debug_hex(curr->free);
         hal_uart_puts("\n\r");
+#endif
 
-        // Procura um bloco livre que caiba o dado
-        if (curr->free && curr->size >= size) {
+        if (curr->free) {
+
+            // Quanto precisamos pular para alinhar a área de dados?
+            // Se a sobra à esquerda não comporta um bloco livre próprio,
+            // avançamos para o próximo endereço alinhado.
+            uint32_t data = (uint32_t)curr + BLOCK_SIZE;
+            uint32_t gap  = ((data + align - 1) & ~(align - 1)) - data;
+            while (gap != 0 && gap < BLOCK_SIZE + SPLIT_MARGIN) gap += align;
+
+            // Procura um bloco livre que caiba o dado (já descontado o alinhamento)
+            // e que a tarefa dona possa pagar: sem SPLIT ela paga o bloco
+            // inteiro, não só o pedido
+            uint32_t charge = curr->size - gap;
+            if (charge > size + BLOCK_SIZE + SPLIT_MARGIN) charge = size;
+            if (curr->size >= gap + size && owner < MAX_TASKS &&
+                task_quota[owner] != MM_QUOTA_UNLIMITED &&
+                task_usage[owner] + charge > task_quota[owner]) {
+                over_quota = 1;
+                curr = curr->next; // Estouraria a quota: tenta um bloco que divida
+                continue;
+            }
+
+            if (curr->size >= gap + size) {
+
+                // SPLIT À ESQUERDA: A sobra vira um bloco livre e o novo
+                // cabeçalho fica imediatamente antes do endereço alinhado.
+                if (gap) {
+                    block_t *aligned_block = (block_t*)((uint8_t*)curr + gap);
+
+                    aligned_block->size = curr->size - gap;
+                    aligned_block->next = curr->next;
+                    aligned_block->free = 1;
+                    aligned_block->owner = MM_OWNER_KERNEL;
+                    aligned_block->canary = CANRY_VALUE;
+
+                    curr->size = gap - BLOCK_SIZE;
+                    curr->next = aligned_block;
+                    curr = aligned_block;
+                }
             
-            // SPLIT: Se o bloco for muito maior que o necessário, divide em dois
-            if (curr->size > (size + BLOCK_SIZE + 8)) { // +8 de margem
-                block_t *new_block = (block_t*)((uint8_t*)curr + BLOCK_SIZE + size);
+                // SPLIT: Se o bloco for muito maior que o necessário, divide em dois
+                if (curr->size > (size + BLOCK_SIZE + SPLIT_MARGIN)) {
+                    block_t *new_block = (block_t*)((uint8_t*)curr + BLOCK_SIZE + size);
+                    
+                    new_block->size = curr->size - size - BLOCK_SIZE;
+                    new_block->next = curr->next;
+                    new_block->free = 1;
+                    new_block->owner = MM_OWNER_KERNEL;
+                    new_block->canary = CANRY_VALUE;
+                    
+                    curr->size = size;
+                    curr->next = new_block;
+                }
                 
-                new_block->size = curr->size - size - BLOCK_SIZE;
-                new_block->next = curr->next;
-                new_block->free = 1;
-                new_block->canary = CANRY_VALUE;
+                curr->free = 0; // Marca como ocupado
+                curr->owner = owner;
+
+                // Contabiliza o bloco na conta da tarefa dona
+                if (owner < MAX_TASKS) task_usage[owner] += curr->size;
                 
-                curr->size = size;
-                curr->next = new_block;
+                // Retorna o ponteiro para a ÁREA DE DADOS (pula o header)
+                return (void*)((uint8_t*)curr + BLOCK_SIZE);
             }
-            
-            curr->free = 0; // Marca como ocupado
-            
-            // Retorna o ponteiro para a ÁREA DE DADOS (pula o header)
-            return (void*)((uint8_t*)curr + BLOCK_SIZE);
         }
         curr = curr->next;
     }
-    
+
+    // A quota é conferida aqui, onde o valor cobrado de fato é conhecido
+    if (over_quota) KLOG_WARN(MM_QUOTA_EXCEEDED, owner, task_usage[owner], size);
     return NULL; // Out of Memory (OOM)
 }
 
-// Libera memória
-uint8_t kfree(void* ptr) {
-    if (!ptr) return -1;
+// Aloca memória do Kernel (sem dono e sem quota)
+void* kmalloc(uint32_t size) {
+    return heap_alloc(&kheap, size, 4, MM_OWNER_KERNEL);
+}
+
+// Aloca memória do Kernel com a área de dados alinhada em 'align' bytes
+void* kmalloc_aligned(uint32_t size, uint32_t align) {
+    // Alinhamento deve ser potência de 2 (mínimo: palavra)
+    if (align < 4) align = 4;
+    if (align & (align - 1)) return NULL;
+
+    return heap_alloc(&kheap, size, align, MM_OWNER_KERNEL);
+}
+
+// Aloca um buffer para DMA no Pool dedicado.
+// Início alinhado ao burst e tamanho arredondado para bursts inteiros:
+// nenhuma transferência divide um burst com outro buffer.
+void* kmalloc_dma(uint32_t size) {
+    if (!dma_heap.head || size == 0) return NULL;
+
+    size = (size + KMALLOC_DMA_ALIGN - 1) & ~(KMALLOC_DMA_ALIGN - 1);
+    return heap_alloc(&dma_heap, size, KMALLOC_DMA_ALIGN, MM_OWNER_KERNEL);
+}
+
+// Aloca memória em nome da tarefa 'tid', respeitando a quota dela
+// (conferida no heap_alloc)
+void* kmalloc_task(uint32_t size, uint32_t tid) {
+    if (tid >= MAX_TASKS) return NULL;
+    return heap_alloc(&kheap, size, 4, (uint16_t)tid);
+}
+
+// Valida um ponteiro devolvido por kmalloc* e recupera o cabeçalho.
+// Em 'heap_out' devolve a região (Heap ou Pool de DMA) dona do bloco.
+// Retorna NULL (e reporta o erro) se o ponteiro for inválido.
+static block_t* block_from_ptr(void* ptr, heap_t **heap_out) {
 
     // 1. Verificação de Limites (Safety Check)
-    // O ponteiro deve estar estritamente dentro da área do Heap
-    if (ptr < heap_start || ptr >= heap_end) {
-        hal_uart_puts("[MM] Error: Pointer out of heap bounds!\n\r");
-        return -1;
+    // O ponteiro deve estar estritamente dentro do Heap ou do Pool de DMA
+    if (ptr >= kheap.start && ptr < kheap.end) {
+        *heap_out = &kheap;
+    } else if (ptr >= dma_heap.start && ptr < dma_heap.end) {
+        *heap_out = &dma_heap;
+    } else {
+        KLOG_ERROR(MM_BAD_BOUNDS, ptr);
+        return NULL;
     }
 
     // 2. Verificação de Alinhamento
     if (((uint32_t)ptr & 3) != 0) {
-        hal_uart_puts("[MM] Error: Invalid pointer alignment!\n\r");
-        return -1;
+        KLOG_ERROR(MM_BAD_ALIGN, ptr);
+        return NULL;
     }
 
     // Recupera o cabeçalho
@@ -112,18 +232,177 @@ uint8_t kfree(void* ptr) {
 
     // 3. Verificação de Integridade (Magic Number)
     if (block->canary != CANRY_VALUE) {
-        hal_uart_puts("[MM] Error: Block corruption detected (Bad Canary)!\n\r");
-        return -1;
+        KLOG_ERROR(MM_BAD_CANARY, block);
+        return NULL;
     }
 
-    // Marca como livre
+    // 4. Verificação de Double Free / Use After Free
+    if (block->free) {
+        KLOG_ERROR(MM_DOUBLE_FREE, ptr);
+        return NULL;
+    }
+
+    return block;
+}
+
+// Libera memória
+uint8_t kfree(void* ptr) {
+    if (!ptr) return -1;
+
+    heap_t *h;
+    block_t *block = block_from_ptr(ptr, &h);
+    if (!block) return -1;
+
+    // Marca como livre e devolve o saldo para a tarefa dona
+    if (block->owner < MAX_TASKS) task_usage[block->owner] -= block->size;
     block->free = 1;
+    block->owner = MM_OWNER_KERNEL;
     return 0;
 }
 
+// ============================================================================
+// REALOCAÇÃO (KREALLOC)
+// ============================================================================
+
+// Devolve a cauda de um bloco (além de 'size' bytes) como um bloco livre,
+// já fundido com o vizinho da direita se ele também estiver livre.
+static void split_tail(block_t *block, uint32_t size) {
+    if (block->size <= size + BLOCK_SIZE + SPLIT_MARGIN) return;
+
+    block_t *tail = (block_t*)((uint8_t*)block + BLOCK_SIZE + size);
+    tail->size = block->size - size - BLOCK_SIZE;
+    tail->next = block->next;
+    tail->free = 1;
+    tail->owner = MM_OWNER_KERNEL;
+    tail->canary = CANRY_VALUE;
+
+    if (tail->next && tail->next->free) {
+        tail->size += tail->next->size + BLOCK_SIZE;
+        tail->next = tail->next->next;
+    }
+
+    block->size = size;
+    block->next = tail;
+}
+
+// Redimensiona o bloco 'ptr' para 'size' bytes, preservando o conteúdo.
+// 1. Encolher: divide o bloco no lugar (a sobra volta a ser livre).
+// 2. Crescer: absorve o vizinho físico da direita se ele estiver livre.
+// 3. Caso contrário: aloca um novo bloco, copia e libera o antigo.
+static void* heap_realloc(void* ptr, uint32_t size, uint16_t owner, int check_owner) {
+    heap_t *h;
+    block_t *block = block_from_ptr(ptr, &h);
+    if (!block) return NULL;
+
+    // Uma tarefa só pode redimensionar os próprios blocos
+    if (check_owner && block->owner != owner) {
+        KLOG_ERROR(MM_REALLOC_OWNER, owner, ptr, block->owner);
+        return NULL;
+    }
+    owner = block->owner;
+
+    // O Pool de DMA mantém sua granularidade de burst
+    uint32_t align = (h == &dma_heap) ? KMALLOC_DMA_ALIGN : 4;
+    size = (size + align - 1) & ~(align - 1);
+
+    uint32_t old_size = block->size;
+
+    // --- ENCOLHER (ou já cabe) ---
+    if (size <= old_size) {
+        split_tail(block, size);
+        if (owner < MAX_TASKS) task_usage[owner] -= old_size - block->size;
+        return ptr;
+    }
+
+    int limited = owner < MAX_TASKS && task_quota[owner] != MM_QUOTA_UNLIMITED;
+
+    // --- CRESCER NO LUGAR ---
+    // A lista está em ordem de endereço, mas conferimos a adjacência física.
+    // Quota: cobra o crescimento líquido, e o vizinho inteiro se a sobra
+    // dele não der para dividir (senão tenta mover para um bloco que divida).
+    block_t *next = block->next;
+    uint32_t joined = next ? old_size + BLOCK_SIZE + next->size : 0;
+    uint32_t charge = (joined > size + BLOCK_SIZE + SPLIT_MARGIN) ? size : joined;
+    if (next && next->free &&
+        (uint8_t*)next == (uint8_t*)block + BLOCK_SIZE + old_size &&
+        joined >= size &&
+        !(limited && task_usage[owner] + (charge - old_size) > task_quota[owner])) {
+
+        block->size = joined;
+        block->next = next->next;
+        split_tail(block, size);
+
+        if (owner < MAX_TASKS) task_usage[owner] += block->size - old_size;
+        return ptr;
+    }
+
+    // --- MOVER (Aloca, Copia, Libera) ---
+    // O bloco antigo sai da conta durante a busca: a quota do heap_alloc
+    // vê só o saldo líquido (o kfree abaixo o desconta de vez)
+    if (owner < MAX_TASKS) task_usage[owner] -= old_size;
+    void *new_ptr = heap_alloc(h, size, align, owner);
+    if (owner < MAX_TASKS) task_usage[owner] += old_size;
+    if (!new_ptr) return NULL;
+
+    // Blocos alinhados em 4: o memcpy vai direto para o laço de palavras
+    memcpy(new_ptr, ptr, old_size);
+    kfree(ptr);
+    return new_ptr;
+}
+
+// Realoca um bloco do Kernel (ptr NULL = kmalloc, size 0 = kfree)
+void* krealloc(void* ptr, uint32_t size) {
+    if (!ptr) return kmalloc(size);
+    if (size == 0) { kfree(ptr); return NULL; }
+    return heap_realloc(ptr, size, MM_OWNER_KERNEL, 0);
+}
+
+// Realoca um bloco em nome da tarefa 'tid' (SYS_REALLOC)
+void* krealloc_task(void* ptr, uint32_t size, uint32_t tid) {
+    if (tid >= MAX_TASKS) return NULL;
+    if (!ptr) return kmalloc_task(size, tid);
+    if (size == 0) { kfree(ptr); return NULL; }
+    return heap_realloc(ptr, size, (uint16_t)tid, 1);
+}
+
+// ============================================================================
+// CONTABILIDADE POR TAREFA (QUOTAS)
+// ============================================================================
+
+void kheap_set_quota(uint32_t tid, uint32_t bytes) {
+    if (tid < MAX_TASKS) task_quota[tid] = bytes;
+}
+
+uint32_t kheap_get_quota(uint32_t tid) {
+    return (tid < MAX_TASKS) ? task_quota[tid] : 0;
+}
+
+uint32_t kheap_task_usage(uint32_t tid) {
+    return (tid < MAX_TASKS) ? task_usage[tid] : 0;
+}
+
+// Libera todos os blocos da tarefa 'tid' (chamado quando a tarefa morre).
+// Retorna quantos bytes de dados foram recuperados.
+uint32_t kheap_reclaim(uint32_t tid) {
+    uint32_t reclaimed = 0;
+    block_t *curr = kheap.head;
+
+    while (curr) {
+        if (!curr->free && curr->owner == tid) {
+            reclaimed += curr->size;
+            curr->free = 1;
+            curr->owner = MM_OWNER_KERNEL;
+        }
+        curr = curr->next;
+    }
+
+    if (tid < MAX_TASKS) task_usage[tid] = 0;
+    return reclaimed;
+}
+
 // Algoritmo de Fusão de Blocos (Coalescing)
-void kheap_defrag(void) {
-    block_t *curr = heap_head;
+static int heap_defrag(heap_t *h) {
+    block_t *curr = h->head;
     int merged_count = 0;
 
     while (curr && curr->next) {
@@ -149,18 +428,22 @@ void kheap_defrag(void) {
             curr = curr->next;
         }
     }
+
+    return merged_count;
+}
+
+void kheap_defrag(void) {
+    int merged_count = heap_defrag(&kheap) + heap_defrag(&dma_heap);
     
     if (merged_count > 0) {
-        hal_uart_puts("[MM] Defrag: Merged ");
-        // print_dec(merged_count); // Se tiver print_dec disponível
-        hal_uart_puts(" blocks.\n\r");
+        KLOG_INFO(MM_DEFRAG, merged_count);
     }
 }
 
 // Diagnóstico
-uint32_t kget_free_memory(void) {
+static uint32_t heap_free_bytes(heap_t *h) {
     uint32_t total = 0;
-    block_t *curr = heap_head;
+    block_t *curr = h->head;
     while (curr) {
         if (curr->free) total += curr->size;
         curr = curr->next;
@@ -168,17 +451,25 @@ uint32_t kget_free_memory(void) {
     return total;
 }
 
+uint32_t kget_free_memory(void) {
+    return heap_free_bytes(&kheap);
+}
+
+uint32_t kget_free_dma_memory(void) {
+    return heap_free_bytes(&dma_heap);
+}
+
 // Debug Atualizado com Canary Check
 void kheap_dump(void) {
     hal_uart_puts("\n  HEAP MAP (Start: ");
-    debug_hex((uint32_t)heap_start); 
+    debug_hex((uint32_t)kheap.start); 
     hal_uart_puts(")\n");
     
-    hal_uart_puts("  ------------------------------------------------------------------\n");
-    hal_uart_puts("  HEAD ADDR   DATA ADDR   CANARY ADDR   SIZE          STATUS   CHK\n");
-    hal_uart_puts("  ------------------------------------------------------------------\n");
+    hal_uart_puts("  ------------------------------------------------------------------------\n");
+    hal_uart_puts("  HEAD ADDR   DATA ADDR   CANARY ADDR   SIZE          STATUS   OWNER CHK\n");
+    hal_uart_puts("  ------------------------------------------------------------------------\n");
 
-    block_t *curr = heap_head;
+    block_t *curr = kheap.head;
 
     while (curr) {
         hal_uart_puts("  "); debug_hex((uint32_t)curr);            
@@ -189,6 +480,11 @@ void kheap_dump(void) {
         
         hal_uart_puts("    "); debug_hex(curr->size);                
         hal_uart_puts(curr->free ? "    FREE     " : "    USED     "); 
+
+        // Dono: "K" para o Kernel, TID para as tarefas
+        if (curr->free) hal_uart_puts("-     ");
+        else if (curr->owner == MM_OWNER_KERNEL) hal_uart_puts("K     ");
+        else { hal_uart_putc('0' + (curr->owner % 10)); hal_uart_puts("     "); }
         
         if (curr->canary == CANRY_VALUE) hal_uart_puts("OK\n");
         else hal_uart_puts("ERR\n");
@@ -196,8 +492,12 @@ void kheap_dump(void) {
         curr = curr->next;
     }
 
-    hal_uart_puts("  ------------------------------------------------------------------\n");
+    hal_uart_puts("  ------------------------------------------------------------------------\n");
     hal_uart_puts("  Total Free: ");
     debug_hex(kget_free_memory()); 
-    hal_uart_puts("\n\n");
+    hal_uart_puts("\n  DMA Pool:   ");
+    debug_hex((uint32_t)dma_heap.start);
+    hal_uart_puts(" (Free: ");
+    debug_hex(kget_free_dma_memory());
+    hal_uart_puts(")\n\n");
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "../../include/kernel/prof.h"
+#include "../../include/hal/hal_timer.h"
+
+// ============================================================================
+// HISTOGRAMA (pc, tid) -> amostras
+// ============================================================================
+// Tabela hash com endereçamento aberto: um laço quente gera poucos PCs
+// distintos, então 512 entradas cobrem segundos de amostragem em ~6KB.
+// Quando a tabela enche, as amostras de PCs novos são só contadas ('lost').
+// Roda dentro do trap_handler (MIE desligado): sem trava.
+
+#define PROF_MASK  (PROF_SLOTS - 1)
+#define PROF_PROBE 8   // Sondagens antes de desistir
+
+static prof_entry_t prof_table[PROF_SLOTS];
+static uint32_t prof_used    = 0;
+static uint32_t prof_total   = 0;
+static uint32_t prof_lost    = 0;
+static uint32_t prof_period  = 0;   // 0 = parado
+
+static inline uint32_t prof_hash(uint32_t pc, uint32_t tid) {
+    // PCs são alinhados em 4 bytes (sem extensão C)
+    return ((pc >> 2) ^ (pc >> 11) ^ (tid << 5)) & PROF_MASK;
+}
+
+uint32_t prof_sample(uint32_t pc, uint32_t tid) {
+    if (prof_period == 0) return 0;
+
+    prof_total++;
+
+    uint32_t h = prof_hash(pc, tid);
+    for (int i = 0; i < PROF_PROBE; i++) {
+        prof_entry_t *e = &prof_table[(h + i) & PROF_MASK];
+        if (e->count == 0) {
+            e->pc    = pc;
+            e->tid   = tid;
+            e->count = 1;
+            prof_used++;
+            return prof_period;
+        }
+        if (e->pc == pc && e->tid == tid) {
+            e->count++;
+            return prof_period;
+        }
+    }
+
+    prof_lost++;
+    return prof_period;
+}
+
+// ============================================================================
+// CONTROLE (SYS_PROF)
+// ============================================================================
+
+int prof_ctl(uint32_t op, uint32_t arg, prof_entry_t *buf, uint32_t max) {
+    switch (op) {
+        case PROF_OP_START:
+            // Recomeça do zero a cada 'prof start'
+            for (int i = 0; i < PROF_SLOTS; i++) prof_table[i].count = 0;
+            prof_used = prof_total = prof_lost = 0;
+            prof_period = hal_timer_get_freq() / PROF_HZ;
+            return 0;
+
+        case PROF_OP_STOP:
+            prof_period = 0;
+            return 0;
+
+        case PROF_OP_TOTAL:   return (int)prof_total;
+        case PROF_OP_LOST:    return (int)prof_lost;
+        case PROF_OP_RUNNING: return prof_period != 0;
+
+        case PROF_OP_READ: {
+            // Copia as entradas usadas a partir da a1-ésima
+            uint32_t seen = 0, n = 0;
+            for (int i = 0; i < PROF_SLOTS && n < max; i++) {
+                if (prof_table[i].count == 0) continue;
+                if (seen++ < arg) continue;
+                buf[n++] = prof_table[i];
+            }
+            return (int)n;
+        }
+    }
+    return -1;
+}
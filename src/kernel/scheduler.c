@@ -15,7 +15,11 @@
 #include "../../include/hal/hal_uart.h"
 #include "../../include/hal/hal_timer.h"
 #include "../../include/kernel/logger.h"
+#include "../../include/kernel/klog.h"
+#include "../../include/kernel/trace.h"
+#include "../../include/kernel/mm.h"
 #include "../../include/sys/syscall.h"
+#include "../../include/util/string.h"
 #include <stddef.h>
 
 // ======================================================================================
@@ -39,6 +43,12 @@ task_t *next_task = NULL;
 
 // Se next_task != current_task, o trap.s realiza a Troca de Contexto.
 
+// Mutexes trancados agora (pelo SYS_LOCK). Poucos existem (uart_mutex e
+// afins), então uma tabela pequena basta; cheia, o lock falha como se o
+// mutex estivesse ocupado e a tarefa tenta de novo.
+#define MAX_HELD_MUTEXES 8
+static mutex_t *held_mutexes[MAX_HELD_MUTEXES];
+
 // ======================================================================================
 //  INICIALIZAÇÃO
 // ======================================================================================
@@ -46,7 +56,8 @@ task_t *next_task = NULL;
 void scheduler_init(void) {
     task_count = 0;
     current_task = NULL;
-    log_sched("Secheduler Initialized!\n\r");
+    for (int i = 0; i < MAX_HELD_MUTEXES; i++) held_mutexes[i] = NULL;
+    KLOG_INFO(SCHED_INIT);
 }
 
 // ======================================================================================
@@ -98,7 +109,7 @@ int task_create(void (*function)(void), const char* name, uint32_t priority) {
 
     // 0. Verifica a quantidade de TASKS já existentes
     if (task_count >= MAX_TASKS) {
-        log_sched("Error: Max tasks reached.\n\r");
+        KLOG_ERROR(SCHED_MAX_TASKS);
         return -1;
     }
 
@@ -123,7 +134,7 @@ int task_create(void (*function)(void), const char* name, uint32_t priority) {
     context_t *ctx = (context_t *)sp;
     
     // D. Limpa os registradores (Zera tudo para evitar lixo)
-    for (int i=0; i<32; i++) ((uint32_t*)ctx)[i] = 0;
+    memset(ctx, 0, sizeof(context_t));
     
     // E. Configura os Registradores Críticos:
     
@@ -140,17 +151,17 @@ int task_create(void (*function)(void), const char* name, uint32_t priority) {
     // para acessar variáveis globais (como 'tasks', 'current_task', etc.) de forma eficiente.
     // Se não copiarmos o 'gp' atual do Kernel para a nova tarefa, ela vai crashar
     // ao tentar ler qualquer variável global.
+#ifdef __riscv
     uint32_t global_pointer;
     asm volatile("mv %0, gp" : "=r"(global_pointer));
     ctx->gp = global_pointer;
+#endif
     
     // F. Salva o ponteiro da nova pilha no TCB
     // O trap.s vai carregar este valor no registrador SP da CPU.
     t->sp = sp;
     
-    log_sched("Created task: ");
-    hal_uart_puts(name);
-    hal_uart_puts("\n\r");
+    KLOG_INFO(SCHED_TASK_CREATED, t->tid, priority);
 
     task_count++;
     return t->tid;
@@ -172,11 +183,11 @@ int scheduler_get_tasks_info(task_info_t *user_buffer, int max_count) {
         user_buffer[i].priority  = tasks[i].priority;
         user_buffer[i].sp        = tasks[i].sp;
         user_buffer[i].wake_time = tasks[i].wake_time;
+        user_buffer[i].heap_used  = kheap_task_usage(tasks[i].tid);
+        user_buffer[i].heap_quota = kheap_get_quota(tasks[i].tid);
         
-        // Copia o nome (strcpy manual seguro)
-        for (int j = 0; j < 16; j++) {
-            user_buffer[i].name[j] = tasks[i].name[j];
-        }
+        // Copia o nome (tamanho fixo, sempre terminado em 0)
+        memcpy(user_buffer[i].name, tasks[i].name, 16);
         
         count++;
     }
@@ -268,6 +279,10 @@ void schedule(void) {
     
     if (best_task != NULL) {
         next_task = best_task;
+
+        if (next_task != current_task) {
+            TRACE_SWITCH(next_task->tid);
+        }
         
         // Se a próxima task estava apenas PRONTA, agora vira RUNNING
         if (next_task->state == TASK_READY) {
@@ -289,17 +304,72 @@ void schedule(void) {
 
 // Pausa a tarefa com o PID especificado (SUSPENDED)
 int scheduler_suspend(uint32_t pid) {
+    if (pid >= task_count || tasks[pid].state == TASK_DEAD) return -1; // Morta não volta
     if (tasks[pid].priority == 0) return -1; // Não pode pausar a Idle
     tasks[pid].state = TASK_SUSPENDED;
     if (current_task->tid == pid) schedule(); // Se pausou a si mesmo, cede a vez
     return 0;
 }
 
-// Continua a tarefa com o PID especificado (SUSPENDED -> READY)
-int scheduler_resume(uint32_t pid) {
+// Encerra a tarefa com o PID especificado (-> DEAD)
+// Todos os blocos de heap que ela alocou são devolvidos automaticamente.
+int scheduler_kill(uint32_t pid) {
     if (pid >= task_count) return -1;
-    if (tasks[pid].state == TASK_SUSPENDED) {
-        tasks[pid].state = TASK_READY;
+    if (tasks[pid].priority == 0) return -1; // Não pode matar a Idle
+    if (tasks[pid].state == TASK_DEAD) return -1;
+
+    tasks[pid].state = TASK_DEAD;
+
+    // Mutexes que ela segurava: destranca (senão quem espera gira para sempre)
+    for (int i = 0; i < MAX_HELD_MUTEXES; i++) {
+        mutex_t *m = held_mutexes[i];
+        if (m && m->owner_tid == pid) {
+            m->locked = 0;
+            m->owner_tid = 0;
+            held_mutexes[i] = NULL;
+        }
     }
+
+    uint32_t reclaimed = kheap_reclaim(pid);
+    (void)reclaimed; // Some junto com o log se KLOG_LEVEL > INFO
+    KLOG_INFO(SCHED_TASK_KILLED, pid, reclaimed);
+
+    if (current_task->tid == pid) schedule(); // Se matou a si mesmo, cede a vez
+    return 0;
+}
+
+// Continua a tarefa com o PID especificado (SUSPENDED -> READY). Só uma
+// tarefa pausada: a morta já teve o heap devolvido (kheap_reclaim)
+int scheduler_resume(uint32_t pid) {
+    if (pid >= task_count || tasks[pid].state != TASK_SUSPENDED) return -1;
+    tasks[pid].state = TASK_READY;
     return 0;
 }
+
+// ======================================================================================
+// MUTEX (SYS_LOCK / SYS_UNLOCK)
+// ======================================================================================
+
+// Roda no trap (kernel mode), então o teste-e-marca já é atômico
+int scheduler_mutex_lock(mutex_t *m) {
+    if (m->locked) return 0; // Alguém já trancou
+
+    int slot = 0;
+    while (slot < MAX_HELD_MUTEXES && held_mutexes[slot]) slot++;
+    if (slot == MAX_HELD_MUTEXES) return 0; // Tabela cheia: tenta de novo depois
+
+    m->locked = 1;
+    m->owner_tid = current_task->tid;
+    held_mutexes[slot] = m;
+    return 1;
+}
+
+void scheduler_mutex_unlock(mutex_t *m) {
+    // Segurança: Só o dono pode destrancar!
+    if (!m->locked || m->owner_tid != current_task->tid) return;
+    m->locked = 0;
+    m->owner_tid = 0;
+    for (int i = 0; i < MAX_HELD_MUTEXES; i++) {
+        if (held_mutexes[i] == m) held_mutexes[i] = NULL;
+    }
+}
@@ -0,0 +1,173 @@
+#include "../../include/util/string.h"
+
+/* ============================================================================
+ * BIBLIOTECA DE MEMÓRIA (Freestanding, RV32I)
+ * ============================================================================
+ *
+ * Estratégia comum às rotinas:
+ * 1. Cabeça: bytes até o destino ficar alinhado em 4.
+ * 2. Corpo:  palavras de 32 bits, 8 por iteração (32 bytes), depois 1 a 1.
+ * 3. Cauda:  bytes restantes.
+ *
+ * O RV32I não tem load/store desalinhado garantido, então quando origem e
+ * destino têm alinhamentos diferentes o memcpy lê palavras ALINHADAS da
+ * origem e as recombina com shifts (little-endian).
+ */
+
+// Impede o GCC de reconhecer os laços abaixo e trocá-los por uma chamada
+// a memcpy/memset (o que viraria recursão infinita).
+#define NO_LOOP_IDIOM __attribute__((optimize("no-tree-loop-distribute-patterns")))
+
+// Abaixo disso o custo de alinhar não compensa: cópia byte a byte
+#define SMALL_COPY 8
+
+// ============================================================================
+// MEMCPY
+// ============================================================================
+
+NO_LOOP_IDIOM
+void *memcpy(void *dst, const void *src, size_t n) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    if (n < SMALL_COPY) {
+        while (n--) *d++ = *s++;
+        return dst;
+    }
+
+    // 1. Cabeça: alinha o destino
+    while ((uintptr_t)d & 3) { *d++ = *s++; n--; }
+
+    uint32_t *dw = (uint32_t *)d;
+    uint32_t shift = ((uintptr_t)s & 3) * 8;
+
+    if (shift == 0) {
+        // 2a. Origem e destino alinhados: palavras, desenrolado em 8
+        const uint32_t *sw = (const uint32_t *)s;
+        while (n >= 32) {
+            uint32_t w0 = sw[0], w1 = sw[1], w2 = sw[2], w3 = sw[3];
+            uint32_t w4 = sw[4], w5 = sw[5], w6 = sw[6], w7 = sw[7];
+            dw[0] = w0; dw[1] = w1; dw[2] = w2; dw[3] = w3;
+            dw[4] = w4; dw[5] = w5; dw[6] = w6; dw[7] = w7;
+            dw += 8; sw += 8; n -= 32;
+        }
+        while (n >= 4) { *dw++ = *sw++; n -= 4; }
+        s = (const uint8_t *)sw;
+    } else {
+        // 2b. Origem desalinhada: lê palavras alinhadas e junta duas a duas.
+        // A leitura alinhada nunca passa da palavra que contém o último byte.
+        const uint32_t *sw = (const uint32_t *)((uintptr_t)s & ~(uintptr_t)3);
+        uint32_t rshift = 32 - shift;
+        uint32_t prev = *sw++;
+        while (n >= 16) {
+            uint32_t w0 = sw[0], w1 = sw[1], w2 = sw[2], w3 = sw[3];
+            dw[0] = (prev >> shift) | (w0 << rshift);
+            dw[1] = (w0   >> shift) | (w1 << rshift);
+            dw[2] = (w1   >> shift) | (w2 << rshift);
+            dw[3] = (w2   >> shift) | (w3 << rshift);
+            prev = w3;
+            dw += 4; sw += 4; n -= 16;
+        }
+        while (n >= 4) {
+            uint32_t w = *sw++;
+            *dw++ = (prev >> shift) | (w << rshift);
+            prev = w;
+            n -= 4;
+        }
+        s = (const uint8_t *)sw - 4 + (shift >> 3);
+    }
+
+    // 3. Cauda
+    d = (uint8_t *)dw;
+    while (n--) *d++ = *s++;
+    return dst;
+}
+
+// ============================================================================
+// MEMMOVE (Suporta sobreposição)
+// ============================================================================
+
+NO_LOOP_IDIOM
+void *memmove(void *dst, const void *src, size_t n) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    // Sem sobreposição perigosa: a cópia para frente serve
+    if (d <= s || d >= s + n) return memcpy(dst, src, n);
+
+    // Sobreposição com destino à frente: copia de trás para frente
+    d += n; s += n;
+    if ((((uintptr_t)d ^ (uintptr_t)s) & 3) == 0) {
+        while (n && ((uintptr_t)d & 3)) { *--d = *--s; n--; }
+        while (n >= 4) {
+            d -= 4; s -= 4; n -= 4;
+            *(uint32_t *)d = *(const uint32_t *)s;
+        }
+    }
+    while (n--) *--d = *--s;
+    return dst;
+}
+
+// ============================================================================
+// MEMSET
+// ============================================================================
+
+NO_LOOP_IDIOM
+void *memset(void *dst, int c, size_t n) {
+    uint8_t *d = (uint8_t *)dst;
+    uint8_t b = (uint8_t)c;
+
+    if (n < SMALL_COPY) {
+        while (n--) *d++ = b;
+        return dst;
+    }
+
+    // 1. Cabeça
+    while ((uintptr_t)d & 3) { *d++ = b; n--; }
+
+    // 2. Corpo: replica o byte na palavra com shifts (sem multiplicação)
+    uint32_t w = b;
+    w |= w << 8;
+    w |= w << 16;
+
+    uint32_t *dw = (uint32_t *)d;
+    while (n >= 32) {
+        dw[0] = w; dw[1] = w; dw[2] = w; dw[3] = w;
+        dw[4] = w; dw[5] = w; dw[6] = w; dw[7] = w;
+        dw += 8; n -= 32;
+    }
+    while (n >= 4) { *dw++ = w; n -= 4; }
+
+    // 3. Cauda
+    d = (uint8_t *)dw;
+    while (n--) *d++ = b;
+    return dst;
+}
+
+// ============================================================================
+// MEMCMP
+// ============================================================================
+
+NO_LOOP_IDIOM
+int memcmp(const void *a, const void *b, size_t n) {
+    const uint8_t *pa = (const uint8_t *)a;
+    const uint8_t *pb = (const uint8_t *)b;
+
+    // Mesmo alinhamento: compara palavra a palavra até achar diferença
+    if (n >= SMALL_COPY && (((uintptr_t)pa ^ (uintptr_t)pb) & 3) == 0) {
+        while ((uintptr_t)pa & 3) {
+            if (*pa != *pb) return *pa - *pb;
+            pa++; pb++; n--;
+        }
+        while (n >= 4 && *(const uint32_t *)pa == *(const uint32_t *)pb) {
+            pa += 4; pb += 4; n -= 4;
+        }
+    }
+
+    // Cauda (ou a palavra que diferiu): byte a byte para achar o sinal
+    while (n--) {
+        if (*pa != *pb) return *pa - *pb;
+        pa++; pb++;
+    }
+    return 0;
+}
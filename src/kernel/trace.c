@@ -0,0 +1,99 @@
+#include "../../include/kernel/trace.h"
+#include "../../include/kernel/task.h"
+#include "../../include/hal/hal_timer.h"
+
+#ifdef CONFIG_TRACE
+
+// ============================================================================
+// BUFFER CIRCULAR (GRAVADOR DE VOO)
+// ============================================================================
+// 'head' só cresce; o índice real é head & (TRACE_BUF_SIZE - 1). Quando o
+// buffer enche, o evento novo sobrescreve o mais antigo. Só é chamado de
+// dentro do trap_handler (MIE desligado), então não há corrida.
+
+#define TRACE_MASK    (TRACE_BUF_SIZE - 1)
+#define TRACE_NO_TID  0xFF   // Antes da primeira tarefa (boot)
+
+static trace_record_t trace_buf[TRACE_BUF_SIZE];
+static uint32_t trace_head    = 0;
+static uint8_t  trace_enabled = 1;   // Grava desde o boot
+
+// Tarefas esperando por um mutex (bit = tid). Um SYS_LOCK que falha vira
+// MUTEX_BLOCK só na primeira vez; o sucesso seguinte vira MUTEX_UNBLOCK.
+static uint32_t trace_mutex_waiting = 0;
+
+static inline uint8_t trace_cur_tid(void) {
+    return current_task ? (uint8_t)current_task->tid : TRACE_NO_TID;
+}
+
+static void trace_put(uint8_t type, uint8_t tid, uint16_t arg) {
+    if (!trace_enabled) return;
+
+    trace_record_t *r = &trace_buf[trace_head & TRACE_MASK];
+    r->time = (uint32_t)hal_timer_get_cycles();
+    r->type = type;
+    r->tid  = tid;
+    r->arg  = arg;
+    trace_head++;
+}
+
+void trace_event(uint8_t type, uint16_t arg) {
+    trace_put(type, trace_cur_tid(), arg);
+}
+
+void trace_switch(uint32_t to_tid) {
+    trace_put(TRACE_EV_SWITCH, trace_cur_tid(), (uint16_t)to_tid);
+}
+
+void trace_mutex(const void *m, int acquired) {
+    uint8_t  tid = trace_cur_tid();
+    uint32_t bit = (tid < 32) ? (1u << tid) : 0;
+    uint16_t id  = (uint16_t)(uint32_t)m;
+
+    if (!acquired && !(trace_mutex_waiting & bit)) {
+        trace_mutex_waiting |= bit;
+        trace_put(TRACE_EV_MUTEX_BLOCK, tid, id);
+    } else if (acquired && (trace_mutex_waiting & bit)) {
+        trace_mutex_waiting &= ~bit;
+        trace_put(TRACE_EV_MUTEX_UNBLOCK, tid, id);
+    }
+}
+
+// ============================================================================
+// CONTROLE (SYS_TRACE)
+// ============================================================================
+
+static uint32_t trace_count(void) {
+    return (trace_head < TRACE_BUF_SIZE) ? trace_head : TRACE_BUF_SIZE;
+}
+
+int trace_ctl(uint32_t op, uint32_t arg, trace_record_t *buf, uint32_t max) {
+    switch (op) {
+        case TRACE_OP_START: trace_enabled = 1; return 0;
+        case TRACE_OP_STOP:  trace_enabled = 0; return 0;
+
+        case TRACE_OP_CLEAR:
+            trace_head = 0;
+            trace_mutex_waiting = 0;
+            return 0;
+
+        case TRACE_OP_COUNT: return (int)trace_count();
+        case TRACE_OP_LOST:  return (int)(trace_head - trace_count());
+        case TRACE_OP_RUNNING: return trace_enabled;
+
+        case TRACE_OP_READ: {
+            // Índice 0 = evento mais antigo ainda no buffer
+            uint32_t count = trace_count();
+            uint32_t first = trace_head - count;
+            uint32_t n = 0;
+            while (n < max && arg + n < count) {
+                buf[n] = trace_buf[(first + arg + n) & TRACE_MASK];
+                n++;
+            }
+            return (int)n;
+        }
+    }
+    return -1;
+}
+
+#endif /* CONFIG_TRACE */
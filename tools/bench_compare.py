@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""
+Compara a saída do 'bench all' (make bench) com um baseline.
+
+    python3 tools/bench_compare.py build/bench.log tools/bench_baseline.txt
+    python3 tools/bench_compare.py build/bench.log tools/bench_baseline.txt --save
+
+Lê as linhas "BENCH <suite>.<caso> <tamanho> <valor> <unidade>". A direção
+de "melhor" vem da unidade: B/cycle quanto maior melhor; cycles/op e
+cycles/B quanto menor melhor. Sai com 1 se algum caso piorou mais que a
+tolerância, se faltou algum caso do baseline ou se o alvo reportou falhas
+nas autoverificações (BENCH_DONE failures=N).
+"""
+
+import argparse
+import re
+import sys
+
+LINE_RE = re.compile(r"^BENCH (\S+) (\d+) (\d+\.\d+) (\S+)")
+DONE_RE = re.compile(r"^BENCH_DONE failures=(\d+)")
+
+HIGHER_IS_BETTER = {"B/cycle"}
+
+
+def parse(path):
+    results, failures = {}, None
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for raw in f:
+            line = raw.strip()
+            m = LINE_RE.match(line)
+            if m:
+                name, size, value, unit = m.groups()
+                results[(name, int(size))] = (float(value), unit)
+                continue
+            m = DONE_RE.match(line)
+            if m:
+                failures = int(m.group(1))
+    return results, failures
+
+
+def save(path, results):
+    with open(path, "w", encoding="utf-8") as f:
+        for (name, size), (value, unit) in sorted(results.items()):
+            f.write("BENCH %s %d %.2f %s\n" % (name, size, value, unit))
+    print("baseline salvo: %s (%d casos)" % (path, len(results)))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Compara 'bench all' com um baseline")
+    ap.add_argument("log", help="Saída do QEMU (make bench-run)")
+    ap.add_argument("baseline", help="Arquivo de baseline")
+    ap.add_argument("--tolerance", type=float, default=10.0,
+                    help="Piora aceita em %% (padrão 10)")
+    ap.add_argument("--save", action="store_true", help="Grava o log como novo baseline")
+    args = ap.parse_args()
+
+    current, failures = parse(args.log)
+    if failures is None:
+        sys.exit("bench_compare: BENCH_DONE não encontrado (a imagem travou ou saiu antes)")
+    if failures:
+        sys.exit("bench_compare: %d autoverificações falharam no alvo" % failures)
+    if not current:
+        sys.exit("bench_compare: nenhuma linha BENCH no log")
+
+    if args.save:
+        save(args.baseline, current)
+        return
+
+    try:
+        baseline, _ = parse(args.baseline)
+    except OSError:
+        print("bench_compare: sem baseline em %s (rode 'make bench-baseline')"
+              % args.baseline)
+        return
+
+    regressions = 0
+    print("%-28s %7s %12s %12s %8s" % ("case", "size", "baseline", "current", "delta"))
+    for key in sorted(set(baseline) | set(current)):
+        name, size = key
+        if key not in current:
+            print("%-28s %7d %12.2f %12s %8s  MISSING" % (name, size, baseline[key][0], "-", "-"))
+            regressions += 1
+            continue
+        value, unit = current[key]
+        if key not in baseline:
+            print("%-28s %7d %12s %12.2f %8s  NEW" % (name, size, "-", value, "-"))
+            continue
+
+        base = baseline[key][0]
+        if base == 0:
+            delta = 0.0 if value == 0 else 100.0
+        else:
+            delta = (value - base) * 100.0 / base
+        worse = -delta if unit in HIGHER_IS_BETTER else delta
+
+        flag = ""
+        if worse > args.tolerance:
+            flag = "  REGRESSION"
+            regressions += 1
+        elif worse < -args.tolerance:
+            flag = "  improved"
+        print("%-28s %7d %12.2f %12.2f %+7.1f%%%s" % (name, size, base, value, delta, flag))
+
+    if regressions:
+        sys.exit("bench_compare: %d regressões (tolerância %.0f%%)" % (regressions, args.tolerance))
+    print("bench_compare: OK (%d casos)" % len(current))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""
+Decodificador do KLOG (log binário do kernel).
+
+Imagens compiladas com -DKLOG_RAW não carregam as strings de formato: a
+tarefa Logger imprime cada registro como uma linha
+
+    #K <hdr> <time> <arg0> <arg1> <arg2>        (hexa, 32 bits cada)
+
+Este script lê a saída serial (arquivo ou stdin), traduz as linhas "#K"
+usando a tabela include/kernel/klog_ids.h e repassa as demais sem mudança.
+
+Uso:
+    python3 tools/klog_decode.py serial.log
+    python3 upload.py ... | python3 tools/klog_decode.py --freq 100000000
+"""
+
+import argparse
+import os
+import re
+import sys
+
+DEFAULT_IDS = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           "..", "include", "kernel", "klog_ids.h")
+
+LEVELS = {0: "DEBUG", 1: "INFO", 2: "WARN", 3: "ERROR"}
+
+FMT_RE = re.compile(r'^\s*KLOG_FMT\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+
+
+def load_formats(path):
+    """Lê a X-macro na ordem: a posição é o ID."""
+    formats = []
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            m = FMT_RE.match(line)
+            if m:
+                formats.append((m.group(1), m.group(2)))
+    return formats
+
+
+def render(fmt, args):
+    out, argi, i = [], 0, 0
+    while i < len(fmt):
+        c = fmt[i]
+        if c != "%" or i + 1 >= len(fmt):
+            out.append(c)
+            i += 1
+            continue
+        spec = fmt[i + 1]
+        i += 2
+        v = args[argi] if argi < len(args) else 0
+        if spec == "u":
+            out.append(str(v)); argi += 1
+        elif spec == "d":
+            out.append(str(v - (1 << 32) if v & 0x80000000 else v)); argi += 1
+        elif spec == "x":
+            out.append("0x%08x" % v); argi += 1
+        elif spec == "%":
+            out.append("%")
+    return "".join(out)
+
+
+def decode(line, formats, freq):
+    words = [int(w, 16) for w in line.split()[1:]]
+    if len(words) != 5:
+        return line.rstrip("\n") + "   <klog: malformed record>"
+    hdr, time, args = words[0], words[1], words[2:]
+    rid, level, tid = hdr >> 16, (hdr >> 8) & 0xFF, hdr & 0xFF
+
+    ms = time * 1000 // freq
+    who = "K" if tid == 0xFF else str(tid)
+    prefix = "[%d] (%s/%s) " % (ms, LEVELS.get(level, "?"), who)
+    if rid >= len(formats):
+        return prefix + "klog: unknown id %d %s" % (rid, args)
+    return prefix + render(formats[rid][1], args)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Decodifica linhas #K do KLOG")
+    ap.add_argument("input", nargs="?", help="Log serial (padrão: stdin)")
+    ap.add_argument("--ids", default=DEFAULT_IDS, help="Caminho do klog_ids.h")
+    ap.add_argument("--freq", type=int, default=10000000,
+                    help="Frequência do mtime em Hz (QEMU=10MHz, FPGA=100MHz)")
+    args = ap.parse_args()
+
+    formats = load_formats(args.ids)
+    src = open(args.input, encoding="utf-8", errors="replace") if args.input else sys.stdin
+    for line in src:
+        if line.startswith("#K "):
+            print(decode(line, formats, args.freq))
+        else:
+            sys.stdout.write(line)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""
+Relatório do profiler por amostragem ('prof dump').
+
+Capture a serial durante o 'prof dump' e associe as amostras às funções do
+ELF que estava rodando:
+
+    python3 tools/prof_report.py serial.log build/kernel_qemu.elf
+    python3 tools/prof_report.py serial.log build/kernel_qemu.elf --by-task
+    python3 tools/prof_report.py serial.log build/kernel_qemu.elf --lines
+
+Os símbolos vêm do 'nm -n' (funções = tipo T/t) e, com --lines, a linha de
+código vem do 'addr2line'. Nos perfis release/size use o .debug.elf (ou o ELF
+principal, que aponta para ele via .gnu_debuglink) para ter as linhas.
+"""
+
+import argparse
+import bisect
+import collections
+import re
+import subprocess
+import sys
+
+PREFIX = "riscv32-unknown-elf-"
+
+HEADER_RE = re.compile(r"#PROF v1 samples=(\d+) lost=(\d+) hz=(\d+)")
+TASK_RE = re.compile(r"#TASK (\d+) (.*)")
+SAMPLE_RE = re.compile(r"#S (0x[0-9A-Fa-f]+) (\d+) (\d+)")
+
+
+def parse_dump(path):
+    """Lê o ÚLTIMO dump da captura."""
+    dump = None
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for raw in f:
+            line = raw.strip()
+            m = HEADER_RE.search(line)
+            if m:
+                dump = {"samples": int(m.group(1)), "lost": int(m.group(2)),
+                        "hz": int(m.group(3)), "tasks": {}, "hist": []}
+                continue
+            if dump is None:
+                continue
+            m = TASK_RE.match(line)
+            if m:
+                dump["tasks"][int(m.group(1))] = m.group(2).strip()
+                continue
+            m = SAMPLE_RE.match(line)
+            if m:
+                dump["hist"].append((int(m.group(1), 16), int(m.group(2)),
+                                     int(m.group(3))))
+    if dump is None:
+        sys.exit("prof_report: nenhum '#PROF' encontrado na captura")
+    return dump
+
+
+def load_symbols(elf, nm):
+    out = subprocess.run([nm, "-n", "--defined-only", elf], check=True,
+                         capture_output=True, text=True).stdout
+    addrs, names = [], []
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 3 and parts[1] in "Tt":
+            addrs.append(int(parts[0], 16))
+            names.append(parts[2])
+    return addrs, names
+
+
+def symbolize(pc, addrs, names):
+    i = bisect.bisect_right(addrs, pc) - 1
+    return names[i] if i >= 0 else "0x%08x" % pc
+
+
+def addr2line(elf, tool, pcs):
+    if not pcs:
+        return {}
+    out = subprocess.run([tool, "-e", elf] + ["0x%x" % pc for pc in pcs],
+                         check=True, capture_output=True, text=True).stdout
+    return dict(zip(pcs, out.splitlines()))
+
+
+def print_table(title, counter, total, limit):
+    print(title)
+    print("  %7s %8s  %s" % ("%", "samples", "location"))
+    for key, n in counter.most_common(limit):
+        print("  %6.2f%% %8d  %s" % (100.0 * n / total, n, key))
+    print()
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Perfil plano a partir do 'prof dump'")
+    ap.add_argument("capture", help="Log da serial com o dump")
+    ap.add_argument("elf", help="ELF do kernel que gerou as amostras")
+    ap.add_argument("--by-task", action="store_true", help="Separa o perfil por tarefa")
+    ap.add_argument("--lines", action="store_true", help="Perfil por linha (addr2line)")
+    ap.add_argument("--top", type=int, default=25, help="Linhas por tabela")
+    ap.add_argument("--prefix", default=PREFIX, help="Prefixo da toolchain")
+    args = ap.parse_args()
+
+    dump = parse_dump(args.capture)
+    total = sum(n for _, _, n in dump["hist"])
+    if total == 0:
+        sys.exit("prof_report: dump sem amostras")
+
+    addrs, names = load_symbols(args.elf, args.prefix + "nm")
+
+    print("%d samples @ %d Hz (~%.2f s), %d lost\n"
+          % (total, dump["hz"], total / dump["hz"], dump["lost"]))
+
+    per_func = collections.Counter()
+    per_task = collections.defaultdict(collections.Counter)
+    for pc, tid, n in dump["hist"]:
+        func = symbolize(pc, addrs, names)
+        per_func[func] += n
+        per_task[tid][func] += n
+
+    print_table("FLAT PROFILE (functions)", per_func, total, args.top)
+
+    if args.by_task:
+        for tid in sorted(per_task, key=lambda t: -sum(per_task[t].values())):
+            name = dump["tasks"].get(tid, "kernel" if tid == 0xFF else "tid %d" % tid)
+            n = sum(per_task[tid].values())
+            print_table("TASK %d: %s (%.2f%%)" % (tid, name, 100.0 * n / total),
+                        per_task[tid], n, args.top)
+
+    if args.lines:
+        pcs = sorted({pc for pc, _, _ in dump["hist"]})
+        where = addr2line(args.elf, args.prefix + "addr2line", pcs)
+        per_line = collections.Counter()
+        for pc, _, n in dump["hist"]:
+            per_line["%s (%s)" % (where.get(pc, "??"), symbolize(pc, addrs, names))] += n
+        print_table("FLAT PROFILE (lines)", per_line, total, args.top)
+
+
+if __name__ == "__main__":
+    main()
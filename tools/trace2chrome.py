@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""
+Conversor do trace do kernel para o formato JSON do Chrome.
+
+Capture a serial enquanto roda 'trace dump' no shell (ex: com
+'-serial file:serial.bin' no QEMU ou um terminal que grave em binário) e:
+
+    python3 tools/trace2chrome.py serial.bin -o trace.json
+
+Abra trace.json em chrome://tracing ou https://ui.perfetto.dev.
+
+Cada tarefa vira um processo com três trilhas:
+    cpu      - quando a tarefa estava na CPU
+    syscall  - syscalls (nome e número)
+    mutex    - espera por mutex
+As interrupções ficam no processo "IRQ", uma trilha por fonte do PLIC
+(fonte 0 = timer da CPU).
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+# Mantenha em sincronia com include/kernel/trace.h
+EV_SWITCH, EV_IRQ_ENTER, EV_IRQ_EXIT = 1, 2, 3
+EV_SYSCALL_ENTER, EV_SYSCALL_EXIT = 4, 5
+EV_MUTEX_BLOCK, EV_MUTEX_UNBLOCK = 6, 7
+
+NO_TID = 0xFF
+IRQ_PID = 1000
+TRACK_CPU, TRACK_SYSCALL, TRACK_MUTEX = 0, 1, 2
+
+RECORD = struct.Struct("<IBBH")
+
+HEADER_RE = re.compile(rb"#TRACE v1 count=(\d+) lost=(\d+) freq=(\d+)\n")
+TASK_RE = re.compile(rb"#TASK (\d+) ([^\n]*)\n")
+
+
+def load_syscall_names(path):
+    """Nomes das syscalls a partir dos #define SYS_* de syscall.h."""
+    names = {}
+    try:
+        with open(path, encoding="utf-8") as f:
+            for line in f:
+                m = re.match(r"#define\s+SYS_(\w+)\s+(\d+)", line)
+                if m:
+                    names[int(m.group(2))] = m.group(1).lower()
+    except OSError:
+        pass
+    return names
+
+
+def parse_dump(blob):
+    """Extrai o ÚLTIMO dump do arquivo (a captura pode conter vários)."""
+    matches = list(HEADER_RE.finditer(blob))
+    if not matches:
+        sys.exit("trace2chrome: nenhum '#TRACE' encontrado na captura")
+    h = matches[-1]
+    count, lost, freq = (int(x) for x in h.groups())
+
+    pos = h.end()
+    tasks = {}
+    while True:
+        m = TASK_RE.match(blob, pos)
+        if not m:
+            break
+        tasks[int(m.group(1))] = m.group(2).decode(errors="replace").strip()
+        pos = m.end()
+
+    if not blob.startswith(b"#DATA\n", pos):
+        sys.exit("trace2chrome: dump truncado (sem #DATA)")
+    pos += len(b"#DATA\n")
+
+    size = count * RECORD.size
+    data = blob[pos:pos + size]
+    if len(data) < size:
+        print("trace2chrome: aviso: dump truncado, %d de %d eventos"
+              % (len(data) // RECORD.size, count), file=sys.stderr)
+    records = [RECORD.unpack_from(data, off)
+               for off in range(0, len(data) - RECORD.size + 1, RECORD.size)]
+    return records, tasks, lost, freq
+
+
+def unwrap(records, freq):
+    """Converte o tempo de 32 bits (que dá a volta) em microssegundos."""
+    out, base, last = [], 0, None
+    for time, ev, tid, arg in records:
+        if last is not None and time < last:
+            base += 1 << 32
+        last = time
+        out.append(((base + time) * 1e6 / freq, ev, tid, arg))
+    if out:
+        t0 = out[0][0]
+        out = [(t - t0, ev, tid, arg) for t, ev, tid, arg in out]
+    return out
+
+
+def convert(records, tasks, syscalls):
+    events = []
+    open_slices = {}  # (pid, trilha) -> (início, nome, args)
+
+    def begin(pid, track, ts, name, args=None):
+        open_slices[(pid, track)] = (ts, name, args or {})
+
+    def end(pid, track, ts):
+        s = open_slices.pop((pid, track), None)
+        if s is None:
+            return
+        start, name, args = s
+        events.append({"name": name, "ph": "X", "pid": pid, "tid": track,
+                       "ts": start, "dur": ts - start, "args": args})
+
+    for ts, ev, tid, arg in records:
+        if ev == EV_SWITCH:
+            if tid != NO_TID:
+                end(tid, TRACK_CPU, ts)
+            begin(arg, TRACK_CPU, ts, "running")
+        elif ev == EV_IRQ_ENTER:
+            name = "timer" if arg == 0 else "irq %d" % arg
+            begin(IRQ_PID, arg, ts, name, {"interrupted_tid": tid})
+        elif ev == EV_IRQ_EXIT:
+            end(IRQ_PID, arg, ts)
+        elif ev == EV_SYSCALL_ENTER:
+            begin(tid, TRACK_SYSCALL, ts, syscalls.get(arg, "sys_%d" % arg),
+                  {"nr": arg})
+        elif ev == EV_SYSCALL_EXIT:
+            end(tid, TRACK_SYSCALL, ts)
+        elif ev == EV_MUTEX_BLOCK:
+            begin(tid, TRACK_MUTEX, ts, "mutex wait",
+                  {"mutex": "0x....%04x" % arg})
+        elif ev == EV_MUTEX_UNBLOCK:
+            end(tid, TRACK_MUTEX, ts)
+
+    # Fatias ainda abertas terminam no último evento
+    last = records[-1][0] if records else 0
+    for pid, track in list(open_slices):
+        end(pid, track, last)
+
+    # Metadados: nomes de processos e trilhas
+    pids = {e["pid"] for e in events}
+    for pid in sorted(pids):
+        pname = "IRQ" if pid == IRQ_PID else tasks.get(pid, "tid %d" % pid)
+        events.append({"name": "process_name", "ph": "M", "pid": pid,
+                       "args": {"name": pname}})
+        if pid != IRQ_PID:
+            for track, tname in ((TRACK_CPU, "cpu"), (TRACK_SYSCALL, "syscall"),
+                                 (TRACK_MUTEX, "mutex")):
+                events.append({"name": "thread_name", "ph": "M", "pid": pid,
+                               "tid": track, "args": {"name": tname}})
+    return events
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Converte 'trace dump' para Chrome JSON")
+    ap.add_argument("capture", help="Captura binária da serial")
+    ap.add_argument("-o", "--output", default="trace.json")
+    ap.add_argument("--syscalls", default="include/sys/syscall.h",
+                    help="Header com os #define SYS_* (para nomear syscalls)")
+    args = ap.parse_args()
+
+    with open(args.capture, "rb") as f:
+        blob = f.read()
+
+    records, tasks, lost, freq = parse_dump(blob)
+    events = convert(unwrap(records, freq), tasks, load_syscall_names(args.syscalls))
+
+    with open(args.output, "w") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, f)
+
+    print("%d eventos (%d sobrescritos no alvo) -> %s"
+          % (len(records), lost, args.output))
+
+
+if __name__ == "__main__":
+    main()